@@ -47,7 +47,10 @@ public class BacgroundTools : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"Slate",
-				"SlateCore"
+				"SlateCore",
+				"DeveloperSettings",
+				"Json",
+				"EngineSettings"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,430 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetAction/AssetDeletionQueue.h"
+#include "AssetAction/RedirectorFixUpService.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetViewUtils.h"
+#include "ObjectTools.h"
+#include "UObject/ReferencerFinder.h"
+#include "UObject/UObjectHash.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Debug.h"
+
+namespace AssetDeletionQueue
+{
+	// blocked assets listed in the dialog, the rest is counted
+	constexpr int32 MaxListedAssets = 20;
+
+	void LogAssetsNotDeleted(const TCHAR* Reason, TArrayView<const FAssetData> Assets)
+	{
+		for (int32 i = 0; i < FMath::Min(Assets.Num(), MaxListedAssets); ++i)
+		{
+			Debug::PrintLog(FString::Printf(TEXT("%s, not deleted : %s"), Reason, *Assets[i].GetObjectPathString()));
+		}
+
+		if (Assets.Num() > MaxListedAssets)
+		{
+			Debug::PrintLog(FString::Printf(TEXT("... and %d more assets"), Assets.Num() - MaxListedAssets));
+		}
+	}
+
+	/**
+	 * Loaded objects something in memory still points at: unsaved levels, open editors, the undo buffer.
+	 * One reference walk for the whole chunk first, the engine's per object check only runs when it finds something
+	 */
+	void GatherReferencedInMemory(const TArray<UObject*>& Objects, const TSet<FName>& PackagesToDelete,
+		TArray<UObject*>& OutReferencedObjects)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(AssetDeletionQueue::GatherReferencedInMemory);
+
+		auto IsDeletedWithTheFlush = [&PackagesToDelete](const UObject* Referencer)
+		{
+			return Referencer && PackagesToDelete.Contains(Referencer->GetOutermost()->GetFName());
+		};
+
+		// objects inside the deleted packages go with them
+		TSet<UObject*> ObjectsToIgnore;
+		for (UObject* Object : Objects)
+		{
+			UPackage* Package = Object->GetOutermost();
+
+			ObjectsToIgnore.Add(Package);
+			ForEachObjectWithPackage(Package, [&ObjectsToIgnore](UObject* InnerObject)
+			{
+				ObjectsToIgnore.Add(InnerObject);
+				return true;
+			});
+		}
+
+		const TArray<UObject*> Referencers = FReferencerFinder::GetAllReferencers(Objects, &ObjectsToIgnore);
+
+		if (!Referencers.ContainsByPredicate([&IsDeletedWithTheFlush](UObject* Referencer) { return !IsDeletedWithTheFlush(Referencer); }))
+		{
+			return;
+		}
+
+		for (UObject* Object : Objects)
+		{
+			bool bIsReferenced = false;
+			bool bIsReferencedByUndo = false;
+			FReferencerInformationList MemoryReferences;
+
+			ObjectTools::GatherObjectReferencersForDeletion(Object, bIsReferenced, bIsReferencedByUndo, &MemoryReferences);
+
+			const bool bHasReferencerInfo = MemoryReferences.ExternalReferences.Num() > 0 || MemoryReferences.InternalReferences.Num() > 0;
+
+			// a reference the engine couldn't attribute to an object is kept as a reference
+			const bool bReferencedOutsideFlush = bIsReferencedByUndo || (bIsReferenced && !bHasReferencerInfo) ||
+				MemoryReferences.ExternalReferences.ContainsByPredicate([&IsDeletedWithTheFlush](const FReferencerInformation& Info)
+				{
+					return !IsDeletedWithTheFlush(Info.Referencer);
+				});
+
+			if (bReferencedOutsideFlush)
+			{
+				OutReferencedObjects.Add(Object);
+			}
+		}
+	}
+
+	/** Removes Package and everything in the flush it depends on from the deletion, a kept referencer would point at deleted assets otherwise */
+	void KeepWithDependencies(FName Package, const TMap<FName, TArray<FName>>& FlushDependencies, TSet<FName>& PackagesToDelete)
+	{
+		TArray<FName> PackagesToKeep{ Package };
+
+		while (PackagesToKeep.Num() > 0)
+		{
+			const FName KeptPackage = PackagesToKeep.Pop(false);
+
+			if (PackagesToDelete.Remove(KeptPackage) == 0) continue;
+
+			if (const TArray<FName>* Dependencies = FlushDependencies.Find(KeptPackage))
+			{
+				PackagesToKeep.Append(*Dependencies);
+			}
+		}
+	}
+
+	/** Referencers before their dependencies, so a referencer kept in a chunk still finds its dependencies undeleted */
+	void SortReferencersFirst(TArray<FAssetData>& Assets, const TMap<FName, TArray<FName>>& FlushDependencies)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(AssetDeletionQueue::SortReferencersFirst);
+
+		// depth first post order, a package finishes after everything it depends on. cycles get any order
+		TMap<FName, int32> FinishOrder;
+		FinishOrder.Reserve(Assets.Num());
+
+		TSet<FName> VisitedPackages;
+		TArray<TPair<FName, int32>> Stack;
+
+		for (const FAssetData& AssetData : Assets)
+		{
+			bool bAlreadyVisited = false;
+			VisitedPackages.Add(AssetData.PackageName, &bAlreadyVisited);
+
+			if (bAlreadyVisited) continue;
+
+			Stack.Emplace(AssetData.PackageName, 0);
+
+			while (Stack.Num() > 0)
+			{
+				const FName Package = Stack.Last().Key;
+				const int32 NextDependency = Stack.Last().Value;
+				const TArray<FName>* Dependencies = FlushDependencies.Find(Package);
+
+				if (Dependencies && NextDependency < Dependencies->Num())
+				{
+					++Stack.Last().Value;
+
+					const FName Dependency = (*Dependencies)[NextDependency];
+					VisitedPackages.Add(Dependency, &bAlreadyVisited);
+
+					if (!bAlreadyVisited)
+					{
+						Stack.Emplace(Dependency, 0);
+					}
+					continue;
+				}
+
+				FinishOrder.Add(Package, FinishOrder.Num());
+				Stack.Pop(false);
+			}
+		}
+
+		Assets.StableSort([&FinishOrder](const FAssetData& A, const FAssetData& B)
+		{
+			return FinishOrder.FindChecked(A.PackageName) > FinishOrder.FindChecked(B.PackageName);
+		});
+	}
+}
+
+void FAssetDeletionQueue::Initialize(FRedirectorFixUpService& InRedirectorFixUpService)
+{
+	RedirectorFixUpService = &InRedirectorFixUpService;
+}
+
+void FAssetDeletionQueue::Shutdown()
+{
+	if (DeferredFlushHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(DeferredFlushHandle);
+		DeferredFlushHandle.Reset();
+	}
+
+	QueuedAssets.Empty();
+	QueuedObjectPaths.Empty();
+	RedirectorFixUpService = nullptr;
+}
+
+void FAssetDeletionQueue::Enqueue(TArrayView<const FAssetData> Assets)
+{
+	for (const FAssetData& AssetData : Assets)
+	{
+		bool bAlreadyQueued = false;
+		QueuedObjectPaths.Add(AssetData.GetSoftObjectPath(), &bAlreadyQueued);
+
+		if (!bAlreadyQueued)
+		{
+			QueuedAssets.Add(AssetData);
+		}
+	}
+
+	if (QueuedAssets.Num() > 0 && !DeferredFlushHandle.IsValid())
+	{
+		DeferredFlushHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FAssetDeletionQueue::OnDeferredFlush));
+	}
+}
+
+int32 FAssetDeletionQueue::Flush(bool bShowConfirmation)
+{
+	if (DeferredFlushHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(DeferredFlushHandle);
+		DeferredFlushHandle.Reset();
+	}
+
+	if (bIsFlushing || QueuedAssets.Num() == 0) return 0;
+
+	TGuardValue<bool> FlushGuard(bIsFlushing, true);
+
+	TArray<FAssetData> AssetsToDelete = MoveTemp(QueuedAssets);
+	QueuedAssets.Reset();
+	QueuedObjectPaths.Reset();
+
+	if (bShowConfirmation)
+	{
+		// the preview lists sizes and referencers, it replaces the yes/no question
+		if (AssetsToDelete.Num() > 1 && OnPreviewRequested.IsBound() && UBacgroundToolsSettings::Get()->bPreviewDeletions)
+		{
+			OnPreviewRequested.Execute(AssetsToDelete);
+			return 0;
+		}
+
+		const EAppReturnType::Type ConfirmResult = Debug::ShowMsgDialog(EAppMsgType::YesNo,
+			FString::Printf(TEXT("Delete %d assets?"), AssetsToDelete.Num()), false);
+
+		if (ConfirmResult == EAppReturnType::No) return 0;
+	}
+
+	return DeleteAssets(MoveTemp(AssetsToDelete), bShowConfirmation);
+}
+
+int32 FAssetDeletionQueue::DeleteApprovedAssets(TArray<FAssetData>&& Assets)
+{
+	if (bIsFlushing || Assets.Num() == 0) return 0;
+
+	TGuardValue<bool> FlushGuard(bIsFlushing, true);
+
+	return DeleteAssets(MoveTemp(Assets), true);
+}
+
+int32 FAssetDeletionQueue::DeleteAssets(TArray<FAssetData>&& AssetsToDelete, bool bInteractive)
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("DeleteAssets");
+
+	if (RedirectorFixUpService)
+	{
+		RedirectorFixUpService->FixUpRedirectorsForAssets(AssetsToDelete);
+	}
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// referencers deleted in the same flush don't keep an asset alive
+	TSet<FName> PackagesToDelete;
+	PackagesToDelete.Reserve(AssetsToDelete.Num());
+	for (const FAssetData& AssetData : AssetsToDelete)
+	{
+		PackagesToDelete.Add(AssetData.PackageName);
+	}
+
+	const int32 ChunkSize = FMath::Max(1, UBacgroundToolsSettings::Get()->DeletionChunkSize);
+	const int32 NumChunks = FMath::DivideAndRoundUp(AssetsToDelete.Num(), ChunkSize);
+
+	// one frame for the reference check of the whole flush, one per chunk
+	FScopedSlowTask SlowTask(NumChunks + 1, FText::FromString(TEXT("Deleting assets")));
+	SlowTask.MakeDialogDelayed(1.f, true);
+
+	SlowTask.EnterProgressFrame(1.f, FText::FromString(TEXT("Checking references")));
+
+	// the kept set is settled before anything is deleted: a kept package keeps its dependencies in the flush,
+	// which then count as referenced from outside, and so on
+	TMap<FName, TArray<FName>> FlushDependencies;
+	FlushDependencies.Reserve(PackagesToDelete.Num());
+
+	TArray<FName> ReferencedPackages;
+
+	for (const FName Package : PackagesToDelete)
+	{
+		TArray<FName> Referencers;
+		AssetRegistry.GetReferencers(Package, Referencers, UE::AssetRegistry::EDependencyCategory::Package);
+
+		if (Referencers.ContainsByPredicate([&PackagesToDelete](FName Referencer) { return !PackagesToDelete.Contains(Referencer); }))
+		{
+			ReferencedPackages.Add(Package);
+		}
+
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(Package, Dependencies, UE::AssetRegistry::EDependencyCategory::Package);
+
+		Dependencies.RemoveAllSwap([&PackagesToDelete, Package](FName Dependency)
+		{
+			return Dependency == Package || !PackagesToDelete.Contains(Dependency);
+		}, false);
+
+		if (Dependencies.Num() > 0)
+		{
+			FlushDependencies.Add(Package, MoveTemp(Dependencies));
+		}
+	}
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries, 2 * PackagesToDelete.Num());
+
+	for (const FName Package : ReferencedPackages)
+	{
+		AssetDeletionQueue::KeepWithDependencies(Package, FlushDependencies, PackagesToDelete);
+	}
+
+	TArray<FAssetData> ReferencedAssets;
+
+	AssetsToDelete.RemoveAll([&PackagesToDelete, &ReferencedAssets](const FAssetData& AssetData)
+	{
+		if (PackagesToDelete.Contains(AssetData.PackageName)) return false;
+
+		ReferencedAssets.Add(AssetData);
+		return true;
+	});
+
+	AssetDeletionQueue::SortReferencersFirst(AssetsToDelete, FlushDependencies);
+
+	TArray<UPackage*> DeletedPackages;
+
+	int32 NumCancelled = 0;
+
+	for (int32 ChunkStart = 0; ChunkStart < AssetsToDelete.Num(); ChunkStart += ChunkSize)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			NumCancelled = AssetsToDelete.Num() - ChunkStart;
+			AssetDeletionQueue::LogAssetsNotDeleted(TEXT("Cancelled"), MakeArrayView(AssetsToDelete).RightChop(ChunkStart));
+			break;
+		}
+
+		const int32 ChunkEnd = FMath::Min(ChunkStart + ChunkSize, AssetsToDelete.Num());
+
+		SlowTask.EnterProgressFrame(1.f, FText::FromString(
+			FString::Printf(TEXT("Deleting assets %d - %d of %d"), ChunkStart + 1, ChunkEnd, AssetsToDelete.Num())));
+
+		TArray<FString> ObjectPathsToLoad;
+		ObjectPathsToLoad.Reserve(ChunkEnd - ChunkStart);
+
+		for (int32 i = ChunkStart; i < ChunkEnd; ++i)
+		{
+			const FAssetData& AssetData = AssetsToDelete[i];
+
+			// kept by a referencer an earlier chunk found in memory
+			if (!PackagesToDelete.Contains(AssetData.PackageName))
+			{
+				ReferencedAssets.Add(AssetData);
+				continue;
+			}
+
+			ObjectPathsToLoad.Add(AssetData.GetObjectPathString());
+		}
+
+		TArray<UObject*> LoadedObjects;
+		AssetViewUtils::LoadAssetsIfNeeded(ObjectPathsToLoad, LoadedObjects, false);
+
+		FOperationProfiler::AddCount(EOperationCounter::PackagesLoaded, LoadedObjects.Num());
+
+		// the registry only knows saved references, these go to the engine dialog with the others
+		TArray<UObject*> ReferencedInMemory;
+		AssetDeletionQueue::GatherReferencedInMemory(LoadedObjects, PackagesToDelete, ReferencedInMemory);
+
+		for (UObject* Object : ReferencedInMemory)
+		{
+			AssetDeletionQueue::KeepWithDependencies(Object->GetOutermost()->GetFName(), FlushDependencies, PackagesToDelete);
+		}
+
+		for (UObject* Object : LoadedObjects)
+		{
+			UPackage* Package = Object->GetOutermost();
+
+			if (!PackagesToDelete.Contains(Package->GetFName()))
+			{
+				ReferencedAssets.Emplace(Object);
+				continue;
+			}
+
+			// references were checked above, the cleanup below checks every package after one GC
+			if (ObjectTools::DeleteSingleObject(Object, false))
+			{
+				DeletedPackages.AddUnique(Package);
+			}
+		}
+	}
+
+	// one garbage collection, one source control batch, then the files are removed
+	if (DeletedPackages.Num() > 0)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FAssetDeletionQueue::CleanupAfterSuccessfulDelete);
+
+		ObjectTools::CleanupAfterSuccessfulDelete(DeletedPackages, true);
+
+		FOperationProfiler::AddCount(EOperationCounter::GCPasses);
+	}
+
+	int32 NumDeleted = DeletedPackages.Num();
+
+	if (ReferencedAssets.Num() > 0)
+	{
+		if (bInteractive)
+		{
+			// the engine dialog offers to replace or force delete the references
+			NumDeleted += ObjectTools::DeleteAssets(ReferencedAssets, true);
+		}
+		else
+		{
+			AssetDeletionQueue::LogAssetsNotDeleted(TEXT("Still referenced"), ReferencedAssets);
+		}
+	}
+
+	if (NumCancelled > 0 && bInteractive)
+	{
+		Debug::ShowNotifyInfo(FString::Printf(TEXT("Deletion cancelled, %d assets were not deleted (listed in the log)"), NumCancelled));
+	}
+
+	return NumDeleted;
+}
+
+bool FAssetDeletionQueue::OnDeferredFlush(float DeltaTime)
+{
+	DeferredFlushHandle.Reset();
+
+	Flush();
+
+	return false;
+}
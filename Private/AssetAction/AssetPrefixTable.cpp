@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetAction/AssetPrefixTable.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "UObject/UObjectIterator.h"
+
+void FAssetPrefixTable::Initialize()
+{
+	SettingChangedHandle = GetMutableDefault<UBacgroundToolsSettings>()->OnSettingChanged()
+		.AddRaw(this, &FAssetPrefixTable::OnSettingChanged);
+
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged()
+		.AddRaw(this, &FAssetPrefixTable::OnModulesChanged);
+
+	Invalidate();
+}
+
+void FAssetPrefixTable::Shutdown()
+{
+	if (UObjectInitialized())
+	{
+		GetMutableDefault<UBacgroundToolsSettings>()->OnSettingChanged().Remove(SettingChangedHandle);
+	}
+
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+
+	Prefixes.Empty();
+	ResolvedPrefixIndices.Empty();
+	bNeedsRebuild = true;
+}
+
+const FAssetPrefixTable::FResolvedPrefix* FAssetPrefixTable::FindPrefix(const FTopLevelAssetPath& AssetClassPath)
+{
+	if (bNeedsRebuild)
+	{
+		Rebuild();
+	}
+
+	int32 PrefixIndex = INDEX_NONE;
+
+	if (const int32* CachedIndex = ResolvedPrefixIndices.Find(AssetClassPath))
+	{
+		PrefixIndex = *CachedIndex;
+	}
+	else
+	{
+		// Not a loaded class (e.g. blueprint class), the registry knows its parents
+		PrefixIndex = ResolveFromAssetRegistry(AssetClassPath);
+		ResolvedPrefixIndices.Add(AssetClassPath, PrefixIndex);
+	}
+
+	return Prefixes.IsValidIndex(PrefixIndex) ? &Prefixes[PrefixIndex] : nullptr;
+}
+
+const FString* FAssetPrefixTable::FindKnownPrefix(const FString& AssetName)
+{
+	if (bNeedsRebuild)
+	{
+		Rebuild();
+	}
+
+	// a handful of configured prefixes, a linear scan is enough
+	const FString* KnownPrefix = nullptr;
+
+	for (const FResolvedPrefix& ResolvedPrefix : Prefixes)
+	{
+		if (AssetName.StartsWith(ResolvedPrefix.Prefix, ESearchCase::CaseSensitive) &&
+			(!KnownPrefix || ResolvedPrefix.Prefix.Len() > KnownPrefix->Len()))
+		{
+			KnownPrefix = &ResolvedPrefix.Prefix;
+		}
+	}
+
+	return KnownPrefix;
+}
+
+void FAssetPrefixTable::Rebuild()
+{
+	bNeedsRebuild = false;
+
+	Prefixes.Reset();
+	ResolvedPrefixIndices.Reset();
+
+	for (const TPair<FSoftClassPath, FString>& Pair : UBacgroundToolsSettings::Get()->AssetPrefixes)
+	{
+		if (Pair.Key.IsNull() || Pair.Value.IsEmpty()) continue;
+
+		FResolvedPrefix ResolvedPrefix;
+		ResolvedPrefix.Prefix = Pair.Value;
+		ResolvedPrefix.PrefixClassPath = Pair.Key.GetAssetPath();
+
+		ResolvedPrefixIndices.Add(ResolvedPrefix.PrefixClassPath, Prefixes.Add(MoveTemp(ResolvedPrefix)));
+	}
+
+	// Walk the hierarchy once for every loaded class, parents are cached on the way
+	for (TObjectIterator<UClass> ClassIt; ClassIt; ++ClassIt)
+	{
+		ResolveLoadedClass(*ClassIt);
+	}
+}
+
+int32 FAssetPrefixTable::ResolveLoadedClass(UClass* Class)
+{
+	TArray<FTopLevelAssetPath, TInlineAllocator<16>> UnresolvedClassPaths;
+	int32 PrefixIndex = INDEX_NONE;
+
+	for (UClass* CurrentClass = Class; CurrentClass; CurrentClass = CurrentClass->GetSuperClass())
+	{
+		const FTopLevelAssetPath ClassPath = CurrentClass->GetClassPathName();
+
+		if (const int32* CachedIndex = ResolvedPrefixIndices.Find(ClassPath))
+		{
+			PrefixIndex = *CachedIndex;
+			break;
+		}
+
+		UnresolvedClassPaths.Add(ClassPath);
+	}
+
+	for (const FTopLevelAssetPath& ClassPath : UnresolvedClassPaths)
+	{
+		ResolvedPrefixIndices.Add(ClassPath, PrefixIndex);
+	}
+
+	return PrefixIndex;
+}
+
+int32 FAssetPrefixTable::ResolveFromAssetRegistry(const FTopLevelAssetPath& AssetClassPath)
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// closest parent first
+	TArray<FTopLevelAssetPath> AncestorClassPaths;
+	AssetRegistry.GetAncestorClassNames(AssetClassPath, AncestorClassPaths);
+
+	for (const FTopLevelAssetPath& AncestorClassPath : AncestorClassPaths)
+	{
+		if (const int32* CachedIndex = ResolvedPrefixIndices.Find(AncestorClassPath))
+		{
+			return *CachedIndex;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FAssetPrefixTable::OnSettingChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Invalidate();
+}
+
+void FAssetPrefixTable::OnModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	// new native classes to resolve
+	if (Reason == EModuleChangeReason::ModuleLoaded)
+	{
+		Invalidate();
+	}
+}
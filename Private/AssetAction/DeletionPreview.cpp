@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetAction/DeletionPreview.h"
+#include "AssetScan/ReferencerIndex.h"
+#include "AssetScan/AssetSizeCache.h"
+#include "Profiling/OperationProfiler.h"
+#include "Async/ParallelFor.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+void FDeletionPreviewGraph::Reset()
+{
+	PackageNames.Reset();
+	Layers.Reset();
+	Edges.Reset();
+	bTruncated = false;
+}
+
+void FDeletionPreview::Build(TArray<FAssetData>&& InAssets, FReferencerIndex& ReferencerIndex,
+	const FAssetSizeCache& AssetSizeCache, int32 MaxDepth, int32 MaxNodes)
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("BuildDeletionPreview");
+
+	Entries.Reset(InAssets.Num());
+	for (FAssetData& AssetData : InAssets)
+	{
+		FDeletionPreviewEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.AssetData = MoveTemp(AssetData);
+	}
+
+	// sizes and times the cache already has, the rest is stat-ed in parallel
+	TArray<int32> MissingEntries;
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		FAssetDiskSize DiskSize;
+
+		if (AssetSizeCache.FindDiskSize(Entries[i].AssetData.PackageName, DiskSize))
+		{
+			Entries[i].DiskSize = DiskSize.Footprint;
+			Entries[i].ModifiedTime = DiskSize.Timestamp;
+		}
+		else
+		{
+			MissingEntries.Add(i);
+		}
+	}
+
+	ParallelFor(MissingEntries.Num(), [this, &MissingEntries](int32 i)
+	{
+		FDeletionPreviewEntry& Entry = Entries[MissingEntries[i]];
+
+		const FAssetDiskSize DiskSize = FAssetSizeCache::StatPackage(FAssetSizeCache::GetPackageFilename(Entry.AssetData));
+		Entry.DiskSize = DiskSize.Footprint;
+		Entry.ModifiedTime = DiskSize.Timestamp;
+	});
+
+	// biggest first, that's what a reviewer looks at
+	Entries.Sort([](const FDeletionPreviewEntry& A, const FDeletionPreviewEntry& B)
+	{
+		return A.DiskSize > B.DiskSize;
+	});
+
+	TotalDiskSize = 0;
+	for (const FDeletionPreviewEntry& Entry : Entries)
+	{
+		TotalDiskSize += Entry.DiskSize;
+	}
+
+	// one copy of the index, every later depth change walks it in memory
+	Snapshot = FPackageDependencyGraph();
+	ReferencerIndex.GetDependencyGraph(Snapshot);
+	ReverseSnapshot();
+
+	EntryNodes.SetNumUninitialized(Entries.Num());
+
+	TBitArray<> DeletedNodes(false, Snapshot.Num());
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const int32* Node = Snapshot.NodeIndices.Find(Entries[i].AssetData.PackageName);
+		EntryNodes[i] = Node ? *Node : INDEX_NONE;
+
+		if (Node)
+		{
+			DeletedNodes[*Node] = true;
+		}
+	}
+
+	// referencers deleted in the same batch don't keep an asset alive
+	NumReferencedEntries = 0;
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const int32 Node = EntryNodes[i];
+		if (Node == INDEX_NONE) continue;
+
+		int32& NumExternalReferencers = Entries[i].NumExternalReferencers;
+
+		for (int32 Edge = ReverseOffsets[Node]; Edge < ReverseOffsets[Node + 1]; ++Edge)
+		{
+			if (!DeletedNodes[ReverseTargets[Edge]])
+			{
+				++NumExternalReferencers;
+			}
+		}
+
+		if (NumExternalReferencers > 0)
+		{
+			++NumReferencedEntries;
+		}
+	}
+
+	BuildGraph(MaxDepth, MaxNodes);
+}
+
+void FDeletionPreview::ReverseSnapshot()
+{
+	const int32 NumNodes = Snapshot.Num();
+
+	// count, prefix sum, fill
+	ReverseOffsets.Reset();
+	ReverseOffsets.SetNumZeroed(NumNodes + 1);
+	for (const int32 Target : Snapshot.EdgeTargets)
+	{
+		++ReverseOffsets[Target + 1];
+	}
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		ReverseOffsets[Node + 1] += ReverseOffsets[Node];
+	}
+
+	TArray<int32> FillCursors(ReverseOffsets.GetData(), NumNodes);
+	ReverseTargets.SetNumUninitialized(Snapshot.EdgeTargets.Num());
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		for (int32 Edge = Snapshot.EdgeOffsets[Node]; Edge < Snapshot.EdgeOffsets[Node + 1]; ++Edge)
+		{
+			ReverseTargets[FillCursors[Snapshot.EdgeTargets[Edge]]++] = Node;
+		}
+	}
+}
+
+void FDeletionPreview::BuildGraph(int32 MaxDepth, int32 MaxNodes)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FDeletionPreview::BuildGraph);
+
+	Graph.Reset();
+	GraphDepth = FMath::Clamp(MaxDepth, 1, static_cast<int32>(MAX_int8));
+
+	// graph node of every snapshot node reached so far
+	TMap<int32, int32> GraphNodes;
+	TArray<int32> SnapshotNodes;
+
+	auto AddNode = [this, &GraphNodes, &SnapshotNodes, MaxNodes](int32 SnapshotNode, FName PackageName, int32 Layer)
+	{
+		if (SnapshotNode != INDEX_NONE)
+		{
+			if (const int32* GraphNode = GraphNodes.Find(SnapshotNode)) return *GraphNode;
+		}
+
+		if (Graph.Num() >= MaxNodes)
+		{
+			Graph.bTruncated = true;
+			return static_cast<int32>(INDEX_NONE);
+		}
+
+		const int32 GraphNode = Graph.PackageNames.Add(PackageName);
+		Graph.Layers.Add(static_cast<int8>(Layer));
+		SnapshotNodes.Add(SnapshotNode);
+
+		if (SnapshotNode != INDEX_NONE)
+		{
+			GraphNodes.Add(SnapshotNode, GraphNode);
+		}
+		return GraphNode;
+	};
+
+	// deleted packages first, several assets of a package share its node
+	TArray<int32> DeletedFrontier;
+	TMap<FName, int32> UnknownPackageNodes;
+
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FName PackageName = Entries[i].AssetData.PackageName;
+		const int32 SnapshotNode = EntryNodes[i];
+
+		if (SnapshotNode == INDEX_NONE)
+		{
+			// not indexed yet, shown alone
+			if (const int32* GraphNode = UnknownPackageNodes.Find(PackageName))
+			{
+				Entries[i].GraphNode = *GraphNode;
+				continue;
+			}
+
+			Entries[i].GraphNode = AddNode(INDEX_NONE, PackageName, 0);
+			if (Entries[i].GraphNode != INDEX_NONE)
+			{
+				UnknownPackageNodes.Add(PackageName, Entries[i].GraphNode);
+			}
+			continue;
+		}
+
+		const bool bIsNew = !GraphNodes.Contains(SnapshotNode);
+		Entries[i].GraphNode = AddNode(SnapshotNode, PackageName, 0);
+
+		if (bIsNew && Entries[i].GraphNode != INDEX_NONE)
+		{
+			DeletedFrontier.Add(SnapshotNode);
+		}
+	}
+
+	// level by level BFS, referencers to the left and dependencies to the right.
+	// a package reached both ways keeps the side it was reached first on
+	auto Expand = [this, &AddNode](const TArray<int32>& Offsets, const TArray<int32>& Targets, TArray<int32> Frontier, int32 Direction)
+	{
+		TArray<int32> NextFrontier;
+
+		for (int32 Depth = 1; Depth <= GraphDepth && Frontier.Num() > 0 && !Graph.bTruncated; ++Depth)
+		{
+			NextFrontier.Reset();
+
+			for (const int32 Node : Frontier)
+			{
+				for (int32 Edge = Offsets[Node]; Edge < Offsets[Node + 1]; ++Edge)
+				{
+					const int32 Neighbour = Targets[Edge];
+					const int32 NumBefore = Graph.Num();
+
+					if (AddNode(Neighbour, Snapshot.PackageNames[Neighbour], Depth * Direction) == INDEX_NONE) return;
+
+					if (Graph.Num() > NumBefore)
+					{
+						NextFrontier.Add(Neighbour);
+					}
+				}
+			}
+
+			Swap(Frontier, NextFrontier);
+		}
+	};
+
+	Expand(ReverseOffsets, ReverseTargets, DeletedFrontier, -1);
+	Expand(Snapshot.EdgeOffsets, Snapshot.EdgeTargets, DeletedFrontier, 1);
+
+	// every snapshot edge between two kept nodes, cross links included
+	for (int32 GraphNode = 0; GraphNode < Graph.Num(); ++GraphNode)
+	{
+		const int32 SnapshotNode = SnapshotNodes[GraphNode];
+		if (SnapshotNode == INDEX_NONE) continue;
+
+		for (int32 Edge = Snapshot.EdgeOffsets[SnapshotNode]; Edge < Snapshot.EdgeOffsets[SnapshotNode + 1]; ++Edge)
+		{
+			if (const int32* Target = GraphNodes.Find(Snapshot.EdgeTargets[Edge]))
+			{
+				Graph.Edges.Add({ GraphNode, *Target });
+			}
+		}
+	}
+}
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetAction/NamingAudit.h"
+#include "AssetAction/AssetPrefixTable.h"
+#include "AssetScan/PathExclusionRules.h"
+#include "AssetScan/FolderRootSet.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetToolsModule.h"
+#include "Materials/MaterialInstanceConstant.h"
+
+void FNamingAudit::Run(const FFolderRootSet& FolderRoots, FAssetPrefixTable& PrefixTable, const FPathExclusionRules& ExclusionRules)
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("NamingAudit");
+
+	Issues.Reset();
+	NumCorrect = 0;
+	NumWithoutPrefix = 0;
+
+	// an empty filter would return the whole registry
+	if (FolderRoots.IsEmpty()) return;
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// every root in one query, the roots don't overlap
+	FARFilter Filter;
+	FolderRoots.AddToFilter(Filter);
+
+	// the prefix table may query the registry for unloaded classes, that can't happen inside an enumeration
+	TArray<FAssetData> AssetsData;
+	AssetRegistry.GetAssets(Filter, AssetsData);
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+	FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, AssetsData.Num());
+
+	TSet<FName> PackageNames;
+	PackageNames.Reserve(AssetsData.Num());
+
+	for (const FAssetData& AssetData : AssetsData)
+	{
+		PackageNames.Add(AssetData.PackageName);
+	}
+
+	// new names given to earlier issues, two assets can't be renamed to the same name
+	TSet<FName> ClaimedPackageNames;
+
+	for (const FAssetData& AssetData : AssetsData)
+	{
+		if (ExclusionRules.IsPathExcluded(AssetData.PackagePath)) continue;
+
+		FNamingAuditEntry Entry;
+
+		if (!AuditAsset(AssetData, PrefixTable, Entry))
+		{
+			++NumWithoutPrefix;
+			continue;
+		}
+
+		if (Entry.Status == ENamingAuditStatus::Correct)
+		{
+			++NumCorrect;
+			continue;
+		}
+
+		const FName NewPackageName(*(AssetData.PackagePath.ToString() / Entry.NewName));
+
+		bool bAlreadyClaimed = false;
+		ClaimedPackageNames.Add(NewPackageName, &bAlreadyClaimed);
+
+		Entry.bNameTaken = bAlreadyClaimed || PackageNames.Contains(NewPackageName);
+
+		Issues.Add(MoveTemp(Entry));
+	}
+
+	Issues.Sort([](const FNamingAuditEntry& A, const FNamingAuditEntry& B)
+	{
+		return A.AssetData.PackageName.LexicalLess(B.AssetData.PackageName);
+	});
+}
+
+bool FNamingAudit::AuditAsset(const FAssetData& AssetData, FAssetPrefixTable& PrefixTable, FNamingAuditEntry& OutEntry)
+{
+	const FAssetPrefixTable::FResolvedPrefix* ResolvedPrefix = PrefixTable.FindPrefix(AssetData.AssetClassPath);
+
+	if (!ResolvedPrefix || ResolvedPrefix->Prefix.IsEmpty()) return false;
+
+	OutEntry.AssetData = AssetData;
+
+	FString Name = AssetData.AssetName.ToString();
+
+	if (Name.StartsWith(ResolvedPrefix->Prefix, ESearchCase::CaseSensitive))
+	{
+		OutEntry.Status = ENamingAuditStatus::Correct;
+		return true;
+	}
+
+	// the prefix of another class, e.g. "M_" on a material instance
+	if (const FString* KnownPrefix = PrefixTable.FindKnownPrefix(Name))
+	{
+		OutEntry.Status = ENamingAuditStatus::WrongPrefix;
+		Name.RightChopInline(KnownPrefix->Len(), false);
+	}
+	else
+	{
+		OutEntry.Status = ENamingAuditStatus::MissingPrefix;
+	}
+
+	//MI_instance case
+	if (ResolvedPrefix->PrefixClassPath == UMaterialInstanceConstant::StaticClass()->GetClassPathName())
+	{
+		Name.RemoveFromEnd(TEXT("_Inst"));
+	}
+
+	OutEntry.NewName = ResolvedPrefix->Prefix + Name;
+
+	return true;
+}
+
+int32 FNamingAudit::ApplyFixes(TArrayView<const FNamingAuditEntry> Entries)
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FAssetRenameData> AssetsToRename;
+	AssetsToRename.Reserve(Entries.Num());
+
+	// the caller may hand over entries the audit marked, unaudited ones, or two entries renamed to the same name
+	TSet<FString> NewObjectPaths;
+
+	for (const FNamingAuditEntry& Entry : Entries)
+	{
+		if (Entry.NewName.IsEmpty() || Entry.bNameTaken) continue;
+
+		const FString NewObjectPath = FString::Printf(TEXT("%s/%s.%s"),
+			*Entry.AssetData.PackagePath.ToString(), *Entry.NewName, *Entry.NewName);
+
+		bool bAlreadyInBatch = false;
+		NewObjectPaths.Add(NewObjectPath, &bAlreadyInBatch);
+
+		// an existing asset would also be counted as renamed below
+		if (bAlreadyInBatch || AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(NewObjectPath)).IsValid()) continue;
+
+		AssetsToRename.Emplace(Entry.AssetData.GetSoftObjectPath(), FSoftObjectPath(NewObjectPath));
+	}
+
+	if (AssetsToRename.Num() == 0) return 0;
+
+	BACGROUNDTOOLS_PROFILE_OPERATION("ApplyNamingFixes");
+
+	// One batch, so redirector and referencer fix-ups are done once for all of them
+	FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
+
+	AssetToolsModule.Get().RenameAssets(AssetsToRename);
+
+	// the batch result is false as soon as one rename failed, the others still went through
+	int32 NumRenamed = 0;
+
+	for (const FAssetRenameData& RenameData : AssetsToRename)
+	{
+		if (AssetRegistry.GetAssetByObjectPath(RenameData.NewObjectPath).IsValid())
+		{
+			++NumRenamed;
+		}
+	}
+
+	return NumRenamed;
+}
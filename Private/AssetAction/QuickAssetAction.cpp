@@ -6,10 +6,12 @@
 #include "EditorUtilityLibrary.h"
 #include "EditorAssetLibrary.h"
 #include "Misc/MessageDialog.h"
-#include "ObjectTools.h"
 #include "AssetToolsModule.h"
-#include "AssetViewUtils.h"
-#include "AssetRegistry/AssetRegistryModule.h"
+#include "FileHelpers.h"
+#include "Misc/ScopedSlowTask.h"
+#include "BacgroundTools.h"
+#include "AssetAction/NamingAudit.h"
+#include "Profiling/OperationProfiler.h"
 
 void UQuickAssetAction::DuplicateAssets(int32 NumOfDuplicates)
 {
@@ -20,73 +22,116 @@ void UQuickAssetAction::DuplicateAssets(int32 NumOfDuplicates)
 		return;
 	}
 
+	BACGROUNDTOOLS_PROFILE_OPERATION("DuplicateAssets");
+
 	TArray<FAssetData> SelectedAssetsData = UEditorUtilityLibrary::GetSelectedAssetData();
 	uint32 Counter = 0;
 
-	for (const FAssetData& SelectedAssetData : SelectedAssetsData)
+	FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, SelectedAssetsData.Num());
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Every duplicate is created first, the dirty packages are saved in a single batch afterwards
+	TArray<UPackage*> PackagesToSave;
+	PackagesToSave.Reserve(SelectedAssetsData.Num() * NumOfDuplicates);
+
 	{
-		for (int32 i = 0; i < NumOfDuplicates; i++)
+		FScopedSlowTask SlowTask(static_cast<float>(SelectedAssetsData.Num() * NumOfDuplicates),
+			FText::FromString(TEXT("Duplicating assets")));
+		SlowTask.MakeDialog(true);
+
+		bool bCancelled = false;
+
+		for (const FAssetData& SelectedAssetData : SelectedAssetsData)
 		{
+			if (bCancelled) break;
+
 			const FString SourceAssetPath = SelectedAssetData.ObjectPath.ToString();
-			const FString NewDuplicateAssetName = SelectedAssetData.AssetName.ToString() +
-				TEXT("_") + FString::FromInt(i);
-			const FString NewPathName = FPaths::Combine(SelectedAssetData.PackagePath.ToString(), NewDuplicateAssetName);
+			const FString SourceAssetName = SelectedAssetData.AssetName.ToString();
+			const FString SourcePackagePath = SelectedAssetData.PackagePath.ToString();
 
-			if (UEditorAssetLibrary::DuplicateAsset(SourceAssetPath, NewPathName))
+			for (int32 i = 0; i < NumOfDuplicates; i++)
 			{
-				UEditorAssetLibrary::SaveAsset(NewPathName, false);
-				++Counter;
+				// the outer loop has to stop too, the duplicates made so far are still saved
+				if (SlowTask.ShouldCancel())
+				{
+					bCancelled = true;
+					break;
+				}
+				SlowTask.EnterProgressFrame();
+
+				const FString NewDuplicateAssetName = SourceAssetName + TEXT("_") + FString::FromInt(i);
+				const FString NewPathName = FPaths::Combine(SourcePackagePath, NewDuplicateAssetName);
+
+				if (UObject* DuplicatedObject = UEditorAssetLibrary::DuplicateAsset(SourceAssetPath, NewPathName))
+				{
+					PackagesToSave.Add(DuplicatedObject->GetPackage());
+					++Counter;
+				}
 			}
 		}
 	}
 
+	const double DuplicateTime = FPlatformTime::Seconds();
+
+	if (PackagesToSave.Num() > 0)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(DuplicateAssets_Save);
+		UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, true);
+	}
+
+	const double EndTime = FPlatformTime::Seconds();
+
 	if (Counter > 0)
 	{
+		const double TotalSeconds = FMath::Max(EndTime - StartTime, UE_DOUBLE_SMALL_NUMBER);
+
 		/*PrintMessage(TEXT("Successfully Duplicated " + FString::FromInt(Counter) + " files"), FColor::Green);*/
-		Debug::ShowNotifyInfo(TEXT("Successfully Duplicated " + FString::FromInt(Counter) + " files"));
+		Debug::ShowNotifyInfo(FString::Printf(
+			TEXT("Successfully Duplicated %u files in %.2fs (%.1f assets/s, duplicate %.2fs, save %.2fs)"),
+			Counter, TotalSeconds, Counter / TotalSeconds, DuplicateTime - StartTime, EndTime - DuplicateTime));
 	}
 }
 
 void UQuickAssetAction::AddPrefixes()
 {
-	TArray<UObject*> SelectedObjects = UEditorUtilityLibrary::GetSelectedAssets();
+	BACGROUNDTOOLS_PROFILE_OPERATION("AddPrefixes");
+
+	// Asset data only, nothing gets loaded to decide the prefixes
+	TArray<FAssetData> SelectedAssetsData = UEditorUtilityLibrary::GetSelectedAssetData();
 	uint32 Counter = 0;
 
-	for (UObject* SelectedObject:SelectedObjects)
-	{
-		if (!SelectedObject) continue;
+	FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, SelectedAssetsData.Num());
 
-		FString* PrefixFound = this->PrefixMap.Find(SelectedObject->GetClass());
+	TArray<FNamingAuditEntry> AssetsToRename;
+	AssetsToRename.Reserve(SelectedAssetsData.Num());
 
-		if (!PrefixFound || PrefixFound->IsEmpty())
-		{
-			Debug::PrintMessage(TEXT("Failed to find prefix for class ") + SelectedObject->GetClass()->GetName(),
-				FColor::Red);
-			continue;
-		}
+	FAssetPrefixTable& PrefixTable =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetPrefixTable();
 
-		FString OldName = SelectedObject->GetName();
+	for (const FAssetData& SelectedAssetData : SelectedAssetsData)
+	{
+		FNamingAuditEntry Entry;
 
-		if (OldName.StartsWith(*PrefixFound))
+		if (!FNamingAudit::AuditAsset(SelectedAssetData, PrefixTable, Entry))
 		{
-			Debug::PrintMessage(OldName + TEXT(" already has prefix added"), FColor::Red);
+			Debug::PrintMessage(TEXT("Failed to find prefix for class ") +
+				SelectedAssetData.AssetClassPath.GetAssetName().ToString(), FColor::Red);
 			continue;
 		}
 
-		//MI_instance case
-		if (SelectedObject->IsA<UMaterialInstanceConstant>())
+		if (Entry.Status == ENamingAuditStatus::Correct)
 		{
-			OldName.RemoveFromStart(TEXT("M_"));
-			OldName.RemoveFromEnd(TEXT("_Inst"));
+			Debug::PrintMessage(SelectedAssetData.AssetName.ToString() + TEXT(" already has prefix added"), FColor::Red);
+			continue;
 		}
 
-		const FString NewNameWithPrefix = *PrefixFound + OldName;
-
-		UEditorUtilityLibrary::RenameAsset(SelectedObject, NewNameWithPrefix);
-
-		++Counter;
+		AssetsToRename.Add(MoveTemp(Entry));
 	}
 
+	// One batch, so redirector and referencer fix-ups are done once for the whole selection
+	Counter = FNamingAudit::ApplyFixes(AssetsToRename);
+
 	Debug::ShowNotifyInfo(TEXT("Successfully renamed " + FString::FromInt(Counter) + " assets"));
 }
 
@@ -94,76 +139,14 @@ void UQuickAssetAction::AddPrefixes()
 void UQuickAssetAction::RemoveUnusedAssets()
 {
 	TArray<FAssetData> SelectedAssetsDatas = UEditorUtilityLibrary::GetSelectedAssetData();
-	TArray<FAssetData> UnusedAssetsData;
 
-	FixUpRedirectors();
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
 
-	for (const FAssetData& SelectedAssetsData : SelectedAssetsDatas)
-	{
-		TArray<FString> AssetRefrencers =
-			UEditorAssetLibrary::FindPackageReferencersForAsset(SelectedAssetsData.ObjectPath.ToString());
-
-		if (AssetRefrencers.Num() == 0)
-		{
-			UnusedAssetsData.Add(SelectedAssetsData);
-		}
-	}
-		
-	if (UnusedAssetsData.Num() == 0)
-	{
-		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No unused asset found among selected assets"), false);
-		return;
-	}
-
-	const int32 NumOfAssetsDeleted = ObjectTools::DeleteAssets(UnusedAssetsData);
-
-	if (NumOfAssetsDeleted == 0)
-		return;
-
-	Debug::ShowNotifyInfo(TEXT("Successfully deleted " + FString::FromInt(NumOfAssetsDeleted) + TEXT(" unused assets")));
+	// loads redirector packages, has to stay on the game thread
+	BacgroundToolsModule.GetRedirectorFixUpService().FixUpRedirectorsForAssets(SelectedAssetsDatas);
 
+	// the referencer index may have to be built first, that runs with the reachability search on the thread pool.
+	// the unused assets found go to the deletion queue when the scan finishes
+	BacgroundToolsModule.StartUnusedAssetScan(MoveTemp(SelectedAssetsDatas));
 }
-
-void UQuickAssetAction::FixUpRedirectors()
-{
-	IAssetRegistry& AssetRegistry =
-		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
-
-	FARFilter Filter;
-	Filter.bRecursivePaths = true;
-	Filter.PackagePaths.Emplace(FName("/Game"));
-	Filter.ClassPaths.Add(UObjectRedirector::StaticClass()->GetClassPathName());
-
-	TArray<FAssetData> AssetList;
-	AssetRegistry.GetAssets(Filter, AssetList);
-
-	if (AssetList.Num() == 0) return;
-
-	TArray<FString> ObjectPaths;
-	for (const FAssetData& Asset : AssetList)
-	{
-		ObjectPaths.Add(Asset.GetObjectPathString());
-	}
-
-	TArray<UObject*> Objects;
-	AssetViewUtils::FLoadAssetsSettings Settings;
-	Settings.bFollowRedirectors = false;
-	Settings.bAllowCancel = true;
-
-	AssetViewUtils::ELoadAssetsResult Result = AssetViewUtils::LoadAssetsIfNeeded(ObjectPaths, Objects, Settings);
-
-	if (Result != AssetViewUtils::ELoadAssetsResult::Cancelled)
-	{
-		// Transform Objects array to ObjectRedirectors array
-		TArray<UObjectRedirector*> Redirectors;
-		for (UObject* Object : Objects)
-		{
-			Redirectors.Add(CastChecked<UObjectRedirector>(Object));
-		}
-
-		// Load the asset tools module
-		FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
-		AssetToolsModule.Get().FixupReferencers(Redirectors);
-
-	}
-}
\ No newline at end of file
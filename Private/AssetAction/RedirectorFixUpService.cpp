@@ -0,0 +1,278 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetAction/RedirectorFixUpService.h"
+#include "AssetScan/FolderRootSet.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetToolsModule.h"
+#include "AssetViewUtils.h"
+#include "Misc/PackageName.h"
+#include "UObject/ObjectRedirector.h"
+#include "Profiling/OperationProfiler.h"
+
+void FRedirectorFixUpService::Initialize()
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FRedirectorFixUpService::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FRedirectorFixUpService::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FRedirectorFixUpService::OnAssetRenamed);
+	// an updated asset can have been turned into a redirector, same handling as an added one
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FRedirectorFixUpService::OnAssetAdded);
+	FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FRedirectorFixUpService::OnFilesLoaded);
+}
+
+void FRedirectorFixUpService::Shutdown()
+{
+	if (FAssetRegistryModule* AssetRegistryModule =
+		FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+
+	TrackedRedirectors.Empty();
+	bIsTracking = false;
+}
+
+void FRedirectorFixUpService::FixUpRedirectorsForAssets(const TArray<FAssetData>& Assets)
+{
+	EnsureTracking();
+
+	if (TrackedRedirectors.Num() == 0) return;
+
+	TSet<FName> AssetPackages;
+	AssetPackages.Reserve(Assets.Num());
+
+	for (const FAssetData& AssetData : Assets)
+	{
+		AssetPackages.Add(AssetData.PackageName);
+	}
+
+	TArray<FSoftObjectPath> RedirectorPaths;
+
+	for (const TPair<FName, FTrackedRedirector>& Pair : TrackedRedirectors)
+	{
+		if (AssetPackages.Contains(Pair.Value.DestinationPackage) || AssetPackages.Contains(Pair.Key))
+		{
+			RedirectorPaths.Add(Pair.Value.ObjectPath);
+		}
+	}
+
+	FixUpRedirectors(RedirectorPaths);
+}
+
+void FRedirectorFixUpService::FixUpRedirectorsUnderRoots(const FFolderRootSet& FolderRoots)
+{
+	TArray<FSoftObjectPath> RedirectorPaths;
+	GetRedirectorsUnderRoots(FolderRoots, RedirectorPaths);
+
+	FixUpRedirectors(RedirectorPaths);
+}
+
+void FRedirectorFixUpService::GetRedirectorsUnderRoots(const FFolderRootSet& FolderRoots, TArray<FSoftObjectPath>& OutRedirectorPaths)
+{
+	EnsureTracking();
+
+	// one walk over the tracked redirectors whatever the number of roots
+	for (const TPair<FName, FTrackedRedirector>& Pair : TrackedRedirectors)
+	{
+		const FTrackedRedirector& Redirector = Pair.Value;
+
+		if (FolderRoots.ContainsPath(Redirector.PackagePath) ||
+			FolderRoots.ContainsPath(FPackageName::GetLongPackagePath(Redirector.DestinationPackage.ToString())))
+		{
+			OutRedirectorPaths.Add(Redirector.ObjectPath);
+		}
+	}
+}
+
+void FRedirectorFixUpService::AddTrackedRootPath(const FString& RootPath)
+{
+	FString TrackedRootPath = RootPath;
+	TrackedRootPath.RemoveFromEnd(TEXT("/"));
+
+	if (TrackedRootPaths.Contains(TrackedRootPath)) return;
+
+	TrackedRootPaths.Add(MoveTemp(TrackedRootPath));
+
+	// queried again with the new root on next use
+	bIsTracking = false;
+	TrackedRedirectors.Empty();
+}
+
+void FRedirectorFixUpService::RemoveTrackedRootPath(const FString& RootPath)
+{
+	FString TrackedRootPath = RootPath;
+	TrackedRootPath.RemoveFromEnd(TEXT("/"));
+
+	if (TrackedRootPaths.Remove(TrackedRootPath) == 0) return;
+
+	for (auto It = TrackedRedirectors.CreateIterator(); It; ++It)
+	{
+		if (FFolderRootSet::IsPathUnder(It.Value().PackagePath.ToString(), TrackedRootPath))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FRedirectorFixUpService::EnsureTracking()
+{
+	if (bIsTracking) return;
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& RootPath : TrackedRootPaths)
+	{
+		Filter.PackagePaths.Emplace(*RootPath);
+	}
+	Filter.ClassPaths.Add(UObjectRedirector::StaticClass()->GetClassPathName());
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FRedirectorFixUpService::EnsureTracking);
+
+	TArray<FAssetData> AssetList;
+	AssetRegistry.GetAssets(Filter, AssetList);
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+
+	TrackedRedirectors.Reset();
+
+	for (const FAssetData& Asset : AssetList)
+	{
+		TrackRedirector(Asset);
+	}
+
+	// from now on registry events keep the set current
+	bIsTracking = true;
+}
+
+void FRedirectorFixUpService::TrackRedirector(const FAssetData& AssetData)
+{
+	FTrackedRedirector Redirector;
+	Redirector.ObjectPath = AssetData.GetSoftObjectPath();
+	Redirector.PackagePath = AssetData.PackagePath;
+
+	// the destination is a registry tag of the redirector, no need to load it
+	FString DestinationObject;
+	if (AssetData.GetTagValue(FName("DestinationObject"), DestinationObject))
+	{
+		const FString DestinationObjectPath = FPackageName::ExportTextPathToObjectPath(DestinationObject);
+		Redirector.DestinationPackage = FName(*FPackageName::ObjectPathToPackageName(DestinationObjectPath));
+	}
+
+	TrackedRedirectors.Add(AssetData.PackageName, MoveTemp(Redirector));
+}
+
+bool FRedirectorFixUpService::IsRedirector(const FAssetData& AssetData)
+{
+	return AssetData.AssetClassPath == UObjectRedirector::StaticClass()->GetClassPathName();
+}
+
+bool FRedirectorFixUpService::IsUnderTrackedRoot(FName PackagePath) const
+{
+	const FString PackagePathString = PackagePath.ToString();
+
+	return TrackedRootPaths.ContainsByPredicate([&PackagePathString](const FString& RootPath)
+	{
+		return FFolderRootSet::IsPathUnder(PackagePathString, RootPath);
+	});
+}
+
+void FRedirectorFixUpService::FixUpRedirectors(const TArray<FSoftObjectPath>& RedirectorPaths)
+{
+	if (RedirectorPaths.Num() == 0) return;
+
+	BACGROUNDTOOLS_PROFILE_OPERATION("FixUpRedirectors");
+
+	TArray<FString> ObjectPaths;
+	ObjectPaths.Reserve(RedirectorPaths.Num());
+
+	for (const FSoftObjectPath& RedirectorPath : RedirectorPaths)
+	{
+		ObjectPaths.Add(RedirectorPath.ToString());
+	}
+
+	// Single batched load for every redirector involved
+	TArray<UObject*> Objects;
+	AssetViewUtils::FLoadAssetsSettings Settings;
+	Settings.bFollowRedirectors = false;
+	Settings.bAllowCancel = true;
+
+	AssetViewUtils::ELoadAssetsResult Result = AssetViewUtils::LoadAssetsIfNeeded(ObjectPaths, Objects, Settings);
+
+	FOperationProfiler::AddCount(EOperationCounter::PackagesLoaded, Objects.Num());
+
+	if (Result == AssetViewUtils::ELoadAssetsResult::Cancelled) return;
+
+	// Transform Objects array to ObjectRedirectors array
+	TArray<UObjectRedirector*> Redirectors;
+	for (UObject* Object : Objects)
+	{
+		if (UObjectRedirector* Redirector = Cast<UObjectRedirector>(Object))
+		{
+			Redirectors.Add(Redirector);
+		}
+	}
+
+	if (Redirectors.Num() == 0) return;
+
+	// Load the asset tools module
+	FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
+	AssetToolsModule.Get().FixupReferencers(Redirectors);
+
+	// the fixed up redirectors are deleted, which collects garbage once
+	FOperationProfiler::AddCount(EOperationCounter::GCPasses);
+}
+
+#pragma region AssetRegistryEvents
+
+void FRedirectorFixUpService::OnAssetAdded(const FAssetData& AssetData)
+{
+	if (!bIsTracking) return;
+
+	if (IsRedirector(AssetData))
+	{
+		if (IsUnderTrackedRoot(AssetData.PackagePath))
+		{
+			TrackRedirector(AssetData);
+		}
+	}
+	else
+	{
+		TrackedRedirectors.Remove(AssetData.PackageName);
+	}
+}
+
+void FRedirectorFixUpService::OnAssetRemoved(const FAssetData& AssetData)
+{
+	if (!bIsTracking) return;
+
+	TrackedRedirectors.Remove(AssetData.PackageName);
+}
+
+void FRedirectorFixUpService::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (!bIsTracking) return;
+
+	TrackedRedirectors.Remove(FName(*FPackageName::ObjectPathToPackageName(OldObjectPath)));
+
+	OnAssetAdded(AssetData);
+}
+
+void FRedirectorFixUpService::OnFilesLoaded()
+{
+	// anything tracked during the initial discovery may be incomplete, query again on next use
+	bIsTracking = false;
+	TrackedRedirectors.Empty();
+}
+
+#pragma endregion
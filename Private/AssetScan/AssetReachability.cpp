@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/AssetReachability.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "Settings/ProjectPackagingSettings.h"
+#include "GameMapsSettings.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "Misc/PackageName.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace AssetReachability
+{
+	// frontier nodes per BFS task, smaller levels run on fewer tasks
+	constexpr int32 MinNodesPerTask = 1024;
+
+	void AddRootObjectPath(const FString& ObjectPath, FReachabilityRoots& OutRoots)
+	{
+		if (ObjectPath.IsEmpty()) return;
+
+		OutRoots.RootPackages.Add(FName(*FPackageName::ObjectPathToPackageName(ObjectPath)));
+	}
+
+	void AddRootPath(FString Path, FReachabilityRoots& OutRoots)
+	{
+		if (Path.IsEmpty()) return;
+
+		// "/Game/Foo" must not match "/Game/FooBar"
+		if (!Path.EndsWith(TEXT("/")))
+		{
+			Path += TEXT("/");
+		}
+
+		OutRoots.RootPaths.Add(MoveTemp(Path));
+	}
+}
+
+bool FReachabilityRoots::IsRoot(FName PackageName) const
+{
+	if (RootPackages.Contains(PackageName)) return true;
+
+	if (RootPaths.Num() == 0) return false;
+
+	const FString PackageNameString = PackageName.ToString();
+
+	for (const FString& RootPath : RootPaths)
+	{
+		if (PackageNameString.StartsWith(RootPath)) return true;
+	}
+
+	return false;
+}
+
+FAssetReachability::FAssetReachability(FPackageDependencyGraph&& InGraph)
+	: Graph(MoveTemp(InGraph))
+{
+}
+
+void FAssetReachability::CollectRoots(FReachabilityRoots& OutRoots)
+{
+	check(IsInGameThread());
+
+	const UBacgroundToolsSettings* Settings = UBacgroundToolsSettings::Get();
+
+	for (const FDirectoryPath& RootDirectory : Settings->AdditionalRootDirectories)
+	{
+		AssetReachability::AddRootPath(RootDirectory.Path, OutRoots);
+	}
+
+	if (Settings->bContentOutsideGameIsRoot)
+	{
+		// every mount point but /Game, engine and plugin content is never a candidate for deletion
+		TArray<FString> RootContentPaths;
+		FPackageName::QueryRootContentPaths(RootContentPaths);
+
+		for (const FString& RootContentPath : RootContentPaths)
+		{
+			if (RootContentPath != TEXT("/Game/"))
+			{
+				AssetReachability::AddRootPath(RootContentPath, OutRoots);
+			}
+		}
+	}
+
+	// maps and game modes the project starts with
+	AssetReachability::AddRootObjectPath(UGameMapsSettings::GetGameDefaultMap(), OutRoots);
+	AssetReachability::AddRootObjectPath(UGameMapsSettings::GetGlobalDefaultGameMode(), OutRoots);
+	AssetReachability::AddRootObjectPath(UGameMapsSettings::GetGlobalDefaultServerGameMode(), OutRoots);
+
+	const UProjectPackagingSettings* PackagingSettings = GetDefault<UProjectPackagingSettings>();
+
+	if (Settings->bMapsAreRoots)
+	{
+		for (const FFilePath& MapToCook : PackagingSettings->MapsToCook)
+		{
+			AssetReachability::AddRootObjectPath(MapToCook.FilePath, OutRoots);
+		}
+
+		// the cook takes every map when the list is empty
+		if (PackagingSettings->MapsToCook.Num() == 0)
+		{
+			IAssetRegistry& AssetRegistry =
+				FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+			TArray<FAssetData> MapAssets;
+			AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetClassPathName(), MapAssets);
+
+			for (const FAssetData& MapAsset : MapAssets)
+			{
+				OutRoots.RootPackages.Add(MapAsset.PackageName);
+			}
+		}
+	}
+
+	if (Settings->bAlwaysCookDirectoriesAreRoots)
+	{
+		for (const FDirectoryPath& AlwaysCookDirectory : PackagingSettings->DirectoriesToAlwaysCook)
+		{
+			AssetReachability::AddRootPath(AlwaysCookDirectory.Path, OutRoots);
+		}
+	}
+
+	if (Settings->bPrimaryAssetsAreRoots && UAssetManager::IsInitialized())
+	{
+		UAssetManager& AssetManager = UAssetManager::Get();
+
+		TArray<FPrimaryAssetTypeInfo> PrimaryAssetTypeInfos;
+		AssetManager.GetPrimaryAssetTypeInfoList(PrimaryAssetTypeInfos);
+
+		for (const FPrimaryAssetTypeInfo& TypeInfo : PrimaryAssetTypeInfos)
+		{
+			TArray<FPrimaryAssetId> PrimaryAssetIds;
+			AssetManager.GetPrimaryAssetIdList(TypeInfo.PrimaryAssetType, PrimaryAssetIds);
+
+			for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+			{
+				const FSoftObjectPath PrimaryAssetPath = AssetManager.GetPrimaryAssetPath(PrimaryAssetId);
+
+				if (!PrimaryAssetPath.IsNull())
+				{
+					OutRoots.RootPackages.Add(PrimaryAssetPath.GetLongPackageFName());
+				}
+			}
+		}
+	}
+}
+
+bool FAssetReachability::Compute(const FReachabilityRoots& InRoots, const std::atomic<bool>* bCancelRequested)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAssetReachability::Compute);
+
+	Roots = InRoots;
+
+	const int32 NumNodes = Graph.Num();
+
+	// one byte per node so tasks can claim nodes with a compare exchange
+	TArray<int8> Visited;
+	Visited.SetNumZeroed(NumNodes);
+
+	TArray<int32> Frontier;
+
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		if (Roots.IsRoot(Graph.PackageNames[NodeIndex]))
+		{
+			Visited[NodeIndex] = 1;
+			Frontier.Add(NodeIndex);
+		}
+	}
+
+	TArray<TArray<int32>> NextFrontiers;
+
+	while (Frontier.Num() > 0)
+	{
+		if (bCancelRequested && *bCancelRequested)
+		{
+			Reachable.Reset();
+			return false;
+		}
+
+		const int32 NumTasks = FMath::Min(FMath::DivideAndRoundUp(Frontier.Num(), AssetReachability::MinNodesPerTask),
+			FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+		const int32 NodesPerTask = FMath::DivideAndRoundUp(Frontier.Num(), NumTasks);
+
+		NextFrontiers.SetNum(NumTasks);
+
+		ParallelFor(NumTasks, [this, &Frontier, &Visited, &NextFrontiers, NodesPerTask](int32 TaskIndex)
+		{
+			TArray<int32>& NextFrontier = NextFrontiers[TaskIndex];
+			NextFrontier.Reset();
+
+			const int32 FrontierEnd = FMath::Min((TaskIndex + 1) * NodesPerTask, Frontier.Num());
+
+			for (int32 i = TaskIndex * NodesPerTask; i < FrontierEnd; ++i)
+			{
+				const int32 NodeIndex = Frontier[i];
+
+				for (int32 Edge = Graph.EdgeOffsets[NodeIndex]; Edge < Graph.EdgeOffsets[NodeIndex + 1]; ++Edge)
+				{
+					const int32 Target = Graph.EdgeTargets[Edge];
+
+					// cheap read first, the exchange only for nodes that look unvisited
+					if (Visited[Target] == 0 && FPlatformAtomics::InterlockedCompareExchange(&Visited[Target], 1, 0) == 0)
+					{
+						NextFrontier.Add(Target);
+					}
+				}
+			}
+		});
+
+		Frontier.Reset();
+		for (int32 TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+		{
+			Frontier.Append(NextFrontiers[TaskIndex]);
+		}
+	}
+
+	Reachable.Init(false, NumNodes);
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		Reachable[NodeIndex] = Visited[NodeIndex] != 0;
+	}
+
+	return true;
+}
+
+bool FAssetReachability::IsReachable(FName PackageName) const
+{
+	if (const int32* NodeIndex = Graph.NodeIndices.Find(PackageName))
+	{
+		return Reachable.IsValidIndex(*NodeIndex) && Reachable[*NodeIndex];
+	}
+
+	return Roots.IsRoot(PackageName);
+}
+
+void FAssetReachability::FindUnreachableCycles(TArray<TArray<FName>>& OutCycles) const
+{
+	const int32 NumNodes = Graph.Num();
+
+	if (Reachable.Num() != NumNodes) return;
+
+	// Reachable nodes never point at unreachable ones, the walk stays inside the dead subgraph
+	TArray<int32> NodeOrder;
+	TArray<int32> LowLinks;
+	NodeOrder.Init(INDEX_NONE, NumNodes);
+	LowLinks.Init(INDEX_NONE, NumNodes);
+
+	TBitArray<> OnStack(false, NumNodes);
+	TArray<int32> Stack;
+
+	struct FFrame
+	{
+		int32 NodeIndex;
+		int32 NextEdge;
+	};
+	TArray<FFrame> CallStack;
+
+	int32 NextOrder = 0;
+
+	auto Visit = [&](int32 NodeIndex)
+	{
+		NodeOrder[NodeIndex] = LowLinks[NodeIndex] = NextOrder++;
+		Stack.Add(NodeIndex);
+		OnStack[NodeIndex] = true;
+		CallStack.Add({NodeIndex, Graph.EdgeOffsets[NodeIndex]});
+	};
+
+	for (int32 StartIndex = 0; StartIndex < NumNodes; ++StartIndex)
+	{
+		if (Reachable[StartIndex] || NodeOrder[StartIndex] != INDEX_NONE) continue;
+
+		Visit(StartIndex);
+
+		while (CallStack.Num() > 0)
+		{
+			const int32 NodeIndex = CallStack.Last().NodeIndex;
+			const int32 Edge = CallStack.Last().NextEdge;
+
+			if (Edge < Graph.EdgeOffsets[NodeIndex + 1])
+			{
+				++CallStack.Last().NextEdge;
+
+				const int32 Target = Graph.EdgeTargets[Edge];
+
+				if (Reachable[Target]) continue;
+
+				if (NodeOrder[Target] == INDEX_NONE)
+				{
+					Visit(Target);
+				}
+				else if (OnStack[Target])
+				{
+					LowLinks[NodeIndex] = FMath::Min(LowLinks[NodeIndex], NodeOrder[Target]);
+				}
+				continue;
+			}
+
+			CallStack.Pop(false);
+
+			if (CallStack.Num() > 0)
+			{
+				const int32 ParentIndex = CallStack.Last().NodeIndex;
+				LowLinks[ParentIndex] = FMath::Min(LowLinks[ParentIndex], LowLinks[NodeIndex]);
+			}
+
+			if (LowLinks[NodeIndex] != NodeOrder[NodeIndex]) continue;
+
+			// NodeIndex is the root of a component, everything above it on the stack belongs to it
+			TArray<FName> Component;
+			int32 MemberIndex;
+			do
+			{
+				MemberIndex = Stack.Pop(false);
+				OnStack[MemberIndex] = false;
+				Component.Add(Graph.PackageNames[MemberIndex]);
+			}
+			while (MemberIndex != NodeIndex);
+
+			// single packages aren't cycles, self references are never recorded
+			if (Component.Num() > 1)
+			{
+				OutCycles.Add(MoveTemp(Component));
+			}
+		}
+	}
+}
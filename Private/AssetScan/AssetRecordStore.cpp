@@ -0,0 +1,287 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/AssetRecordStore.h"
+#include "AssetScan/AssetSizeCache.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "UObject/Package.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace AssetRecordStore
+{
+	const FTopLevelAssetPath WorldClassPath(TEXT("/Script/Engine"), TEXT("World"));
+
+	// hash buckets, power of two, grown with the record count up to the last one
+	constexpr uint32 MinPathHashSize = 1024;
+	constexpr uint32 MaxPathHashSize = 0x10000;
+}
+
+void FAssetRecordStore::Reserve(int32 Number)
+{
+	PackageNames.Reserve(Number);
+	AssetNames.Reserve(Number);
+	ClassIndices.Reserve(Number);
+	Flags.Reserve(Number);
+	DiskSizes.Reserve(Number);
+	ResourceSizes.Reserve(Number);
+	Selection.Reserve(Number);
+}
+
+void FAssetRecordStore::Reset()
+{
+	PackageNames.Reset();
+	AssetNames.Reset();
+	ClassIndices.Reset();
+	Flags.Reset();
+	DiskSizes.Reset();
+	ResourceSizes.Reset();
+	Selection.Reset();
+
+	ClassPaths.Reset();
+	ClassPathToIndex.Reset();
+
+	PathHash.Clear();
+	PathHashSize = 0;
+}
+
+int32 FAssetRecordStore::AddOrUpdate(const FAssetData& AssetData)
+{
+	const uint16* FoundClassIndex = ClassPathToIndex.Find(AssetData.AssetClassPath);
+	uint16 ClassIndex = FoundClassIndex ? *FoundClassIndex : 0;
+
+	if (!FoundClassIndex)
+	{
+		check(ClassPaths.Num() < MAX_uint16);
+
+		ClassIndex = static_cast<uint16>(ClassPaths.Add(AssetData.AssetClassPath));
+		ClassPathToIndex.Add(AssetData.AssetClassPath, ClassIndex);
+	}
+
+	const EAssetRecordFlags RecordFlags = AssetData.AssetClassPath == AssetRecordStore::WorldClassPath ?
+		EAssetRecordFlags::Map : EAssetRecordFlags::None;
+
+	int32 Index = Find(AssetData.GetSoftObjectPath());
+
+	if (Index == INDEX_NONE)
+	{
+		Index = PackageNames.Add(AssetData.PackageName);
+		AssetNames.Add(AssetData.AssetName);
+		ClassIndices.Add(ClassIndex);
+		Flags.Add(RecordFlags);
+		DiskSizes.Add(-1);
+		ResourceSizes.Add(-1);
+		Selection.Add(false);
+
+		if (static_cast<uint32>(Num()) > PathHashSize * 2 && PathHashSize < AssetRecordStore::MaxPathHashSize)
+		{
+			RebuildPathHash();
+		}
+		else
+		{
+			PathHash.Add(HashObjectPath(AssetData.PackageName, AssetData.AssetName), Index);
+		}
+
+		return Index;
+	}
+
+	ClassIndices[Index] = ClassIndex;
+	Flags[Index] = RecordFlags;
+
+	// the package may have been saved since, its size is queried again
+	DiskSizes[Index] = -1;
+
+	return Index;
+}
+
+int32 FAssetRecordStore::Find(const FSoftObjectPath& ObjectPath) const
+{
+	if (PathHashSize == 0 || !ObjectPath.GetSubPathString().IsEmpty()) return INDEX_NONE;
+
+	const FName PackageName = ObjectPath.GetLongPackageFName();
+	const FName AssetName = ObjectPath.GetAssetFName();
+
+	for (uint32 Index = PathHash.First(HashObjectPath(PackageName, AssetName)); PathHash.IsValid(Index); Index = PathHash.Next(Index))
+	{
+		if (PackageNames[Index] == PackageName && AssetNames[Index] == AssetName)
+		{
+			return static_cast<int32>(Index);
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FAssetRecordStore::RemoveAll(const TBitArray<>& RecordsToRemove)
+{
+	check(RecordsToRemove.Num() == Num());
+
+	// every column is compacted in the same pass
+	int32 WriteIndex = 0;
+	for (int32 ReadIndex = 0; ReadIndex < Num(); ++ReadIndex)
+	{
+		if (RecordsToRemove[ReadIndex]) continue;
+
+		if (WriteIndex != ReadIndex)
+		{
+			PackageNames[WriteIndex] = PackageNames[ReadIndex];
+			AssetNames[WriteIndex] = AssetNames[ReadIndex];
+			ClassIndices[WriteIndex] = ClassIndices[ReadIndex];
+			Flags[WriteIndex] = Flags[ReadIndex];
+			DiskSizes[WriteIndex] = DiskSizes[ReadIndex];
+			ResourceSizes[WriteIndex] = ResourceSizes[ReadIndex];
+			Selection[WriteIndex] = Selection[ReadIndex];
+		}
+		++WriteIndex;
+	}
+
+	if (WriteIndex == Num()) return;
+
+	PackageNames.SetNum(WriteIndex);
+	AssetNames.SetNum(WriteIndex);
+	ClassIndices.SetNum(WriteIndex);
+	Flags.SetNum(WriteIndex);
+	DiskSizes.SetNum(WriteIndex);
+	ResourceSizes.SetNum(WriteIndex);
+	Selection.SetNumUninitialized(WriteIndex);
+
+	RebuildPathHash();
+}
+
+void FAssetRecordStore::RemoveAt(int32 Index)
+{
+	if (!IsValidIndex(Index)) return;
+
+	TBitArray<> RecordsToRemove(false, Num());
+	RecordsToRemove[Index] = true;
+
+	RemoveAll(RecordsToRemove);
+}
+
+FSoftObjectPath FAssetRecordStore::GetObjectPath(int32 Index) const
+{
+	return FSoftObjectPath(FTopLevelAssetPath(PackageNames[Index], AssetNames[Index]), FString());
+}
+
+int32 FAssetRecordStore::FindClassIndex(const FTopLevelAssetPath& ClassPath) const
+{
+	const uint16* ClassIndex = ClassPathToIndex.Find(ClassPath);
+
+	return ClassIndex ? *ClassIndex : INDEX_NONE;
+}
+
+void FAssetRecordStore::FillMissingDiskSizes()
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	int32 NumQueried = 0;
+
+	for (int32 i = 0; i < Num(); ++i)
+	{
+		if (DiskSizes[i] >= 0) continue;
+
+		TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageNames[i]);
+		DiskSizes[i] = PackageData ? FMath::Max<int64>(PackageData->DiskSize, 0) : 0;
+
+		++NumQueried;
+	}
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries, NumQueried);
+}
+
+void FAssetRecordStore::UpdateDiskSizes(const FAssetSizeCache& AssetSizeCache)
+{
+	AssetSizeCache.GetKnownFootprints(PackageNames, DiskSizes);
+}
+
+bool FAssetRecordStore::UpdateResourceSizes()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAssetRecordStore::UpdateResourceSizes);
+
+	bool bHasChanges = false;
+
+	for (int32 i = 0; i < Num(); ++i)
+	{
+		// most packages aren't loaded, one hash lookup rules them out
+		const UPackage* Package = FindObjectFast<UPackage>(nullptr, PackageNames[i]);
+		const UObject* Asset = Package ? FindObjectFast<UObject>(const_cast<UPackage*>(Package), AssetNames[i]) : nullptr;
+
+		const int64 ResourceSize = Asset ? Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : -1;
+
+		bHasChanges |= ResourceSizes[i] != ResourceSize;
+		ResourceSizes[i] = ResourceSize;
+	}
+
+	return bHasChanges;
+}
+
+void FAssetRecordStore::SetSelected(int32 Index, bool bSelected)
+{
+	if (!Selection.IsValidIndex(Index)) return;
+
+	Selection[Index] = bSelected;
+}
+
+FAssetData FAssetRecordStore::GetAssetData(int32 Index) const
+{
+	if (!IsValidIndex(Index)) return FAssetData();
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+
+	return AssetRegistry.GetAssetByObjectPath(GetObjectPath(Index));
+}
+
+void FAssetRecordStore::GetSelectedAssetData(TArray<FAssetData>& OutAssetData) const
+{
+	FARFilter Filter;
+
+	for (TConstSetBitIterator<> It(Selection); It; ++It)
+	{
+		Filter.SoftObjectPaths.Add(GetObjectPath(It.GetIndex()));
+	}
+
+	if (Filter.SoftObjectPaths.Num() == 0) return;
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetRegistry.GetAssets(Filter, OutAssetData);
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+}
+
+SIZE_T FAssetRecordStore::GetAllocatedSize() const
+{
+	return PackageNames.GetAllocatedSize()
+		+ AssetNames.GetAllocatedSize()
+		+ ClassIndices.GetAllocatedSize()
+		+ Flags.GetAllocatedSize()
+		+ DiskSizes.GetAllocatedSize()
+		+ ResourceSizes.GetAllocatedSize()
+		+ Selection.GetAllocatedSize()
+		+ ClassPaths.GetAllocatedSize()
+		+ ClassPathToIndex.GetAllocatedSize()
+		// bucket heads plus one next index per record
+		+ (PathHashSize + PackageNames.Max()) * sizeof(uint32);
+}
+
+uint32 FAssetRecordStore::HashObjectPath(FName PackageName, FName AssetName)
+{
+	return HashCombine(GetTypeHash(PackageName), GetTypeHash(AssetName));
+}
+
+void FAssetRecordStore::RebuildPathHash()
+{
+	PathHashSize = FMath::Clamp<uint32>(FMath::RoundUpToPowerOfTwo(Num() / 2),
+		AssetRecordStore::MinPathHashSize, AssetRecordStore::MaxPathHashSize);
+
+	PathHash.Clear(PathHashSize, PackageNames.Max());
+
+	for (int32 i = 0; i < Num(); ++i)
+	{
+		PathHash.Add(HashObjectPath(PackageNames[i], AssetNames[i]), i);
+	}
+}
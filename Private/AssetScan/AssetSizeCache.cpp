@@ -0,0 +1,329 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/AssetSizeCache.h"
+#include "AssetScan/AssetRecordStore.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+namespace AssetSizeCache
+{
+	// packages stat-ed between two lock acquisitions / update broadcasts
+	constexpr int32 BatchSize = 256;
+
+	// age after which a cached entry is re-stat-ed when requested again, rows on screen are checked more often
+	constexpr double VisibleRevalidatePeriod = 10.0;
+	constexpr double BackgroundRevalidatePeriod = 300.0;
+
+	const FTopLevelAssetPath WorldClassPath(TEXT("/Script/Engine"), TEXT("World"));
+
+	const TCHAR* const CompanionExtensions[] =
+	{
+		TEXT(".uexp"),
+		TEXT(".ubulk"),
+		TEXT(".uptnl")
+	};
+}
+
+void FAssetSizeCache::Initialize()
+{
+	AliveToken = MakeShared<bool, ESPMode::ThreadSafe>(true);
+	bShutdownRequested = false;
+
+	PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FAssetSizeCache::OnPackageSaved);
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FAssetSizeCache::OnAssetRemoved);
+}
+
+void FAssetSizeCache::Shutdown()
+{
+	bShutdownRequested = true;
+
+	if (WorkerFuture.IsValid())
+	{
+		WorkerFuture.Wait();
+	}
+
+	AliveToken.Reset();
+
+	UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+
+	if (FAssetRegistryModule* AssetRegistryModule =
+		FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+	{
+		AssetRegistryModule->Get().OnAssetRemoved().Remove(AssetRemovedHandle);
+	}
+
+	FScopeLock ScopeLock(&Lock);
+
+	DiskSizes.Empty();
+	QueuedPackages.Empty();
+	VisibleRequests.Empty();
+	BackgroundRequests.Empty();
+}
+
+bool FAssetSizeCache::FindDiskSize(FName PackageName, FAssetDiskSize& OutDiskSize) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (const FCachedDiskSize* Cached = DiskSizes.Find(PackageName))
+	{
+		OutDiskSize = Cached->DiskSize;
+		return true;
+	}
+
+	return false;
+}
+
+void FAssetSizeCache::GetKnownFootprints(TArrayView<const FName> PackageNames, TArrayView<int64> InOutFootprints) const
+{
+	check(PackageNames.Num() == InOutFootprints.Num());
+
+	FScopeLock ScopeLock(&Lock);
+
+	for (int32 i = 0; i < PackageNames.Num(); ++i)
+	{
+		if (const FCachedDiskSize* Cached = DiskSizes.Find(PackageNames[i]))
+		{
+			InOutFootprints[i] = Cached->DiskSize.Footprint;
+		}
+	}
+}
+
+int32 FAssetSizeCache::GetKnownTimestamps(TArrayView<const FName> PackageNames, TArrayView<FDateTime> InOutTimestamps) const
+{
+	check(PackageNames.Num() == InOutTimestamps.Num());
+
+	FScopeLock ScopeLock(&Lock);
+
+	int32 NumKnown = 0;
+
+	for (int32 i = 0; i < PackageNames.Num(); ++i)
+	{
+		if (const FCachedDiskSize* Cached = DiskSizes.Find(PackageNames[i]))
+		{
+			InOutTimestamps[i] = Cached->DiskSize.Timestamp;
+			++NumKnown;
+		}
+	}
+
+	return NumKnown;
+}
+
+void FAssetSizeCache::RequestDiskSizes(const FAssetRecordStore& Records, bool bVisible)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	for (int32 i = 0; i < Records.Num(); ++i)
+	{
+		RequestDiskSizeLocked(Records.GetPackageName(i), Records.HasAnyFlags(i, EAssetRecordFlags::Map), bVisible);
+	}
+}
+
+void FAssetSizeCache::RequestDiskSize(FName PackageName, bool bIsMap, bool bVisible)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	RequestDiskSizeLocked(PackageName, bIsMap, bVisible);
+}
+
+FString FAssetSizeCache::GetPackageFilename(const FAssetData& AssetData)
+{
+	return GetPackageFilename(AssetData.PackageName, AssetData.AssetClassPath == AssetSizeCache::WorldClassPath);
+}
+
+FString FAssetSizeCache::GetPackageFilename(FName PackageName, bool bIsMap)
+{
+	FString Filename;
+	FPackageName::TryConvertLongPackageNameToFilename(PackageName.ToString(), Filename,
+		bIsMap ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension());
+
+	return Filename;
+}
+
+void FAssetSizeCache::RequestDiskSizeLocked(FName PackageName, bool bIsMap, bool bVisible)
+{
+	if (const FCachedDiskSize* Cached = DiskSizes.Find(PackageName))
+	{
+		// the cached entry keeps being served, the worker only replaces it if the files changed
+		const double RevalidatePeriod = bVisible ?
+			AssetSizeCache::VisibleRevalidatePeriod : AssetSizeCache::BackgroundRevalidatePeriod;
+
+		if (FPlatformTime::Seconds() - Cached->StatTime < RevalidatePeriod) return;
+	}
+
+	if (QueuedPackages.Contains(PackageName))
+	{
+		// already in the background queue, a visible row moves it ahead
+		if (bVisible)
+		{
+			VisibleRequests.Add({PackageName, FString(), bIsMap});
+		}
+		return;
+	}
+
+	// package name to filename conversion is left to the worker
+	QueueRequest({PackageName, FString(), bIsMap}, bVisible);
+}
+
+void FAssetSizeCache::QueueRequest(FRequest&& Request, bool bVisible)
+{
+	QueuedPackages.Add(Request.PackageName);
+	(bVisible ? VisibleRequests : BackgroundRequests).Add(MoveTemp(Request));
+
+	if (bIsWorkerRunning || bShutdownRequested) return;
+
+	bIsWorkerRunning = true;
+	WorkerFuture = Async(EAsyncExecution::ThreadPool, [this]()
+	{
+		RunWorker();
+	});
+}
+
+void FAssetSizeCache::RunWorker()
+{
+	TArray<FRequest> Batch;
+	TArray<FAssetDiskSize> Results;
+
+	while (!bShutdownRequested)
+	{
+		Batch.Reset();
+
+		{
+			FScopeLock ScopeLock(&Lock);
+
+			while (Batch.Num() < AssetSizeCache::BatchSize && (VisibleRequests.Num() > 0 || BackgroundRequests.Num() > 0))
+			{
+				FRequest Request = VisibleRequests.Num() > 0 ? VisibleRequests.Pop(false) : BackgroundRequests.Pop(false);
+
+				// a visible duplicate of a background request, or already done
+				if (!QueuedPackages.Remove(Request.PackageName)) continue;
+
+				Batch.Add(MoveTemp(Request));
+			}
+
+			if (Batch.Num() == 0)
+			{
+				bIsWorkerRunning = false;
+				return;
+			}
+		}
+
+		TRACE_CPUPROFILER_EVENT_SCOPE(FAssetSizeCache::StatBatch);
+
+		// stat calls are IO bound, spread them over the pool
+		Results.SetNum(Batch.Num());
+		ParallelFor(Batch.Num(), [&Batch, &Results](int32 i)
+		{
+			FRequest& Request = Batch[i];
+
+			if (Request.Filename.IsEmpty())
+			{
+				FPackageName::TryConvertLongPackageNameToFilename(Request.PackageName.ToString(), Request.Filename,
+					Request.bIsMap ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension());
+			}
+
+			Results[i] = StatPackage(Request.Filename);
+		});
+
+		bool bHasChanges = false;
+
+		{
+			FScopeLock ScopeLock(&Lock);
+
+			const double StatTime = FPlatformTime::Seconds();
+
+			for (int32 i = 0; i < Batch.Num(); ++i)
+			{
+				FCachedDiskSize& Cached = DiskSizes.FindOrAdd(Batch[i].PackageName);
+
+				// a revalidated entry whose files did not change needs no broadcast
+				bHasChanges |= Cached.StatTime == 0.0 || Cached.DiskSize.Footprint != Results[i].Footprint ||
+					Cached.DiskSize.Timestamp != Results[i].Timestamp;
+
+				Cached.DiskSize = Results[i];
+				Cached.StatTime = StatTime;
+			}
+		}
+
+		if (bHasChanges)
+		{
+			PostUpdated();
+		}
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	bIsWorkerRunning = false;
+}
+
+FAssetDiskSize FAssetSizeCache::StatPackage(const FString& Filename)
+{
+	FAssetDiskSize DiskSize;
+
+	const FFileStatData PackageStat = IFileManager::Get().GetStatData(*Filename);
+
+	// missing or never saved, the default timestamp keeps it out of the age filter
+	if (!PackageStat.bIsValid) return DiskSize;
+
+	DiskSize.Footprint = PackageStat.FileSize;
+	DiskSize.Timestamp = PackageStat.ModificationTime;
+
+	const FString BaseFilename = FPaths::GetBaseFilename(Filename, false);
+
+	for (const TCHAR* CompanionExtension : AssetSizeCache::CompanionExtensions)
+	{
+		const FFileStatData CompanionStat = IFileManager::Get().GetStatData(*(BaseFilename + CompanionExtension));
+
+		if (!CompanionStat.bIsValid) continue;
+
+		DiskSize.Footprint += CompanionStat.FileSize;
+		DiskSize.Timestamp = FMath::Max(DiskSize.Timestamp, CompanionStat.ModificationTime);
+	}
+
+	return DiskSize;
+}
+
+void FAssetSizeCache::PostUpdated()
+{
+	// one pending broadcast at most, the listeners read whatever is cached by then
+	if (bIsUpdatePosted.exchange(true)) return;
+
+	TWeakPtr<bool, ESPMode::ThreadSafe> WeakAliveToken = AliveToken;
+
+	AsyncTask(ENamedThreads::GameThread, [this, WeakAliveToken]()
+	{
+		if (!WeakAliveToken.IsValid()) return;
+
+		bIsUpdatePosted = false;
+		OnDiskSizesUpdated.Broadcast();
+	});
+}
+
+void FAssetSizeCache::OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+{
+	if (!Package) return;
+
+	FScopeLock ScopeLock(&Lock);
+
+	// only refresh what was already known, the rest is requested on demand
+	if (DiskSizes.Remove(Package->GetFName()) > 0 && !QueuedPackages.Contains(Package->GetFName()))
+	{
+		QueueRequest({Package->GetFName(), PackageFilename, Package->ContainsMap()}, false);
+	}
+}
+
+void FAssetSizeCache::OnAssetRemoved(const FAssetData& AssetData)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	DiskSizes.Remove(AssetData.PackageName);
+}
@@ -0,0 +1,673 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/DuplicateContentScan.h"
+#include "AssetScan/ReferencerIndex.h"
+#include "AssetScan/PathExclusionRules.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/PackageFileSummary.h"
+#include "UObject/ObjectResource.h"
+#include "Serialization/ArchiveProxy.h"
+#include "AssetViewUtils.h"
+#include "ObjectTools.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "Framework/Notifications/NotificationManager.h"
+
+namespace DuplicateContentScan
+{
+	// packages between two cancel checks / progress updates
+	constexpr int32 ChunkSize = 1024;
+
+	// one buffer per worker, the whole scan never holds more than MaxWorkers of them
+	constexpr int32 ReadBufferSize = 2 * 1024 * 1024;
+
+	// disk bound past a few readers
+	constexpr int32 MaxWorkers = 8;
+
+	const FTopLevelAssetPath RedirectorClassPath(TEXT("/Script/CoreUObject"), TEXT("ObjectRedirector"));
+	const FTopLevelAssetPath WorldClassPath(TEXT("/Script/Engine"), TEXT("World"));
+
+	const TCHAR* const BulkCompanionExtensions[] =
+	{
+		TEXT(".ubulk"),
+		TEXT(".uptnl")
+	};
+
+	// bulk payload when there is one, export data otherwise
+	int64 GetPayloadSize(const FDuplicateContentEntry& Entry)
+	{
+		return Entry.BulkSize > 0 ? Entry.BulkSize : Entry.ExportSize;
+	}
+
+	const FIoHash& GetPayloadHash(const FDuplicateContentEntry& Entry)
+	{
+		return Entry.BulkSize > 0 ? Entry.BulkHash : Entry.ExportHash;
+	}
+
+	/** Reads FNames as indices into the package's name map, the way the linker does */
+	class FNameMapReader : public FArchiveProxy
+	{
+	public:
+		FNameMapReader(FArchive& InInnerArchive, const TArray<FName>& InNameMap)
+			: FArchiveProxy(InInnerArchive)
+			, NameMap(InNameMap)
+		{
+		}
+
+		using FArchiveProxy::operator<<;
+
+		virtual FArchive& operator<<(FName& Name) override
+		{
+			int32 NameIndex = 0;
+			int32 Number = 0;
+			InnerArchive << NameIndex << Number;
+
+			if (!NameMap.IsValidIndex(NameIndex))
+			{
+				SetError();
+				Name = NAME_None;
+				return *this;
+			}
+
+			Name = FName(NameMap[NameIndex], Number);
+			return *this;
+		}
+
+	private:
+		const TArray<FName>& NameMap;
+	};
+}
+
+FDuplicateContentScan::FDuplicateContentScan(const FFolderRootSet& InFolderRoots, FReferencerIndex& InReferencerIndex,
+	const FPathExclusionRules& InExclusionRules)
+	: FolderRoots(InFolderRoots)
+	, ReferencerIndex(InReferencerIndex)
+	, ExclusionRules(InExclusionRules)
+{
+}
+
+void FDuplicateContentScan::Start(const FOnDuplicateContentScanFinished& InOnFinished)
+{
+	check(IsInGameThread());
+
+	OnFinished = InOnFinished;
+	bCancelRequested = false;
+	bIsRunning = true;
+
+	FNotificationInfo NotifyInfo(FText::FromString(TEXT("Scanning duplicate content under ") + FolderRoots.ToString()));
+	NotifyInfo.bUseLargeFont = true;
+	NotifyInfo.bFireAndForget = false;
+	NotifyInfo.FadeOutDuration = 5.f;
+	NotifyInfo.ButtonDetails.Add(FNotificationButtonInfo(
+		FText::FromString(TEXT("Cancel")),
+		FText::FromString(TEXT("Stop scanning for duplicate content")),
+		FSimpleDelegate::CreateSP(this, &FDuplicateContentScan::OnCancelButtonClicked),
+		SNotificationItem::CS_Pending));
+
+	ProgressNotification = FSlateNotificationManager::Get().AddNotification(NotifyInfo);
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	// ThisRef holds the scan until the worker and its last game thread post are done
+	TSharedRef<FDuplicateContentScan, ESPMode::ThreadSafe> ThisRef = AsShared();
+	WorkerFuture = Async(EAsyncExecution::ThreadPool, [ThisRef]()
+	{
+		ThisRef->Run();
+
+		// cleared once the worker is really done, whether Run finished or returned on a cancel
+		AsyncTask(ENamedThreads::GameThread, [ThisRef]()
+		{
+			ThisRef->bIsRunning = false;
+		});
+	});
+}
+
+void FDuplicateContentScan::Cancel()
+{
+	check(IsInGameThread());
+
+	bCancelRequested = true;
+	OnFinished.Unbind();
+
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetText(FText::FromString(TEXT("Duplicate content scan cancelled")));
+		ProgressNotification->SetCompletionState(SNotificationItem::CS_Fail);
+		ProgressNotification->ExpireAndFadeout();
+		ProgressNotification.Reset();
+	}
+}
+
+void FDuplicateContentScan::CancelAndWait()
+{
+	Cancel();
+
+	if (WorkerFuture.IsValid())
+	{
+		WorkerFuture.Wait();
+	}
+}
+
+void FDuplicateContentScan::Run()
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("DuplicateContentScan");
+
+	PostProgress(TEXT("Collecting assets under ") + FolderRoots.ToString());
+
+	// the roots are queried in parallel, duplicates across selected folders are found in the same pass
+	TArray<FAssetData> AssetsDataArray;
+	FolderRoots.GetOnDiskAssets(ExclusionRules, AssetsDataArray);
+
+	// redirectors and maps can't be consolidated
+	AssetsDataArray.RemoveAllSwap([](const FAssetData& AssetData)
+	{
+		return AssetData.AssetClassPath == DuplicateContentScan::RedirectorClassPath
+			|| AssetData.AssetClassPath == DuplicateContentScan::WorldClassPath;
+	});
+
+	// the hash is per package, a package holding several assets is left out
+	AssetsDataArray.Sort([](const FAssetData& A, const FAssetData& B)
+	{
+		return A.PackageName.LexicalLess(B.PackageName);
+	});
+
+	TArray<FDuplicateContentEntry> Entries;
+	Entries.Reserve(AssetsDataArray.Num());
+
+	for (int32 i = 0; i < AssetsDataArray.Num(); ++i)
+	{
+		const FName PackageName = AssetsDataArray[i].PackageName;
+
+		if ((i > 0 && AssetsDataArray[i - 1].PackageName == PackageName) ||
+			(i + 1 < AssetsDataArray.Num() && AssetsDataArray[i + 1].PackageName == PackageName))
+		{
+			continue;
+		}
+
+		Entries.AddDefaulted_GetRef().AssetData = MoveTemp(AssetsDataArray[i]);
+	}
+
+	AssetsDataArray.Empty();
+
+	// Summaries only : a few kilobytes per package give the payload sizes
+	TArray<FPackageLayout> Layouts;
+	Layouts.SetNum(Entries.Num());
+
+	TBitArray<> HasLayout(false, Entries.Num());
+
+	for (int32 ChunkStart = 0; ChunkStart < Entries.Num(); ChunkStart += DuplicateContentScan::ChunkSize)
+	{
+		if (bCancelRequested) return;
+
+		TRACE_CPUPROFILER_EVENT_SCOPE(FDuplicateContentScan::ReadSummaries);
+
+		const int32 ChunkEnd = FMath::Min(ChunkStart + DuplicateContentScan::ChunkSize, Entries.Num());
+
+		TArray<bool> Results;
+		Results.SetNumZeroed(ChunkEnd - ChunkStart);
+
+		ParallelFor(ChunkEnd - ChunkStart, [this, ChunkStart, &Entries, &Layouts, &Results](int32 i)
+		{
+			FDuplicateContentEntry& Entry = Entries[ChunkStart + i];
+
+			FString Filename;
+			if (!FPackageName::TryConvertLongPackageNameToFilename(Entry.AssetData.PackageName.ToString(), Filename,
+				FPackageName::GetAssetPackageExtension()))
+			{
+				return;
+			}
+
+			Results[i] = ReadPackageLayout(Filename, Layouts[ChunkStart + i], Entry);
+		});
+
+		for (int32 i = 0; i < Results.Num(); ++i)
+		{
+			HasLayout[ChunkStart + i] = Results[i];
+		}
+
+		PostProgress(FString::Printf(TEXT("Read %d / %d package summaries"), ChunkEnd, Entries.Num()));
+	}
+
+	// Only a payload size shared with another asset of the same class can be a duplicate
+	TMap<TPair<FTopLevelAssetPath, int64>, TArray<int32>> SizeBuckets;
+
+	for (TConstSetBitIterator<> It(HasLayout); It; ++It)
+	{
+		const FDuplicateContentEntry& Entry = Entries[It.GetIndex()];
+
+		const int64 PayloadSize = DuplicateContentScan::GetPayloadSize(Entry);
+		if (PayloadSize <= 0) continue;
+
+		// negative keys keep bulk and export sizes apart
+		SizeBuckets.FindOrAdd({Entry.AssetData.AssetClassPath, Entry.BulkSize > 0 ? -PayloadSize : PayloadSize}).Add(It.GetIndex());
+	}
+
+	TArray<int32> ToHash;
+	for (const TPair<TPair<FTopLevelAssetPath, int64>, TArray<int32>>& Bucket : SizeBuckets)
+	{
+		if (Bucket.Value.Num() > 1)
+		{
+			ToHash.Append(Bucket.Value);
+		}
+	}
+
+	SizeBuckets.Empty();
+
+	// file order keeps the reads of each worker close to each other on disk
+	ToHash.Sort([&Layouts](int32 A, int32 B)
+	{
+		return Layouts[A].Filename < Layouts[B].Filename;
+	});
+
+	int64 BytesToHash = 0;
+	for (const int32 EntryIndex : ToHash)
+	{
+		BytesToHash += Entries[EntryIndex].ExportSize + Entries[EntryIndex].BulkSize;
+	}
+
+	PostProgress(FString::Printf(TEXT("Hashing %d packages (%.1f MB)"), ToHash.Num(), BytesToHash / (1024.0 * 1024.0)));
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FDuplicateContentScan::HashPackages);
+
+		const int32 NumWorkers = FMath::Clamp(FPlatformMisc::NumberOfWorkerThreadsToSpawn(), 1, DuplicateContentScan::MaxWorkers);
+
+		TBitArray<> Hashed(false, Entries.Num());
+		FCriticalSection HashedLock;
+
+		std::atomic<int32> NextIndex { 0 };
+		std::atomic<int32> NumDone { 0 };
+
+		// A fixed pool pulling packages one at a time, each worker reuses its own buffer
+		ParallelFor(NumWorkers, [&](int32 WorkerIndex)
+		{
+			TArray<uint8> Buffer;
+			Buffer.SetNumUninitialized(DuplicateContentScan::ReadBufferSize);
+
+			for (int32 i = NextIndex++; i < ToHash.Num() && !bCancelRequested; i = NextIndex++)
+			{
+				const int32 EntryIndex = ToHash[i];
+
+				if (HashPackage(Layouts[EntryIndex], Buffer, Entries[EntryIndex]))
+				{
+					FScopeLock ScopeLock(&HashedLock);
+					Hashed[EntryIndex] = true;
+				}
+
+				const int32 Done = ++NumDone;
+				if (Done % DuplicateContentScan::ChunkSize == 0)
+				{
+					PostProgress(FString::Printf(TEXT("Hashed %d / %d packages"), Done, ToHash.Num()));
+				}
+			}
+		}, EParallelForFlags::Unbalanced);
+
+		if (bCancelRequested) return;
+
+		ToHash.RemoveAll([&Hashed](int32 EntryIndex)
+		{
+			return !Hashed[EntryIndex];
+		});
+	}
+
+	PostProgress(TEXT("Grouping duplicates"));
+
+	TMap<TPair<FTopLevelAssetPath, FIoHash>, TArray<int32>> HashGroups;
+
+	for (const int32 EntryIndex : ToHash)
+	{
+		const FDuplicateContentEntry& Entry = Entries[EntryIndex];
+		HashGroups.FindOrAdd({Entry.AssetData.AssetClassPath, DuplicateContentScan::GetPayloadHash(Entry)}).Add(EntryIndex);
+	}
+
+	// Builds the index if needed, otherwise only applies pending registry changes
+	if (!ReferencerIndex.Update(&bCancelRequested)) return;
+
+	TArray<FDuplicateContentGroup> Groups;
+
+	for (TPair<TPair<FTopLevelAssetPath, FIoHash>, TArray<int32>>& HashGroup : HashGroups)
+	{
+		if (HashGroup.Value.Num() < 2) continue;
+
+		TArray<TPair<int32, int32>> ReferencerCounts;
+		for (const int32 EntryIndex : HashGroup.Value)
+		{
+			ReferencerCounts.Emplace(EntryIndex, ReferencerIndex.GetReferencerCount(Entries[EntryIndex].AssetData.PackageName));
+		}
+
+		ReferencerCounts.Sort([&Entries](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+		{
+			if (A.Value != B.Value) return A.Value > B.Value;
+
+			const FString PathA = Entries[A.Key].AssetData.PackageName.ToString();
+			const FString PathB = Entries[B.Key].AssetData.PackageName.ToString();
+
+			return PathA.Len() != PathB.Len() ? PathA.Len() < PathB.Len() : PathA < PathB;
+		});
+
+		FDuplicateContentGroup& Group = Groups.AddDefaulted_GetRef();
+
+		for (const TPair<int32, int32>& ReferencerCount : ReferencerCounts)
+		{
+			Group.Entries.Add(MoveTemp(Entries[ReferencerCount.Key]));
+		}
+
+		const FDuplicateContentEntry& Keeper = Group.Entries[0];
+
+		Group.bMatchedOnBulkData = Keeper.BulkSize > 0;
+
+		for (int32 i = 1; i < Group.Entries.Num(); ++i)
+		{
+			const FDuplicateContentEntry& Entry = Group.Entries[i];
+
+			Group.bIdentical &= Entry.ExportHash == Keeper.ExportHash && Entry.BulkHash == Keeper.BulkHash;
+			Group.WastedBytes += Entry.ExportSize + Entry.BulkSize;
+		}
+	}
+
+	Groups.Sort([](const FDuplicateContentGroup& A, const FDuplicateContentGroup& B)
+	{
+		return A.WastedBytes > B.WastedBytes;
+	});
+
+	if (bCancelRequested) return;
+
+	PostFinished(MoveTemp(Groups));
+}
+
+bool FDuplicateContentScan::ReadPackageLayout(const FString& Filename, FPackageLayout& OutLayout, FDuplicateContentEntry& OutEntry)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+
+	if (!Reader) return false;
+
+	FPackageFileSummary Summary;
+	*Reader << Summary;
+
+	if (Reader->IsError() || Summary.Tag != PACKAGE_FILE_TAG || Summary.TotalHeaderSize <= 0) return false;
+
+	const FString BaseFilename = FPaths::GetBaseFilename(Filename, false);
+
+	// cooked style packages carry their exports in a .uexp, offsets continue past the .uasset
+	int64 PackageSize = Reader->TotalSize();
+
+	const int64 ExportFileSize = IFileManager::Get().FileSize(*(BaseFilename + TEXT(".uexp")));
+	if (ExportFileSize > 0)
+	{
+		PackageSize += ExportFileSize;
+	}
+
+	OutLayout.Filename = Filename;
+	OutLayout.HeaderSize = Summary.TotalHeaderSize;
+	OutLayout.BulkDataStart = Summary.BulkDataStartOffset > Summary.TotalHeaderSize ?
+		FMath::Min(Summary.BulkDataStartOffset, PackageSize) : PackageSize;
+
+	OutEntry.ExportSize = OutLayout.BulkDataStart - OutLayout.HeaderSize;
+	OutEntry.BulkSize = PackageSize - OutLayout.BulkDataStart;
+
+	for (const TCHAR* CompanionExtension : DuplicateContentScan::BulkCompanionExtensions)
+	{
+		const int64 CompanionSize = IFileManager::Get().FileSize(*(BaseFilename + CompanionExtension));
+		if (CompanionSize > 0)
+		{
+			OutEntry.BulkSize += CompanionSize;
+		}
+	}
+
+	return OutEntry.ExportSize >= 0;
+}
+
+bool FDuplicateContentScan::HashPackage(const FPackageLayout& Layout, TArray<uint8>& Buffer, FDuplicateContentEntry& OutEntry) const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	FBlake3 ExportHasher;
+	FBlake3 BulkHasher;
+
+	// the export bytes hold FNames and FPackageIndex values, they only mean something through the header tables
+	if (!HashPackageTables(Layout, OutEntry.AssetData.PackageName, ExportHasher)) return false;
+
+	const FString BaseFilename = FPaths::GetBaseFilename(Layout.Filename, false);
+
+	// Streams a file, the bytes before SkipUntil are not read and the logical offset picks the hasher
+	auto HashFile = [&](const FString& Filename, int64 LogicalStart, int64 SkipUntil, bool bRequired) -> int64
+	{
+		TUniquePtr<IFileHandle> FileHandle(PlatformFile.OpenRead(*Filename));
+
+		if (!FileHandle) return bRequired ? -1 : 0;
+
+		const int64 FileSize = FileHandle->Size();
+		int64 Position = FMath::Clamp<int64>(SkipUntil - LogicalStart, 0, FileSize);
+
+		if (Position > 0 && !FileHandle->Seek(Position)) return -1;
+
+		while (Position < FileSize)
+		{
+			// a single package can weigh gigabytes
+			if (bCancelRequested) return -1;
+
+			const int64 LogicalOffset = LogicalStart + Position;
+
+			int64 ReadSize = FMath::Min<int64>(Buffer.Num(), FileSize - Position);
+
+			// a read never straddles the start of the bulk data
+			if (LogicalOffset < Layout.BulkDataStart)
+			{
+				ReadSize = FMath::Min(ReadSize, Layout.BulkDataStart - LogicalOffset);
+			}
+
+			if (!FileHandle->Read(Buffer.GetData(), ReadSize)) return -1;
+
+			(LogicalOffset < Layout.BulkDataStart ? ExportHasher : BulkHasher).Update(Buffer.GetData(), ReadSize);
+
+			Position += ReadSize;
+		}
+
+		return FileSize;
+	};
+
+	const int64 PackageFileSize = HashFile(Layout.Filename, 0, Layout.HeaderSize, true);
+	if (PackageFileSize < 0) return false;
+
+	if (HashFile(BaseFilename + TEXT(".uexp"), PackageFileSize, Layout.HeaderSize, false) < 0) return false;
+
+	for (const TCHAR* CompanionExtension : DuplicateContentScan::BulkCompanionExtensions)
+	{
+		// past the bulk data start, the whole file goes to the bulk hasher
+		if (HashFile(BaseFilename + CompanionExtension, Layout.BulkDataStart, 0, false) < 0) return false;
+	}
+
+	OutEntry.ExportHash = FIoHash(ExportHasher.Finalize());
+	OutEntry.BulkHash = FIoHash(BulkHasher.Finalize());
+
+	return true;
+}
+
+bool FDuplicateContentScan::HashPackageTables(const FPackageLayout& Layout, FName PackageName, FBlake3& OutHasher)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Layout.Filename, FILEREAD_Silent));
+
+	if (!Reader) return false;
+
+	FPackageFileSummary Summary;
+	*Reader << Summary;
+
+	// without the versions the tables can't be read, such a package is never grouped
+	if (Reader->IsError() || Summary.bUnversioned) return false;
+
+	Reader->SetUEVer(Summary.GetFileVersionUE());
+	Reader->SetLicenseeUEVer(Summary.GetFileVersionLicenseeUE());
+	Reader->SetEngineVer(Summary.SavedByEngineVersion);
+	Reader->SetCustomVersions(Summary.GetCustomVersionContainer());
+	Reader->SetFilterEditorOnly((Summary.GetPackageFlags() & PKG_FilterEditorOnly) != 0);
+
+	TArray<FName> NameMap;
+	NameMap.Reserve(Summary.NameCount);
+
+	Reader->Seek(Summary.NameOffset);
+	for (int32 i = 0; i < Summary.NameCount && !Reader->IsError(); ++i)
+	{
+		FNameEntrySerialized NameEntry(ENAME_LinkerConstructor);
+		*Reader << NameEntry;
+
+		NameMap.Add(FName(NameEntry));
+	}
+
+	if (Reader->IsError()) return false;
+
+	const FName ShortName = FPackageName::GetShortFName(PackageName);
+
+	// length prefixed so consecutive strings can't run into each other
+	auto HashName = [&OutHasher, PackageName, ShortName](FName Name)
+	{
+		// the package's own path and asset name, the same placeholder in every copy
+		const FString NameString = Name == PackageName || Name == ShortName ? FString(TEXT("<self>")) : Name.ToString();
+		const int32 Length = NameString.Len();
+
+		OutHasher.Update(&Length, sizeof(Length));
+		OutHasher.Update(*NameString, Length * sizeof(TCHAR));
+	};
+
+	auto HashIndex = [&OutHasher](FPackageIndex Index)
+	{
+		const int32 RawIndex = Index.ForDebugging();
+		OutHasher.Update(&RawIndex, sizeof(RawIndex));
+	};
+
+	// in order, the export bytes refer to the entries by position
+	for (const FName Name : NameMap)
+	{
+		HashName(Name);
+	}
+
+	DuplicateContentScan::FNameMapReader NameMapReader(*Reader, NameMap);
+
+	NameMapReader.Seek(Summary.ImportOffset);
+	for (int32 i = 0; i < Summary.ImportCount; ++i)
+	{
+		FObjectImport Import;
+		NameMapReader << Import;
+
+		if (NameMapReader.IsError() || Reader->IsError()) return false;
+
+		HashName(Import.ClassPackage);
+		HashName(Import.ClassName);
+		HashName(Import.ObjectName);
+		HashIndex(Import.OuterIndex);
+	}
+
+	NameMapReader.Seek(Summary.ExportOffset);
+	for (int32 i = 0; i < Summary.ExportCount; ++i)
+	{
+		FObjectExport Export;
+		NameMapReader << Export;
+
+		if (NameMapReader.IsError() || Reader->IsError()) return false;
+
+		HashName(Export.ObjectName);
+		HashIndex(Export.ClassIndex);
+		HashIndex(Export.SuperIndex);
+		HashIndex(Export.TemplateIndex);
+		HashIndex(Export.OuterIndex);
+
+		const int64 SerialSize = Export.SerialSize;
+		OutHasher.Update(&SerialSize, sizeof(SerialSize));
+	}
+
+	return true;
+}
+
+int32 FDuplicateContentScan::Consolidate(const FDuplicateContentGroup& Group, int32 KeeperIndex)
+{
+	check(IsInGameThread());
+
+	if (!Group.Entries.IsValidIndex(KeeperIndex) || Group.Entries.Num() < 2) return 0;
+
+	BACGROUNDTOOLS_PROFILE_OPERATION("ConsolidateDuplicates");
+
+	TArray<FString> ObjectPathsToLoad;
+	for (const FDuplicateContentEntry& Entry : Group.Entries)
+	{
+		ObjectPathsToLoad.Add(Entry.AssetData.GetSoftObjectPath().ToString());
+	}
+
+	TArray<UObject*> LoadedObjects;
+	AssetViewUtils::LoadAssetsIfNeeded(ObjectPathsToLoad, LoadedObjects, false);
+
+	FOperationProfiler::AddCount(EOperationCounter::PackagesLoaded, LoadedObjects.Num());
+
+	const FSoftObjectPath KeeperPath = Group.Entries[KeeperIndex].AssetData.GetSoftObjectPath();
+
+	UObject* ObjectToConsolidateTo = nullptr;
+	TArray<UObject*> ObjectsToConsolidate;
+
+	for (UObject* Object : LoadedObjects)
+	{
+		if (FSoftObjectPath(Object) == KeeperPath)
+		{
+			ObjectToConsolidateTo = Object;
+		}
+		else
+		{
+			ObjectsToConsolidate.Add(Object);
+		}
+	}
+
+	if (!ObjectToConsolidateTo || ObjectsToConsolidate.Num() == 0) return 0;
+
+	// references are replaced, the duplicates deleted and redirectors left for unloaded referencers
+	const ObjectTools::FConsolidationResults Results =
+		ObjectTools::ConsolidateObjects(ObjectToConsolidateTo, ObjectsToConsolidate, false);
+
+	FOperationProfiler::AddCount(EOperationCounter::GCPasses);
+
+	return ObjectsToConsolidate.Num() - Results.InvalidConsolidationObjs.Num() - Results.FailedConsolidationObjs.Num();
+}
+
+void FDuplicateContentScan::PostProgress(const FString& ProgressMessage)
+{
+	TSharedRef<FDuplicateContentScan, ESPMode::ThreadSafe> ThisRef = AsShared();
+
+	AsyncTask(ENamedThreads::GameThread, [ThisRef, ProgressMessage]()
+	{
+		if (ThisRef->bCancelRequested || !ThisRef->ProgressNotification.IsValid()) return;
+
+		ThisRef->ProgressNotification->SetText(FText::FromString(ProgressMessage));
+	});
+}
+
+void FDuplicateContentScan::PostFinished(TArray<FDuplicateContentGroup>&& Groups)
+{
+	TSharedRef<FDuplicateContentScan, ESPMode::ThreadSafe> ThisRef = AsShared();
+
+	AsyncTask(ENamedThreads::GameThread, [ThisRef, Groups = MoveTemp(Groups)]()
+	{
+		// Cancel() already closed the notification
+		if (ThisRef->bCancelRequested) return;
+
+		if (ThisRef->ProgressNotification.IsValid())
+		{
+			ThisRef->ProgressNotification->SetText(FText::FromString(
+				TEXT("Found ") + FString::FromInt(Groups.Num()) + TEXT(" groups of duplicate content")));
+			ThisRef->ProgressNotification->SetCompletionState(SNotificationItem::CS_Success);
+			ThisRef->ProgressNotification->ExpireAndFadeout();
+			ThisRef->ProgressNotification.Reset();
+		}
+
+		ThisRef->OnFinished.ExecuteIfBound(Groups);
+	});
+}
+
+void FDuplicateContentScan::OnCancelButtonClicked()
+{
+	// bIsRunning stays set until the worker notices and returns
+	Cancel();
+}
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/EmptyFolderTree.h"
+#include "AssetScan/PathExclusionRules.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Profiling/OperationProfiler.h"
+
+void FEmptyFolderTree::Build(const TArray<FString>& FolderPaths, const FPathExclusionRules& ExclusionRules)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FEmptyFolderTree::Build);
+
+	EmptySubtrees.Reset();
+	NumEmptyFolders = 0;
+
+	if (FolderPaths.Num() == 0) return;
+
+	const int32 NumFolders = FolderPaths.Num();
+
+	TMap<FName, int32> PathToIndex;
+	PathToIndex.Reserve(NumFolders);
+
+	for (int32 i = 0; i < NumFolders; ++i)
+	{
+		PathToIndex.Add(FName(*FolderPaths[i]), i);
+	}
+
+	TArray<int32> ParentIndices;
+	ParentIndices.Init(INDEX_NONE, NumFolders);
+
+	// assets in the folder and below, excluded folders count as content so nothing above them is deleted
+	TArray<int32> AssetCounts;
+	AssetCounts.Init(0, NumFolders);
+
+	for (int32 i = 0; i < NumFolders; ++i)
+	{
+		const FString& FolderPath = FolderPaths[i];
+
+		int32 SlashIndex;
+		if (FolderPath.FindLastChar(TEXT('/'), SlashIndex) && SlashIndex > 0)
+		{
+			if (const int32* ParentIndex = PathToIndex.Find(FName(*FolderPath.Left(SlashIndex))))
+			{
+				ParentIndices[i] = *ParentIndex;
+			}
+		}
+
+		if (ExclusionRules.IsPathExcluded(FolderPath))
+		{
+			AssetCounts[i] = 1;
+		}
+	}
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// one enumeration for the whole tree instead of a query per folder. every folder without a listed
+	// parent is a root, a folder left out of the filter would count as empty and get deleted with its files
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+
+	for (int32 i = 0; i < NumFolders; ++i)
+	{
+		if (ParentIndices[i] == INDEX_NONE)
+		{
+			Filter.PackagePaths.Emplace(*FolderPaths[i]);
+		}
+	}
+
+	int32 NumAssetsScanned = 0;
+
+	AssetRegistry.EnumerateAssets(Filter, [&PathToIndex, &AssetCounts, &NumAssetsScanned](const FAssetData& AssetData)
+	{
+		++NumAssetsScanned;
+
+		if (const int32* FolderIndex = PathToIndex.Find(AssetData.PackagePath))
+		{
+			++AssetCounts[*FolderIndex];
+		}
+		return true;
+	});
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+	FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, NumAssetsScanned);
+
+	// children have longer paths than their parent, deepest first makes a single bottom-up pass
+	TArray<int32> BottomUpOrder;
+	BottomUpOrder.SetNumUninitialized(NumFolders);
+	for (int32 i = 0; i < NumFolders; ++i)
+	{
+		BottomUpOrder[i] = i;
+	}
+
+	BottomUpOrder.Sort([&FolderPaths](int32 A, int32 B)
+	{
+		return FolderPaths[A].Len() > FolderPaths[B].Len();
+	});
+
+	TArray<int32> SubtreeFolderCounts;
+	SubtreeFolderCounts.Init(1, NumFolders);
+
+	for (const int32 FolderIndex : BottomUpOrder)
+	{
+		const int32 ParentIndex = ParentIndices[FolderIndex];
+
+		if (ParentIndex == INDEX_NONE) continue;
+
+		AssetCounts[ParentIndex] += AssetCounts[FolderIndex];
+		SubtreeFolderCounts[ParentIndex] += SubtreeFolderCounts[FolderIndex];
+	}
+
+	for (int32 i = 0; i < NumFolders; ++i)
+	{
+		if (AssetCounts[i] > 0) continue;
+
+		++NumEmptyFolders;
+
+		// topmost empty folder of its subtree
+		const int32 ParentIndex = ParentIndices[i];
+		if (ParentIndex == INDEX_NONE || AssetCounts[ParentIndex] > 0)
+		{
+			FEmptySubtree& EmptySubtree = EmptySubtrees.AddDefaulted_GetRef();
+			EmptySubtree.FolderPath = FolderPaths[i];
+			EmptySubtree.NumFolders = SubtreeFolderCounts[i];
+		}
+	}
+}
+
+bool FEmptyFolderTree::DeleteEmptySubtree(const FEmptySubtree& EmptySubtree)
+{
+	FString DirectoryFilename;
+	if (!FPackageName::TryConvertLongPackageNameToFilename(EmptySubtree.FolderPath + TEXT("/"), DirectoryFilename)) return false;
+
+	// folders known to the registry only have nothing to delete on disk
+	if (IFileManager::Get().DirectoryExists(*DirectoryFilename))
+	{
+		// the registry may not know a package yet (still discovering, copied in behind the editor's back),
+		// the recursive delete must never take one with it
+		bool bHasPackageFile = false;
+
+		IFileManager::Get().IterateDirectoryRecursively(*DirectoryFilename, [&bHasPackageFile](const TCHAR* Path, bool bIsDirectory)
+		{
+			if (!bIsDirectory)
+			{
+				const FString Extension = FPaths::GetExtension(Path, true);
+				bHasPackageFile = Extension == FPackageName::GetAssetPackageExtension() || Extension == FPackageName::GetMapPackageExtension();
+			}
+
+			// stops the iteration at the first package
+			return !bHasPackageFile;
+		});
+
+		if (bHasPackageFile || !IFileManager::Get().DeleteDirectory(*DirectoryFilename, false, true)) return false;
+	}
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetRegistry.RemovePath(EmptySubtree.FolderPath);
+
+	return true;
+}
@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/FolderRootSet.h"
+#include "AssetScan/PathExclusionRules.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+
+FFolderRootSet::FFolderRootSet(const TArray<FString>& FolderPaths)
+{
+	TArray<FString> Candidates;
+	Candidates.Reserve(FolderPaths.Num());
+
+	for (const FString& FolderPath : FolderPaths)
+	{
+		FString Candidate = FolderPath;
+		Candidate.RemoveFromEnd(TEXT("/"));
+
+		if (!Candidate.IsEmpty())
+		{
+			Candidates.Add(MoveTemp(Candidate));
+		}
+	}
+
+	// parents are shorter than their children, keeping the shortest first leaves only the topmost folders.
+	// a plain lexical sort is not enough, "/Game/A-B" sorts between "/Game/A" and "/Game/A/B"
+	Candidates.Sort([](const FString& A, const FString& B)
+	{
+		return A.Len() < B.Len();
+	});
+
+	for (FString& Candidate : Candidates)
+	{
+		const bool bCovered = Roots.ContainsByPredicate([&Candidate](const FString& Root)
+		{
+			return IsPathUnder(Candidate, Root);
+		});
+
+		if (!bCovered)
+		{
+			Roots.Add(MoveTemp(Candidate));
+		}
+	}
+
+	Roots.Sort();
+}
+
+bool FFolderRootSet::ContainsPath(FStringView PackagePath) const
+{
+	// a selection has a handful of roots, a linear walk beats any index
+	for (const FString& Root : Roots)
+	{
+		if (IsPathUnder(PackagePath, Root)) return true;
+	}
+
+	return false;
+}
+
+void FFolderRootSet::AddToFilter(FARFilter& Filter) const
+{
+	Filter.bRecursivePaths = true;
+
+	for (const FString& Root : Roots)
+	{
+		Filter.PackagePaths.Emplace(*Root);
+	}
+}
+
+void FFolderRootSet::GetOnDiskAssets(const FPathExclusionRules& ExclusionRules, TArray<FAssetData>& OutAssets) const
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<TArray<FAssetData>> RootAssets;
+	RootAssets.SetNum(Roots.Num());
+
+	// On disk assets only, in memory enumeration is game thread bound
+	ParallelFor(Roots.Num(), [this, &AssetRegistry, &ExclusionRules, &RootAssets](int32 RootIndex)
+	{
+		FARFilter Filter;
+		Filter.bRecursivePaths = true;
+		Filter.bIncludeOnlyOnDiskAssets = true;
+		Filter.PackagePaths.Emplace(*Roots[RootIndex]);
+
+		TArray<FAssetData>& Assets = RootAssets[RootIndex];
+		AssetRegistry.GetAssets(Filter, Assets);
+
+		FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+		FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, Assets.Num());
+
+		// rules are matched once per folder, the other assets of a folder hit the cache
+		Assets.RemoveAllSwap([&ExclusionRules](const FAssetData& AssetData)
+		{
+			return ExclusionRules.IsPathExcluded(AssetData.PackagePath);
+		});
+	}, Roots.Num() > 1 ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+	// the roots don't overlap, appending can't duplicate an asset
+	int32 NumAssets = OutAssets.Num();
+	for (const TArray<FAssetData>& Assets : RootAssets)
+	{
+		NumAssets += Assets.Num();
+	}
+
+	OutAssets.Reserve(NumAssets);
+
+	for (TArray<FAssetData>& Assets : RootAssets)
+	{
+		OutAssets.Append(MoveTemp(Assets));
+	}
+}
+
+void FFolderRootSet::GetFolderPaths(TArray<FString>& OutFolderPaths) const
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FString> SubPaths;
+
+	for (const FString& Root : Roots)
+	{
+		SubPaths.Reset();
+		AssetRegistry.GetSubPaths(Root, SubPaths, true);
+
+		FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+
+		OutFolderPaths.Add(Root);
+		OutFolderPaths.Append(SubPaths);
+	}
+}
+
+FString FFolderRootSet::ToString() const
+{
+	if (Roots.Num() == 0) return FString();
+
+	if (Roots.Num() == 1) return Roots[0];
+
+	return FString::Printf(TEXT("%s (+%d folders)"), *Roots[0], Roots.Num() - 1);
+}
+
+bool FFolderRootSet::IsPathUnder(FStringView PackagePath, FStringView FolderPath)
+{
+	// "/Game/Foo" must not match "/Game/FooBar"
+	if (!PackagePath.StartsWith(FolderPath)) return false;
+
+	return PackagePath.Len() == FolderPath.Len() || PackagePath[FolderPath.Len()] == TEXT('/');
+}
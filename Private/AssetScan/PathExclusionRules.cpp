@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/PathExclusionRules.h"
+#include "Settings/BacgroundToolsSettings.h"
+
+namespace PathExclusionRules
+{
+	bool HasWildcard(const FString& Rule)
+	{
+		int32 CharIndex;
+		return Rule.FindChar(TEXT('*'), CharIndex) || Rule.FindChar(TEXT('?'), CharIndex);
+	}
+}
+
+void FPathExclusionRules::Initialize()
+{
+	SettingChangedHandle = GetMutableDefault<UBacgroundToolsSettings>()->OnSettingChanged()
+		.AddRaw(this, &FPathExclusionRules::OnSettingChanged);
+
+	Compile(UBacgroundToolsSettings::Get()->ExcludedPaths);
+}
+
+void FPathExclusionRules::Shutdown()
+{
+	if (UObjectInitialized())
+	{
+		GetMutableDefault<UBacgroundToolsSettings>()->OnSettingChanged().Remove(SettingChangedHandle);
+	}
+
+	Compile(TArray<FString>());
+}
+
+void FPathExclusionRules::Compile(const TArray<FString>& Rules)
+{
+	{
+		FRWScopeLock ScopeLock(RulesLock, SLT_Write);
+
+		PrefixTrie.Reset();
+		PrefixTrie.AddDefaulted();
+
+		ExcludedFolderNames.Reset();
+		FolderNamePatterns.Reset();
+		PathPatterns.Reset();
+
+		for (const FString& RawRule : Rules)
+		{
+			FString Rule = RawRule.TrimStartAndEnd();
+			Rule.RemoveFromEnd(TEXT("/"));
+
+			if (Rule.IsEmpty()) continue;
+
+			const bool bIsPathRule = Rule.StartsWith(TEXT("/"));
+
+			if (PathExclusionRules::HasWildcard(Rule))
+			{
+				(bIsPathRule ? PathPatterns : FolderNamePatterns).Add(MoveTemp(Rule));
+				continue;
+			}
+
+			if (!bIsPathRule)
+			{
+				ExcludedFolderNames.Add(FName(*Rule));
+				continue;
+			}
+
+			TArray<FString> Components;
+			Rule.ParseIntoArray(Components, TEXT("/"));
+
+			int32 NodeIndex = 0;
+			for (const FString& Component : Components)
+			{
+				if (const int32* ChildIndex = PrefixTrie[NodeIndex].Children.Find(FName(*Component)))
+				{
+					NodeIndex = *ChildIndex;
+					continue;
+				}
+
+				const int32 NewNodeIndex = PrefixTrie.AddDefaulted();
+				PrefixTrie[NodeIndex].Children.Add(FName(*Component), NewNodeIndex);
+				NodeIndex = NewNodeIndex;
+			}
+
+			PrefixTrie[NodeIndex].bExcluded = true;
+		}
+	}
+
+	FRWScopeLock ScopeLock(CacheLock, SLT_Write);
+	FolderCache.Reset();
+}
+
+bool FPathExclusionRules::IsPathExcluded(FName PackagePath) const
+{
+	{
+		FRWScopeLock ScopeLock(CacheLock, SLT_ReadOnly);
+
+		if (const bool* bCachedResult = FolderCache.Find(PackagePath))
+		{
+			return *bCachedResult;
+		}
+	}
+
+	// first asset of this folder
+	const bool bExcluded = MatchRules(PackagePath.ToString());
+
+	FRWScopeLock ScopeLock(CacheLock, SLT_Write);
+	FolderCache.Add(PackagePath, bExcluded);
+
+	return bExcluded;
+}
+
+bool FPathExclusionRules::MatchRules(const FString& PackagePath) const
+{
+	FRWScopeLock ScopeLock(RulesLock, SLT_ReadOnly);
+
+	TArray<FString> Components;
+	PackagePath.ParseIntoArray(Components, TEXT("/"));
+
+	int32 NodeIndex = 0;
+
+	for (const FString& Component : Components)
+	{
+		const FName ComponentName(*Component);
+
+		if (ExcludedFolderNames.Contains(ComponentName)) return true;
+
+		for (const FString& Pattern : FolderNamePatterns)
+		{
+			if (Component.MatchesWildcard(Pattern)) return true;
+		}
+
+		if (NodeIndex != INDEX_NONE)
+		{
+			const int32* ChildIndex = PrefixTrie[NodeIndex].Children.Find(ComponentName);
+			NodeIndex = ChildIndex ? *ChildIndex : INDEX_NONE;
+
+			if (NodeIndex != INDEX_NONE && PrefixTrie[NodeIndex].bExcluded) return true;
+		}
+	}
+
+	for (const FString& Pattern : PathPatterns)
+	{
+		// the folder itself or anything below it
+		if (PackagePath.MatchesWildcard(Pattern) || PackagePath.MatchesWildcard(Pattern + TEXT("/*"))) return true;
+	}
+
+	return false;
+}
+
+void FPathExclusionRules::OnSettingChanged(UObject* Settings, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Compile(UBacgroundToolsSettings::Get()->ExcludedPaths);
+}
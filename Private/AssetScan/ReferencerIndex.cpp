@@ -0,0 +1,684 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/ReferencerIndex.h"
+#include "AssetScan/AssetReachability.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Async/Async.h"
+#include "Serialization/Archive.h"
+
+namespace ReferencerIndexCache
+{
+	constexpr uint32 Magic = 0x49524742; // "BGRI"
+
+	// bump when the layout changes, older files are ignored
+	constexpr int32 Version = 1;
+}
+
+void FReferencerIndex::Initialize()
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FReferencerIndex::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FReferencerIndex::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FReferencerIndex::OnAssetRenamed);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FReferencerIndex::OnAssetUpdated);
+	FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FReferencerIndex::OnFilesLoaded);
+}
+
+void FReferencerIndex::Shutdown()
+{
+	if (WarmUpFuture.IsValid())
+	{
+		WarmUpFuture.Wait();
+	}
+
+	// keeps the changes applied during the session for the next one
+	{
+		FScopeLock ScopeLock(&IndexLock);
+
+		if (bIsBuilt && bIsCacheDirty)
+		{
+			SaveCache();
+		}
+	}
+
+	// The asset registry can already be gone when the editor is shutting down
+	if (FAssetRegistryModule* AssetRegistryModule =
+		FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+		AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+	}
+
+	Invalidate();
+}
+
+int32 FReferencerIndex::GetReferencerCount(FName PackageName)
+{
+	FScopeLock ScopeLock(&IndexLock);
+
+	EnsureUpToDate();
+
+	const int32* Count = ReferencerCounts.Find(PackageName);
+
+	return Count ? *Count : 0;
+}
+
+bool FReferencerIndex::TryGetReferencerCounts(TArrayView<const FName> PackageNames, TArrayView<int32> OutCounts)
+{
+	check(IsInGameThread());
+	check(PackageNames.Num() == OutCounts.Num());
+
+	// held by a build on another thread, the game thread doesn't wait for it
+	if (IndexLock.TryLock())
+	{
+		bool bNeedsBuild = !bIsBuilt;
+		{
+			FScopeLock PendingScopeLock(&PendingLock);
+			bNeedsBuild |= bRebuildRequested;
+		}
+
+		if (!bNeedsBuild)
+		{
+			// only the packages touched by registry events since the last query
+			EnsureUpToDate();
+
+			for (int32 i = 0; i < PackageNames.Num(); ++i)
+			{
+				const int32* Count = ReferencerCounts.Find(PackageNames[i]);
+				OutCounts[i] = Count ? *Count : 0;
+			}
+		}
+
+		IndexLock.Unlock();
+
+		if (!bNeedsBuild) return true;
+	}
+
+	StartBackgroundUpdate();
+	return false;
+}
+
+void FReferencerIndex::GetUnusedAssets(TArrayView<const FAssetData> Candidates, TArray<FAssetData>& OutUnusedAssets)
+{
+	FScopeLock ScopeLock(&IndexLock);
+
+	EnsureUpToDate();
+
+	for (const FAssetData& Candidate : Candidates)
+	{
+		const int32* Count = ReferencerCounts.Find(Candidate.PackageName);
+
+		if (!Count || *Count == 0)
+		{
+			OutUnusedAssets.Add(Candidate);
+		}
+	}
+}
+
+bool FReferencerIndex::GetUnreachableAssets(TArrayView<const FAssetData> Candidates, const FReachabilityRoots& Roots,
+	TArray<FAssetData>& OutUnreachableAssets, TArray<TArray<FName>>* OutCycles, const std::atomic<bool>* bCancelRequested)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FReferencerIndex::GetUnreachableAssets);
+
+	// the lock is only held for the snapshot, the search runs on the copy
+	FPackageDependencyGraph Graph;
+	GetDependencyGraph(Graph);
+
+	FAssetReachability Reachability(MoveTemp(Graph));
+
+	if (!Reachability.Compute(Roots, bCancelRequested)) return false;
+
+	for (const FAssetData& Candidate : Candidates)
+	{
+		if (!Reachability.IsReachable(Candidate.PackageName))
+		{
+			OutUnreachableAssets.Add(Candidate);
+		}
+	}
+
+	if (!OutCycles) return true;
+
+	if (bCancelRequested && *bCancelRequested) return false;
+
+	TArray<TArray<FName>> Cycles;
+	Reachability.FindUnreachableCycles(Cycles);
+
+	// the graph covers the whole project, only the cycles the caller asked about are kept
+	TSet<FName> CandidatePackages;
+	CandidatePackages.Reserve(Candidates.Num());
+	for (const FAssetData& Candidate : Candidates)
+	{
+		CandidatePackages.Add(Candidate.PackageName);
+	}
+
+	for (TArray<FName>& Cycle : Cycles)
+	{
+		if (Cycle.ContainsByPredicate([&CandidatePackages](FName PackageName) { return CandidatePackages.Contains(PackageName); }))
+		{
+			OutCycles->Add(MoveTemp(Cycle));
+		}
+	}
+
+	return true;
+}
+
+void FReferencerIndex::GetDependencyGraph(FPackageDependencyGraph& OutGraph)
+{
+	FScopeLock ScopeLock(&IndexLock);
+
+	EnsureUpToDate();
+
+	auto GetNodeIndex = [&OutGraph](FName PackageName)
+	{
+		if (const int32* NodeIndex = OutGraph.NodeIndices.Find(PackageName)) return *NodeIndex;
+
+		OutGraph.PackageNames.Add(PackageName);
+		return OutGraph.NodeIndices.Add(PackageName, OutGraph.PackageNames.Num() - 1);
+	};
+
+	OutGraph.PackageNames.Reserve(PackageSavedHashes.Num());
+	OutGraph.NodeIndices.Reserve(PackageSavedHashes.Num());
+
+	// every known package is a node, with or without edges
+	for (const TPair<FName, FIoHash>& Pair : PackageSavedHashes)
+	{
+		GetNodeIndex(Pair.Key);
+	}
+
+	int32 NumEdges = 0;
+	for (const TPair<FName, TArray<FName>>& Pair : PackageDependencies)
+	{
+		GetNodeIndex(Pair.Key);
+		NumEdges += Pair.Value.Num();
+
+		for (const FName& Dependency : Pair.Value)
+		{
+			GetNodeIndex(Dependency);
+		}
+	}
+
+	const int32 NumNodes = OutGraph.PackageNames.Num();
+
+	// count, prefix sum, fill
+	OutGraph.EdgeOffsets.SetNumZeroed(NumNodes + 1);
+	for (const TPair<FName, TArray<FName>>& Pair : PackageDependencies)
+	{
+		OutGraph.EdgeOffsets[OutGraph.NodeIndices.FindChecked(Pair.Key) + 1] = Pair.Value.Num();
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		OutGraph.EdgeOffsets[NodeIndex + 1] += OutGraph.EdgeOffsets[NodeIndex];
+	}
+
+	OutGraph.EdgeTargets.SetNumUninitialized(NumEdges);
+	for (const TPair<FName, TArray<FName>>& Pair : PackageDependencies)
+	{
+		int32 Edge = OutGraph.EdgeOffsets[OutGraph.NodeIndices.FindChecked(Pair.Key)];
+
+		for (const FName& Dependency : Pair.Value)
+		{
+			OutGraph.EdgeTargets[Edge++] = OutGraph.NodeIndices.FindChecked(Dependency);
+		}
+	}
+}
+
+bool FReferencerIndex::Update(const std::atomic<bool>* bCancelRequested)
+{
+	FScopeLock ScopeLock(&IndexLock);
+
+	return EnsureUpToDate(bCancelRequested);
+}
+
+void FReferencerIndex::Invalidate()
+{
+	FScopeLock ScopeLock(&IndexLock);
+
+	PackageDependencies.Empty();
+	ReferencerCounts.Empty();
+	PackageSavedHashes.Empty();
+	bIsBuilt = false;
+	bIsCacheDirty = false;
+
+	FScopeLock PendingScopeLock(&PendingLock);
+	PendingPackages.Empty();
+	bTrackEvents = false;
+	bRebuildRequested = false;
+}
+
+bool FReferencerIndex::EnsureUpToDate(const std::atomic<bool>* bCancelRequested)
+{
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TSet<FName> PackagesToRefresh;
+	{
+		FScopeLock PendingScopeLock(&PendingLock);
+
+		if (bRebuildRequested)
+		{
+			bRebuildRequested = false;
+			bIsBuilt = false;
+		}
+
+		PackagesToRefresh = MoveTemp(PendingPackages);
+		PendingPackages.Reset();
+	}
+
+	if (!bIsBuilt)
+	{
+		return Rebuild(AssetRegistry, bCancelRequested);
+	}
+
+	for (const FName& PackageName : PackagesToRefresh)
+	{
+		RefreshPackage(AssetRegistry, PackageName);
+	}
+
+	return true;
+}
+
+void FReferencerIndex::StartBackgroundUpdate()
+{
+	check(IsInGameThread());
+
+	if (WarmUpFuture.IsValid() && !WarmUpFuture.IsReady()) return;
+
+	WarmUpFuture = Async(EAsyncExecution::ThreadPool, [this]()
+	{
+		Update();
+	});
+}
+
+bool FReferencerIndex::Rebuild(IAssetRegistry& AssetRegistry, const std::atomic<bool>* bCancelRequested)
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("ReferencerIndexRebuild");
+
+	// Dependencies of the previous build, or of the previous session, stay valid for packages not saved since
+	TMap<FName, FIoHash> PreviousSavedHashes = MoveTemp(PackageSavedHashes);
+	TMap<FName, TArray<FName>> PreviousDependencies = MoveTemp(PackageDependencies);
+
+	if (PreviousSavedHashes.Num() == 0)
+	{
+		PreviousDependencies.Reset();
+		LoadCache(PreviousSavedHashes, PreviousDependencies);
+	}
+
+	PackageSavedHashes.Reset();
+	PackageDependencies.Reset();
+	ReferencerCounts.Reset();
+
+	// Start tracking before the snapshot so changes made during the build get applied afterwards
+	{
+		FScopeLock PendingScopeLock(&PendingLock);
+		PendingPackages.Reset();
+		bTrackEvents = true;
+	}
+
+	PackageSavedHashes.Reserve(PreviousSavedHashes.Num());
+	PackageDependencies.Reserve(PreviousDependencies.Num());
+	ReferencerCounts.Reserve(PreviousSavedHashes.Num());
+
+	// Registry calls can't be made from inside the enumeration, changed packages are queried after it
+	TArray<FName> ChangedPackages;
+
+	AssetRegistry.EnumerateAllPackages([this, &PreviousSavedHashes, &PreviousDependencies, &ChangedPackages]
+		(FName PackageName, const FAssetPackageData& PackageData)
+	{
+		const FIoHash& SavedHash = PackageData.GetPackageSavedHash();
+		PackageSavedHashes.Add(PackageName, SavedHash);
+
+		const FIoHash* PreviousSavedHash = PreviousSavedHashes.Find(PackageName);
+
+		if (!SavedHash.IsZero() && PreviousSavedHash && *PreviousSavedHash == SavedHash)
+		{
+			// packages without dependencies have no entry
+			if (TArray<FName>* Dependencies = PreviousDependencies.Find(PackageName))
+			{
+				AddDependencies(PackageName, MoveTemp(*Dependencies));
+			}
+			return;
+		}
+
+		ChangedPackages.Add(PackageName);
+	});
+
+	FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, PackageSavedHashes.Num());
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries, ChangedPackages.Num() + 1);
+
+	// Referencer counts are summed from forward edges, the dependents of a changed package need no re-query
+	for (int32 i = 0; i < ChangedPackages.Num(); ++i)
+	{
+		if (bCancelRequested && *bCancelRequested)
+		{
+			// packages not queried yet are forgotten so the next build queries them instead of taking them as unchanged
+			for (int32 j = i; j < ChangedPackages.Num(); ++j)
+			{
+				PackageSavedHashes.Remove(ChangedPackages[j]);
+			}
+			return false;
+		}
+
+		const FName PackageName = ChangedPackages[i];
+
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package);
+
+		AddDependencies(PackageName, MoveTemp(Dependencies));
+	}
+
+	bIsBuilt = true;
+	bIsCacheDirty = false;
+
+	if (ChangedPackages.Num() > 0 || PreviousSavedHashes.Num() != PackageSavedHashes.Num())
+	{
+		SaveCache();
+	}
+
+	return true;
+}
+
+void FReferencerIndex::RefreshPackage(IAssetRegistry& AssetRegistry, FName PackageName)
+{
+	RemoveDependencies(PackageName);
+	PackageSavedHashes.Remove(PackageName);
+	bIsCacheDirty = true;
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries, 2);
+
+	TArray<FName> Dependencies;
+	if (AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package))
+	{
+		AddDependencies(PackageName, MoveTemp(Dependencies));
+	}
+
+	// unsaved packages keep no hash, they are queried again next session
+	if (TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName))
+	{
+		PackageSavedHashes.Add(PackageName, PackageData->GetPackageSavedHash());
+	}
+}
+
+void FReferencerIndex::AddDependencies(FName PackageName, TArray<FName>&& Dependencies)
+{
+	// A package referencing the same dependency twice still counts as one referencer
+	Dependencies.Sort(FNameFastLess());
+
+	int32 UniqueNum = 0;
+	for (int32 i = 0; i < Dependencies.Num(); ++i)
+	{
+		const FName Dependency = Dependencies[i];
+
+		if (Dependency == PackageName) continue;
+		if (UniqueNum > 0 && Dependencies[UniqueNum - 1] == Dependency) continue;
+
+		Dependencies[UniqueNum++] = Dependency;
+		++ReferencerCounts.FindOrAdd(Dependency);
+	}
+	Dependencies.SetNum(UniqueNum);
+
+	if (UniqueNum > 0)
+	{
+		PackageDependencies.Add(PackageName, MoveTemp(Dependencies));
+	}
+}
+
+void FReferencerIndex::RemoveDependencies(FName PackageName)
+{
+	TArray<FName> OldDependencies;
+	if (!PackageDependencies.RemoveAndCopyValue(PackageName, OldDependencies)) return;
+
+	for (const FName& Dependency : OldDependencies)
+	{
+		if (int32* Count = ReferencerCounts.Find(Dependency))
+		{
+			if (--(*Count) <= 0)
+			{
+				ReferencerCounts.Remove(Dependency);
+			}
+		}
+	}
+}
+
+#pragma region PersistentCache
+
+FString FReferencerIndex::GetCacheFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("BacgroundTools") / TEXT("ReferencerIndex.bin");
+}
+
+bool FReferencerIndex::LoadCache(TMap<FName, FIoHash>& OutSavedHashes, TMap<FName, TArray<FName>>& OutDependencies) const
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*GetCacheFilename()));
+
+	if (!Reader) return false;
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*Reader << Magic << Version;
+
+	if (Magic != ReferencerIndexCache::Magic || Version != ReferencerIndexCache::Version) return false;
+
+	// every package name is stored once, entries refer to it by index
+	int32 NumNames = 0;
+	*Reader << NumNames;
+
+	if (Reader->IsError() || NumNames < 0) return false;
+
+	TArray<FName> Names;
+	Names.Reserve(NumNames);
+
+	for (int32 i = 0; i < NumNames; ++i)
+	{
+		FString Name;
+		*Reader << Name;
+		Names.Add(FName(*Name));
+	}
+
+	int32 NumPackages = 0;
+	*Reader << NumPackages;
+
+	if (Reader->IsError() || NumPackages < 0) return false;
+
+	OutSavedHashes.Reserve(NumPackages);
+
+	for (int32 i = 0; i < NumPackages && !Reader->IsError(); ++i)
+	{
+		int32 NameIndex = INDEX_NONE;
+		FIoHash SavedHash;
+		int32 NumDependencies = 0;
+		*Reader << NameIndex << SavedHash << NumDependencies;
+
+		if (!Names.IsValidIndex(NameIndex) || NumDependencies < 0 || NumDependencies > NumNames) break;
+
+		OutSavedHashes.Add(Names[NameIndex], SavedHash);
+
+		if (NumDependencies == 0) continue;
+
+		TArray<FName>& Dependencies = OutDependencies.Add(Names[NameIndex]);
+		Dependencies.Reserve(NumDependencies);
+
+		for (int32 j = 0; j < NumDependencies; ++j)
+		{
+			int32 DependencyIndex = INDEX_NONE;
+			*Reader << DependencyIndex;
+
+			if (Names.IsValidIndex(DependencyIndex))
+			{
+				Dependencies.Add(Names[DependencyIndex]);
+			}
+		}
+	}
+
+	// a truncated file is worth nothing, everything is queried again
+	if (Reader->IsError() || OutSavedHashes.Num() != NumPackages)
+	{
+		OutSavedHashes.Reset();
+		OutDependencies.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FReferencerIndex::SaveCache() const
+{
+	TMap<FName, int32> NameIndices;
+	TArray<FString> Names;
+
+	auto GetNameIndex = [&NameIndices, &Names](FName Name)
+	{
+		if (const int32* NameIndex = NameIndices.Find(Name)) return *NameIndex;
+
+		Names.Add(Name.ToString());
+		return NameIndices.Add(Name, Names.Num() - 1);
+	};
+
+	struct FCacheEntry
+	{
+		int32 NameIndex;
+		FIoHash SavedHash;
+		TArray<int32> DependencyIndices;
+	};
+
+	TArray<FCacheEntry> Entries;
+	Entries.Reserve(PackageSavedHashes.Num());
+
+	for (const TPair<FName, FIoHash>& Pair : PackageSavedHashes)
+	{
+		// not saved yet, nothing to key it by
+		if (Pair.Value.IsZero()) continue;
+
+		FCacheEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.NameIndex = GetNameIndex(Pair.Key);
+		Entry.SavedHash = Pair.Value;
+
+		if (const TArray<FName>* Dependencies = PackageDependencies.Find(Pair.Key))
+		{
+			Entry.DependencyIndices.Reserve(Dependencies->Num());
+			for (const FName& Dependency : *Dependencies)
+			{
+				Entry.DependencyIndices.Add(GetNameIndex(Dependency));
+			}
+		}
+	}
+
+	// written next to the cache and moved over it, a crash never leaves a half written cache
+	const FString Filename = GetCacheFilename();
+	const FString TempFilename = Filename + TEXT(".tmp");
+
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename));
+
+		if (!Writer) return;
+
+		uint32 Magic = ReferencerIndexCache::Magic;
+		int32 Version = ReferencerIndexCache::Version;
+		int32 NumNames = Names.Num();
+		*Writer << Magic << Version << NumNames;
+
+		for (FString& Name : Names)
+		{
+			*Writer << Name;
+		}
+
+		int32 NumPackages = Entries.Num();
+		*Writer << NumPackages;
+
+		for (FCacheEntry& Entry : Entries)
+		{
+			int32 NumDependencies = Entry.DependencyIndices.Num();
+			*Writer << Entry.NameIndex << Entry.SavedHash << NumDependencies;
+
+			for (int32& DependencyIndex : Entry.DependencyIndices)
+			{
+				*Writer << DependencyIndex;
+			}
+		}
+
+		if (!Writer->Close()) return;
+	}
+
+	IFileManager::Get().Move(*Filename, *TempFilename);
+}
+
+#pragma endregion
+
+#pragma region AssetRegistryEvents
+
+void FReferencerIndex::OnAssetAdded(const FAssetData& AssetData)
+{
+	FScopeLock PendingScopeLock(&PendingLock);
+
+	// Nothing to keep in sync before the first query builds the index
+	if (!bTrackEvents) return;
+
+	PendingPackages.Add(AssetData.PackageName);
+}
+
+void FReferencerIndex::OnAssetRemoved(const FAssetData& AssetData)
+{
+	FScopeLock PendingScopeLock(&PendingLock);
+
+	if (!bTrackEvents) return;
+
+	PendingPackages.Add(AssetData.PackageName);
+}
+
+void FReferencerIndex::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	{
+		FScopeLock PendingScopeLock(&PendingLock);
+		if (!bTrackEvents) return;
+	}
+
+	// Referencers fixed up by the rename point at the new package now
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FName> Referencers;
+	AssetRegistry.GetReferencers(AssetData.PackageName, Referencers, UE::AssetRegistry::EDependencyCategory::Package);
+
+	FScopeLock PendingScopeLock(&PendingLock);
+
+	PendingPackages.Add(AssetData.PackageName);
+	PendingPackages.Add(FName(*FPackageName::ObjectPathToPackageName(OldObjectPath)));
+	PendingPackages.Append(Referencers);
+}
+
+void FReferencerIndex::OnAssetUpdated(const FAssetData& AssetData)
+{
+	FScopeLock PendingScopeLock(&PendingLock);
+
+	if (!bTrackEvents) return;
+
+	PendingPackages.Add(AssetData.PackageName);
+}
+
+void FReferencerIndex::OnFilesLoaded()
+{
+	// Initial discovery is done, anything built before that is incomplete.
+	// Only flagged here so the game thread never waits on a build running in the background
+	{
+		FScopeLock PendingScopeLock(&PendingLock);
+
+		bRebuildRequested = true;
+	}
+
+	// Built from the saved cache right away, the first report doesn't pay for it
+	StartBackgroundUpdate();
+}
+
+#pragma endregion
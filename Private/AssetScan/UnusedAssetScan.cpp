@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetScan/UnusedAssetScan.h"
+#include "AssetScan/ReferencerIndex.h"
+#include "AssetScan/PathExclusionRules.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/Async.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "Framework/Notifications/NotificationManager.h"
+
+namespace UnusedAssetScan
+{
+	// assets checked between two cancel checks / progress updates
+	constexpr int32 ChunkSize = 2048;
+}
+
+FUnusedAssetScan::FUnusedAssetScan(const FFolderRootSet& InFolderRoots, FReferencerIndex& InReferencerIndex,
+	const FPathExclusionRules& InExclusionRules)
+	: FolderRoots(InFolderRoots)
+	, ReferencerIndex(InReferencerIndex)
+	, ExclusionRules(InExclusionRules)
+{
+}
+
+FUnusedAssetScan::FUnusedAssetScan(TArray<FAssetData>&& InCandidateAssets, FReferencerIndex& InReferencerIndex,
+	const FPathExclusionRules& InExclusionRules)
+	: CandidateAssets(MoveTemp(InCandidateAssets))
+	, bScanCandidateAssets(true)
+	, ReferencerIndex(InReferencerIndex)
+	, ExclusionRules(InExclusionRules)
+{
+}
+
+void FUnusedAssetScan::Start(const FOnUnusedAssetScanFinished& InOnFinished)
+{
+	check(IsInGameThread());
+
+	OnFinished = InOnFinished;
+	bCancelRequested = false;
+	bIsRunning = true;
+
+	// the asset manager and the settings are game thread only
+	bFindUnreachable = UBacgroundToolsSettings::Get()->bFindUnreachableAssets;
+	if (bFindUnreachable)
+	{
+		FAssetReachability::CollectRoots(Roots);
+	}
+
+	const FString ScanScope = bScanCandidateAssets ?
+		FString::Printf(TEXT("among %d selected assets"), CandidateAssets.Num()) : TEXT("under ") + FolderRoots.ToString();
+
+	FNotificationInfo NotifyInfo(FText::FromString(TEXT("Scanning unused assets ") + ScanScope));
+	NotifyInfo.bUseLargeFont = true;
+	NotifyInfo.bFireAndForget = false;
+	NotifyInfo.FadeOutDuration = 5.f;
+	NotifyInfo.ButtonDetails.Add(FNotificationButtonInfo(
+		FText::FromString(TEXT("Cancel")),
+		FText::FromString(TEXT("Stop scanning for unused assets")),
+		FSimpleDelegate::CreateSP(this, &FUnusedAssetScan::OnCancelButtonClicked),
+		SNotificationItem::CS_Pending));
+
+	ProgressNotification = FSlateNotificationManager::Get().AddNotification(NotifyInfo);
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	// The worker keeps the scan alive until it is done
+	TSharedRef<FUnusedAssetScan, ESPMode::ThreadSafe> ThisRef = AsShared();
+	WorkerFuture = Async(EAsyncExecution::ThreadPool, [ThisRef]()
+	{
+		ThisRef->Run();
+
+		// cleared once the worker is really done, whether Run finished or returned on a cancel
+		AsyncTask(ENamedThreads::GameThread, [ThisRef]()
+		{
+			ThisRef->bIsRunning = false;
+		});
+	});
+}
+
+void FUnusedAssetScan::Cancel()
+{
+	check(IsInGameThread());
+
+	bCancelRequested = true;
+	OnFinished.Unbind();
+
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetText(FText::FromString(TEXT("Unused asset scan cancelled")));
+		ProgressNotification->SetCompletionState(SNotificationItem::CS_Fail);
+		ProgressNotification->ExpireAndFadeout();
+		ProgressNotification.Reset();
+	}
+}
+
+void FUnusedAssetScan::CancelAndWait()
+{
+	Cancel();
+
+	if (WorkerFuture.IsValid())
+	{
+		WorkerFuture.Wait();
+	}
+}
+
+void FUnusedAssetScan::Run()
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("UnusedAssetScan");
+
+	TArray<FAssetData> AssetsDataArray;
+
+	if (bScanCandidateAssets)
+	{
+		AssetsDataArray = MoveTemp(CandidateAssets);
+	}
+	else
+	{
+		PostProgress(TEXT("Collecting assets under ") + FolderRoots.ToString());
+
+		// one query per merged root, run in parallel. the roots don't overlap so no asset is checked twice
+		FolderRoots.GetOnDiskAssets(ExclusionRules, AssetsDataArray);
+	}
+
+	if (bCancelRequested) return;
+
+	PostProgress(TEXT("Updating referencer index"));
+
+	// Builds the index if needed, otherwise only applies pending registry changes. a cancel stops a build between packages
+	if (!ReferencerIndex.Update(&bCancelRequested)) return;
+
+	TArray<FAssetData> UnusedAssetsDataArray;
+
+	if (bFindUnreachable)
+	{
+		PostProgress(TEXT("Searching assets reachable from the roots"));
+
+		// packages of a cycle only reference each other, reported together so they are deleted together
+		TArray<TArray<FName>> UnreachableCycles;
+		if (!ReferencerIndex.GetUnreachableAssets(AssetsDataArray, Roots, UnusedAssetsDataArray, &UnreachableCycles,
+			&bCancelRequested)) return;
+
+		PostFinished(MoveTemp(UnusedAssetsDataArray), MoveTemp(UnreachableCycles));
+		return;
+	}
+
+	for (int32 ChunkStart = 0; ChunkStart < AssetsDataArray.Num(); ChunkStart += UnusedAssetScan::ChunkSize)
+	{
+		if (bCancelRequested) return;
+
+		const int32 ChunkEnd = FMath::Min(ChunkStart + UnusedAssetScan::ChunkSize, AssetsDataArray.Num());
+
+		ReferencerIndex.GetUnusedAssets(
+			MakeArrayView(AssetsDataArray.GetData() + ChunkStart, ChunkEnd - ChunkStart), UnusedAssetsDataArray);
+
+		PostProgress(FString::Printf(TEXT("Checked %d / %d assets"), ChunkEnd, AssetsDataArray.Num()));
+	}
+
+	PostFinished(MoveTemp(UnusedAssetsDataArray));
+}
+
+void FUnusedAssetScan::PostProgress(const FString& ProgressMessage)
+{
+	TSharedRef<FUnusedAssetScan, ESPMode::ThreadSafe> ThisRef = AsShared();
+
+	AsyncTask(ENamedThreads::GameThread, [ThisRef, ProgressMessage]()
+	{
+		if (ThisRef->bCancelRequested || !ThisRef->ProgressNotification.IsValid()) return;
+
+		ThisRef->ProgressNotification->SetText(FText::FromString(ProgressMessage));
+	});
+}
+
+void FUnusedAssetScan::PostFinished(TArray<FAssetData>&& UnusedAssets, TArray<TArray<FName>>&& UnreachableCycles)
+{
+	TSharedRef<FUnusedAssetScan, ESPMode::ThreadSafe> ThisRef = AsShared();
+
+	AsyncTask(ENamedThreads::GameThread,
+		[ThisRef, UnusedAssets = MoveTemp(UnusedAssets), UnreachableCycles = MoveTemp(UnreachableCycles)]()
+	{
+		// Cancel() already closed the notification
+		if (ThisRef->bCancelRequested) return;
+
+		if (ThisRef->ProgressNotification.IsValid())
+		{
+			ThisRef->ProgressNotification->SetText(FText::FromString(
+				TEXT("Found ") + FString::FromInt(UnusedAssets.Num()) + TEXT(" unused assets")));
+			ThisRef->ProgressNotification->SetCompletionState(SNotificationItem::CS_Success);
+			ThisRef->ProgressNotification->ExpireAndFadeout();
+			ThisRef->ProgressNotification.Reset();
+		}
+
+		ThisRef->OnFinished.ExecuteIfBound(UnusedAssets, UnreachableCycles);
+	});
+}
+
+void FUnusedAssetScan::OnCancelButtonClicked()
+{
+	// bIsRunning stays set until the worker notices and returns
+	Cancel();
+}
@@ -2,13 +2,19 @@
 
 #include "BacgroundTools.h"
 #include "ContentBrowserModule.h"
-#include "EditorAssetLibrary.h"
-#include "ObjectTools.h"
 #include "Debug.h"
+#include "Profiling/OperationProfiler.h"
 #include "AssetToolsModule.h"
 #include "AssetViewUtils.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetScan/EmptyFolderTree.h"
 #include "SlateWidgets/AdvanceDeletionWidget.h"
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+#include "SlateWidgets/NamingAuditWidget.h"
+#include "SlateWidgets/DuplicateContentWidget.h"
+#include "SlateWidgets/DeletionPreviewWidget.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "Async/Async.h"
 
 #define LOCTEXT_NAMESPACE "FBacgroundToolsModule"
 
@@ -18,6 +24,25 @@ void FBacgroundToolsModule::StartupModule()
 	InitCBMenuExtention();
 
 	RegisterAdvanceDeletionTab();
+
+	RegisterNamingAuditTab();
+
+	RegisterDuplicateContentTab();
+
+	RegisterDeletionPreviewTab();
+
+	ReferencerIndex.Initialize();
+
+	RedirectorFixUpService.Initialize();
+
+	AssetDeletionQueue.Initialize(RedirectorFixUpService);
+	AssetDeletionQueue.OnPreviewRequested.BindRaw(this, &FBacgroundToolsModule::OnDeletionPreviewRequested);
+
+	PrefixTable.Initialize();
+
+	PathExclusionRules.Initialize();
+
+	AssetSizeCache.Initialize();
 }
 
 #pragma region ContentBrowserMenuExtention
@@ -52,7 +77,7 @@ TSharedRef<FExtender> FBacgroundToolsModule::CustomCBMenuExtender(const TArray<F
 			TSharedPtr<FUICommandList>(),
 			FMenuExtensionDelegate::CreateRaw(this, &FBacgroundToolsModule::AddCBMenuEntry));
 
-		SelectedFolderPaths = SelectedPaths;
+		SelectedFolderRoots = FFolderRootSet(SelectedPaths);
 	}
 
 	return  MenuExtender;
@@ -64,7 +89,7 @@ void FBacgroundToolsModule::AddCBMenuEntry(FMenuBuilder& MenuBuilder)
 	MenuBuilder.AddMenuEntry
 	(
 		FText::FromString(TEXT("Delete Unused Assets")), // title
-		FText::FromString(TEXT("Safely delete all unused assets under folder")), // tooltip
+		FText::FromString(TEXT("Safely delete all unused assets under the selected folders")), // tooltip
 		FSlateIcon(),
 		FExecuteAction::CreateRaw(this, &FBacgroundToolsModule::OnDeleteUnsuedAssetButtonClicked)
 	);
@@ -84,121 +109,168 @@ void FBacgroundToolsModule::AddCBMenuEntry(FMenuBuilder& MenuBuilder)
 		FSlateIcon(),
 		FExecuteAction::CreateRaw(this, &FBacgroundToolsModule::OnAdvancedDeletionButtonClicked)
 	);
+
+	MenuBuilder.AddMenuEntry
+	(
+		FText::FromString(TEXT("Naming Audit")), // title
+		FText::FromString(TEXT("List misnamed assets under folder and fix their prefixes in one batch")), // tooltip
+		FSlateIcon(),
+		FExecuteAction::CreateRaw(this, &FBacgroundToolsModule::OnNamingAuditButtonClicked)
+	);
+
+	MenuBuilder.AddMenuEntry
+	(
+		FText::FromString(TEXT("Find Duplicate Content")), // title
+		FText::FromString(TEXT("Hash the package files under folder and list the assets sharing their content")), // tooltip
+		FSlateIcon(),
+		FExecuteAction::CreateRaw(this, &FBacgroundToolsModule::OnFindDuplicateContentButtonClicked)
+	);
 }
 
 void FBacgroundToolsModule::OnDeleteUnsuedAssetButtonClicked()
 {
-	if (SelectedFolderPaths.Num() > 1)
+	if (ActiveUnusedAssetScan.IsValid() && ActiveUnusedAssetScan->IsRunning())
 	{
-		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("You can only do this to one folder"));
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("An unused asset scan is already running"));
 		return;
 	}
 
-	/*Debug::PrintMessage(TEXT("Currently selected folder: ") + SelectedFolderPaths[0], FColor::Green);*/
-
-	TArray<FString> AssetsPathNames = UEditorAssetLibrary::ListAssets(SelectedFolderPaths[0]);
-
-	if (AssetsPathNames.Num() == 0)
-	{
-		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No asset found under selected folder"));
-		return;
-	}
-
-
 	EAppReturnType::Type ConfirmResult =
 		Debug::ShowMsgDialog(
 			EAppMsgType::YesNo,
-			TEXT("A total of ") + FString::FromInt(AssetsPathNames.Num()) +
-			TEXT(" assets need to be checked.\n Would you like to proceed?")
+			TEXT("All assets under ") + SelectedFolderRoots.ToString() +
+			TEXT(" will be checked in the background.\n Would you like to proceed?")
 		);
 
 	if (ConfirmResult == EAppReturnType::No) return;
 
-	FixUpRedirectors();
+	// loads redirector packages, has to stay on the game thread
+	RedirectorFixUpService.FixUpRedirectorsUnderRoots(SelectedFolderRoots);
 
-	TArray<FAssetData> UnusedAssetsDataArray;
+	ActiveUnusedAssetScan = MakeShared<FUnusedAssetScan, ESPMode::ThreadSafe>(SelectedFolderRoots, ReferencerIndex,
+		PathExclusionRules);
+	ActiveUnusedAssetScan->Start(FOnUnusedAssetScanFinished::CreateRaw(this, &FBacgroundToolsModule::OnUnusedAssetScanFinished,
+		FString(TEXT("No unused asset found under selected folders"))));
+}
 
-	for (const FString& AssetPathName : AssetsPathNames)
+void FBacgroundToolsModule::StartUnusedAssetScan(TArray<FAssetData>&& Assets)
+{
+	if (ActiveUnusedAssetScan.IsValid() && ActiveUnusedAssetScan->IsRunning())
 	{
-		if (AssetPathName.Contains(TEXT("Developers")) || AssetPathName.Contains(TEXT("Collections")))
-			continue;
-		if (!UEditorAssetLibrary::DoesAssetExist(AssetPathName))
-			continue;
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("An unused asset scan is already running"));
+		return;
+	}
 
-		TArray<FString> AssetReferancers =
-			UEditorAssetLibrary::FindPackageReferencersForAsset(AssetPathName);
+	ActiveUnusedAssetScan = MakeShared<FUnusedAssetScan, ESPMode::ThreadSafe>(MoveTemp(Assets), ReferencerIndex,
+		PathExclusionRules);
+	ActiveUnusedAssetScan->Start(FOnUnusedAssetScanFinished::CreateRaw(this, &FBacgroundToolsModule::OnUnusedAssetScanFinished,
+		FString(TEXT("No unused asset found among selected assets"))));
+}
 
-		if (AssetReferancers.Num() == 0)
-		{
-			const FAssetData UnusedAssetData = UEditorAssetLibrary::FindAssetData(AssetPathName);
-			UnusedAssetsDataArray.Add(UnusedAssetData);
-		}
+void FBacgroundToolsModule::OnUnusedAssetScanFinished(const TArray<FAssetData>& UnusedAssetsDataArray,
+	const TArray<TArray<FName>>& UnreachableCycles, FString NothingFoundMessage)
+{
+	ActiveUnusedAssetScan.Reset();
+
+	// assets only referenced by each other, nothing in the cycle keeps the others alive
+	for (const TArray<FName>& Cycle : UnreachableCycles)
+	{
+		Debug::PrintLog(TEXT("Unreachable reference cycle: ") +
+			FString::JoinBy(Cycle, TEXT(", "), [](FName PackageName) { return PackageName.ToString(); }));
+	}
+
+	if (UnreachableCycles.Num() > 0)
+	{
+		Debug::ShowNotifyInfo(FString::Printf(TEXT("%d unused asset cycles found, see the output log"), UnreachableCycles.Num()));
 	}
 
 	if (UnusedAssetsDataArray.Num() > 0)
 	{
-		ObjectTools::DeleteAssets(UnusedAssetsDataArray);
+		DeleteMultipleAssetsForAssetList(UnusedAssetsDataArray);
 	}
 	else
 	{
-		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No unused asset found under selected folder"));
+		Debug::ShowMsgDialog(EAppMsgType::Ok, NothingFoundMessage);
 	}
 }
 
 void FBacgroundToolsModule::OnDeleteEmptyFoldersButtonClicked()
 {
-	FixUpRedirectors();
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
 
-	TArray<FString> FolderPathsArray;
-	FolderPathsArray.Add(SelectedFolderPaths[0]); // ڱ ڽ  ߰
-	
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	
-	TArray<FString> SubFolders;
-	AssetRegistryModule.Get().GetSubPaths(SelectedFolderPaths[0], SubFolders, true);
-	FolderPathsArray.Append(SubFolders); //    
-	
-	int32 Counter = 0;
-	FString EmptyFolderPathsNames;
-	TArray<FString> EmptyFoldersPathsArray;
+	// folders whose assets aren't discovered yet look empty
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("The asset registry is still discovering assets, try again once it has finished"));
+		return;
+	}
 
-	for (const FString& FolderPath : FolderPathsArray)
+	FEmptyFolderTree EmptyFolderTree;
+
+	// the confirmation is kept out of both profiles
 	{
-		if (FolderPath.Contains(TEXT("Developers")) || FolderPath.Contains(TEXT("Collections")))
-			continue;
-		if (!UEditorAssetLibrary::DoesDirectoryExist(FolderPath))
-			continue;
-		if (!UEditorAssetLibrary::DoesDirectoryHaveAssets(FolderPath))
-		{
-			EmptyFolderPathsNames.Append(FolderPath);
-			EmptyFolderPathsNames.Append(TEXT("\n"));
+		BACGROUNDTOOLS_PROFILE_OPERATION("FindEmptyFolders");
 
-			EmptyFoldersPathsArray.Add(FolderPath);
-		}
+		// folders holding only redirectors are not empty until those are fixed up
+		RedirectorFixUpService.FixUpRedirectorsUnderRoots(SelectedFolderRoots);
+
+		// every merged root with its subfolders, a folder is never listed twice
+		TArray<FString> FolderPathsArray;
+		SelectedFolderRoots.GetFolderPaths(FolderPathsArray);
+
+		// asset counts summed bottom-up in one pass, only the top of each empty subtree is kept
+		EmptyFolderTree.Build(FolderPathsArray, PathExclusionRules);
 	}
 
-	if (EmptyFoldersPathsArray.Num() == 0)
+	const TArray<FEmptyFolderTree::FEmptySubtree>& EmptySubtrees = EmptyFolderTree.GetEmptySubtrees();
+
+	if (EmptySubtrees.Num() == 0)
 	{
-		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No empty folder found under selected folder"), false);
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No empty folder found under selected folders"), false);
 		return;
 	}
 
+	constexpr int32 MaxListedFolders = 30;
+
+	FString EmptyFolderPathsNames;
+	for (int32 i = 0; i < FMath::Min(EmptySubtrees.Num(), MaxListedFolders); ++i)
+	{
+		EmptyFolderPathsNames.Append(EmptySubtrees[i].FolderPath);
+		EmptyFolderPathsNames.Append(TEXT("\n"));
+	}
+
+	if (EmptySubtrees.Num() > MaxListedFolders)
+	{
+		EmptyFolderPathsNames.Append(FString::Printf(TEXT("... and %d more\n"), EmptySubtrees.Num() - MaxListedFolders));
+	}
+
 	EAppReturnType::Type ConfirmResult = Debug::ShowMsgDialog(EAppMsgType::OkCancel,
-		TEXT("Empty folders found in:\n") + EmptyFolderPathsNames + TEXT("\nWould you like to delete all?"), false);
+		FString::Printf(TEXT("%d empty folders found in:\n"), EmptyFolderTree.GetNumEmptyFolders()) +
+		EmptyFolderPathsNames + TEXT("\nWould you like to delete all?"), false);
 
 	if (ConfirmResult == EAppReturnType::Cancel) return;
 
-	for (const FString& EmptyFolderPath : EmptyFoldersPathsArray)
+	BACGROUNDTOOLS_PROFILE_OPERATION("DeleteEmptyFolders");
+
+	// one recursive delete per empty subtree, subfolders go along with their topmost empty parent
+	int32 Counter = 0;
+
+	for (const FEmptyFolderTree::FEmptySubtree& EmptySubtree : EmptySubtrees)
 	{
-		if (UEditorAssetLibrary::DeleteDirectory(EmptyFolderPath))
-			++Counter;
+		if (FEmptyFolderTree::DeleteEmptySubtree(EmptySubtree))
+		{
+			Counter += EmptySubtree.NumFolders;
+		}
 		else
-			Debug::PrintMessage(TEXT("Failed to delete " + EmptyFolderPath), FColor::Red);
+		{
+			Debug::PrintMessage(TEXT("Failed to delete ") + EmptySubtree.FolderPath, FColor::Red);
+		}
 	}
 
 	if (Counter > 0)
 	{
-		Debug::ShowNotifyInfo(TEXT("Successfully deleted ") + FString::FromInt(Counter) + TEXT("folders"));
+		Debug::ShowNotifyInfo(TEXT("Successfully deleted ") + FString::FromInt(Counter) + TEXT(" folders"));
 	}
 
 }
@@ -208,47 +280,55 @@ void FBacgroundToolsModule::OnAdvancedDeletionButtonClicked()
 	FGlobalTabmanager::Get()->TryInvokeTab(FName("AdvanceDeletion"));
 }
 
-void FBacgroundToolsModule::FixUpRedirectors()
+void FBacgroundToolsModule::OnNamingAuditButtonClicked()
 {
-	IAssetRegistry& AssetRegistry =
-		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
-
-	FARFilter Filter;
-	Filter.bRecursivePaths = true;
-	Filter.PackagePaths.Emplace(FName("/Game"));
-	Filter.ClassPaths.Add(UObjectRedirector::StaticClass()->GetClassPathName());
+	FGlobalTabmanager::Get()->TryInvokeTab(FName("NamingAudit"));
+}
 
-	TArray<FAssetData> AssetList;
-	AssetRegistry.GetAssets(Filter, AssetList);
+void FBacgroundToolsModule::OnFindDuplicateContentButtonClicked()
+{
+	StartDuplicateContentScan(SelectedFolderRoots);
+}
 
-	if (AssetList.Num() == 0) return;
+void FBacgroundToolsModule::StartDuplicateContentScan(const FFolderRootSet& FolderRoots)
+{
+	// a tab restored with the editor layout has no folder yet
+	if (FolderRoots.IsEmpty()) return;
 
-	TArray<FString> ObjectPaths;
-	for (const FAssetData& Asset : AssetList)
+	if (ActiveDuplicateContentScan.IsValid() && ActiveDuplicateContentScan->IsRunning())
 	{
-		ObjectPaths.Add(Asset.GetObjectPathString());
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("A duplicate content scan is already running"));
+		return;
 	}
 
-	TArray<UObject*> Objects;
-	AssetViewUtils::FLoadAssetsSettings Settings;
-	Settings.bFollowRedirectors = false;
-	Settings.bAllowCancel = true;
+	DuplicateContentFolderRoots = FolderRoots;
+
+	ActiveDuplicateContentScan = MakeShared<FDuplicateContentScan, ESPMode::ThreadSafe>(FolderRoots, ReferencerIndex,
+		PathExclusionRules);
+	ActiveDuplicateContentScan->Start(
+		FOnDuplicateContentScanFinished::CreateRaw(this, &FBacgroundToolsModule::OnDuplicateContentScanFinished));
+}
+
+void FBacgroundToolsModule::OnDuplicateContentScanFinished(const TArray<FDuplicateContentGroup>& Groups)
+{
+	ActiveDuplicateContentScan.Reset();
 
-	AssetViewUtils::ELoadAssetsResult Result = AssetViewUtils::LoadAssetsIfNeeded(ObjectPaths, Objects, Settings);
+	DuplicateContentGroups = MakeShared<TArray<FDuplicateContentGroup>>(Groups);
 
-	if (Result != AssetViewUtils::ELoadAssetsResult::Cancelled)
+	// an open tab shows the new result, a rescan with nothing left empties it
+	if (TSharedPtr<SDuplicateContentTab> PinnedTab = DuplicateContentTab.Pin())
 	{
-		// Transform Objects array to ObjectRedirectors array
-		TArray<UObjectRedirector*> Redirectors;
-		for (UObject* Object : Objects)
-		{
-			Redirectors.Add(CastChecked<UObjectRedirector>(Object));
-		}
+		PinnedTab->SetGroups(DuplicateContentFolderRoots, DuplicateContentGroups);
+		return;
+	}
 
-		// Load the asset tools module
-		FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
-		AssetToolsModule.Get().FixupReferencers(Redirectors);
+	if (Groups.Num() == 0)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No duplicate content found under selected folders"));
+		return;
 	}
+
+	FGlobalTabmanager::Get()->TryInvokeTab(FName("DuplicateContent"));
 }
 
 #pragma endregion
@@ -268,29 +348,156 @@ TSharedRef<SDockTab> FBacgroundToolsModule::OnSpawnAdvanceDeletionTab(const FSpa
 		SNew(SDockTab).TabRole(ETabRole::NomadTab)
 		[
 			SNew(SAdvanceDeletionTab)
-				.AssetsDataToStore(GetAllAssetData())
+				.AssetListModel(MakeShared<FAdvanceDeletionListModel>(SelectedFolderRoots, GetAllAssetRecords()))
+		];
+}
+
+void FBacgroundToolsModule::RegisterNamingAuditTab()
+{
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(FName("NamingAudit"),
+		FOnSpawnTab::CreateRaw(this, &FBacgroundToolsModule::OnSpawnNamingAuditTab))
+		.SetDisplayName(FText::FromString(TEXT("Naming Audit")));
+}
+
+TSharedRef<SDockTab> FBacgroundToolsModule::OnSpawnNamingAuditTab(const FSpawnTabArgs& SpawnTabArgs)
+{
+	return
+		SNew(SDockTab).TabRole(ETabRole::NomadTab)
+		[
+			SNew(SNamingAuditTab)
+				.FolderRoots(SelectedFolderRoots)
 		];
 }
 
-TArray<TSharedPtr<FAssetData>> FBacgroundToolsModule::GetAllAssetData()
+void FBacgroundToolsModule::RegisterDuplicateContentTab()
 {
-	TArray< TSharedPtr <FAssetData> > AvailableAssetsData;
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(FName("DuplicateContent"),
+		FOnSpawnTab::CreateRaw(this, &FBacgroundToolsModule::OnSpawnDuplicateContentTab))
+		.SetDisplayName(FText::FromString(TEXT("Duplicate Content")));
+}
 
-	TArray<FString> AssetsPathNames = UEditorAssetLibrary::ListAssets(SelectedFolderPaths[0]);
+TSharedRef<SDockTab> FBacgroundToolsModule::OnSpawnDuplicateContentTab(const FSpawnTabArgs& SpawnTabArgs)
+{
+	TSharedRef<SDuplicateContentTab> Tab =
+		SNew(SDuplicateContentTab)
+			.FolderRoots(DuplicateContentFolderRoots)
+			.Groups(DuplicateContentGroups);
 
-	for (const FString& AssetPathName : AssetsPathNames)
+	DuplicateContentTab = Tab;
+
+	return
+		SNew(SDockTab).TabRole(ETabRole::NomadTab)
+		[
+			Tab
+		];
+}
+
+void FBacgroundToolsModule::RegisterDeletionPreviewTab()
+{
+	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(FName("DeletionPreview"),
+		FOnSpawnTab::CreateRaw(this, &FBacgroundToolsModule::OnSpawnDeletionPreviewTab))
+		.SetDisplayName(FText::FromString(TEXT("Deletion Preview")));
+}
+
+TSharedRef<SDockTab> FBacgroundToolsModule::OnSpawnDeletionPreviewTab(const FSpawnTabArgs& SpawnTabArgs)
+{
+	// the tab owns the preview from here, a tab restored with the layout later starts empty
+	TSharedRef<SDeletionPreviewTab> Tab =
+		SNew(SDeletionPreviewTab)
+			.Preview(PendingDeletionPreview);
+
+	PendingDeletionPreview.Reset();
+	DeletionPreviewTab = Tab;
+
+	return
+		SNew(SDockTab).TabRole(ETabRole::NomadTab)
+		[
+			Tab
+		];
+}
+
+void FBacgroundToolsModule::OnDeletionPreviewRequested(const TArray<FAssetData>& AssetsToDelete)
+{
+	const UBacgroundToolsSettings* Settings = UBacgroundToolsSettings::Get();
+
+	// a request made while the previous preview builds replaces it
+	TSharedPtr<FDeletionPreview> Preview = MakeShared<FDeletionPreview>();
+	BuildingDeletionPreview = Preview;
+
+	Debug::ShowNotifyInfo(FString::Printf(TEXT("Preparing the deletion preview of %d assets"), AssetsToDelete.Num()));
+
+	DeletionPreviewFutures.RemoveAll([](const TFuture<void>& Future) { return Future.IsReady(); });
+
+	// the snapshot waits for the referencer index, which may still be building
+	DeletionPreviewFutures.Add(Async(EAsyncExecution::ThreadPool,
+		[this, Preview, Assets = TArray<FAssetData>(AssetsToDelete), MaxDepth = Settings->PreviewGraphDepth,
+		MaxNodes = Settings->PreviewGraphMaxNodes]() mutable
 	{
-		if (AssetPathName.Contains(TEXT("Developers")) || AssetPathName.Contains(TEXT("Collections")))
-			continue;
-		if (!UEditorAssetLibrary::DoesAssetExist(AssetPathName))
-			continue;
-		
-		const FAssetData Data = UEditorAssetLibrary::FindAssetData(AssetPathName);
-
-		AvailableAssetsData.Add(MakeShared<FAssetData>(Data));
+		Preview->Build(MoveTemp(Assets), ReferencerIndex, AssetSizeCache, MaxDepth, MaxNodes);
+
+		AsyncTask(ENamedThreads::GameThread, [Preview]()
+		{
+			// the module may have shut down while the task was queued
+			FBacgroundToolsModule* Module = FModuleManager::GetModulePtr<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+			if (Module && Module->BuildingDeletionPreview == Preview)
+			{
+				Module->BuildingDeletionPreview.Reset();
+				Module->ShowDeletionPreview(Preview);
+			}
+		});
+	}));
+}
+
+void FBacgroundToolsModule::ShowDeletionPreview(const TSharedPtr<FDeletionPreview>& Preview)
+{
+	// an open tab switches to the new deletion, the one it showed is dropped
+	if (TSharedPtr<SDeletionPreviewTab> PinnedTab = DeletionPreviewTab.Pin())
+	{
+		PinnedTab->SetPreview(Preview);
+		FGlobalTabmanager::Get()->TryInvokeTab(FName("DeletionPreview"));
+		return;
 	}
 
-	return AvailableAssetsData;
+	PendingDeletionPreview = Preview;
+	FGlobalTabmanager::Get()->TryInvokeTab(FName("DeletionPreview"));
+}
+
+TSharedPtr<FAssetRecordStore> FBacgroundToolsModule::GetAllAssetRecords()
+{
+	BACGROUNDTOOLS_PROFILE_OPERATION("GetAllAssetRecords");
+
+	TSharedPtr<FAssetRecordStore> AssetRecords = MakeShared<FAssetRecordStore>();
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	// a tab restored with the editor layout has no folder yet, an empty filter would list the whole registry
+	if (SelectedFolderRoots.IsEmpty()) return AssetRecords;
+
+	// one recursive query over every root, no string path round trip per asset
+	FARFilter Filter;
+	SelectedFolderRoots.AddToFilter(Filter);
+
+	int32 NumScanned = 0;
+
+	// records are filled straight from the registry, no intermediate FAssetData array.
+	// the callback must not call back into the registry
+	AssetRegistry.EnumerateAssets(Filter, [this, &AssetRecords, &NumScanned](const FAssetData& AssetData)
+	{
+		++NumScanned;
+
+		if (!PathExclusionRules.IsPathExcluded(AssetData.PackagePath))
+		{
+			AssetRecords->AddOrUpdate(AssetData);
+		}
+		return true;
+	});
+
+	FOperationProfiler::AddCount(EOperationCounter::RegistryQueries);
+	FOperationProfiler::AddCount(EOperationCounter::AssetsScanned, NumScanned);
+
+	return AssetRecords;
 }
 
 #pragma endregion
@@ -299,10 +506,9 @@ TArray<TSharedPtr<FAssetData>> FBacgroundToolsModule::GetAllAssetData()
 
 bool FBacgroundToolsModule::DeleteSingleAssetForAssetList(const FAssetData& AssetDataToDelete)
 {
-	TArray<FAssetData> AssetDataForDeletion;
-	AssetDataForDeletion.Add(AssetDataToDelete);
+	AssetDeletionQueue.Enqueue(MakeArrayView(&AssetDataToDelete, 1));
 
-	if (ObjectTools::DeleteAssets(AssetDataForDeletion) > 0)
+	if (AssetDeletionQueue.Flush() > 0)
 	{
 		return (true);
 	}
@@ -310,6 +516,14 @@ bool FBacgroundToolsModule::DeleteSingleAssetForAssetList(const FAssetData& Asse
 	return (false);
 }
 
+int32 FBacgroundToolsModule::DeleteMultipleAssetsForAssetList(const TArray<FAssetData>& AssetsDataToDelete)
+{
+	// redirectors are fixed up by the queue, once for the whole batch
+	AssetDeletionQueue.Enqueue(AssetsDataToDelete);
+
+	return AssetDeletionQueue.Flush();
+}
+
 #pragma endregion
 
 void FBacgroundToolsModule::ShutdownModule()
@@ -317,7 +531,38 @@ void FBacgroundToolsModule::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 
-	// test
+	if (ActiveUnusedAssetScan.IsValid())
+	{
+		ActiveUnusedAssetScan->CancelAndWait();
+		ActiveUnusedAssetScan.Reset();
+	}
+
+	if (ActiveDuplicateContentScan.IsValid())
+	{
+		ActiveDuplicateContentScan->CancelAndWait();
+		ActiveDuplicateContentScan.Reset();
+	}
+
+	BuildingDeletionPreview.Reset();
+
+	for (TFuture<void>& Future : DeletionPreviewFutures)
+	{
+		Future.Wait();
+	}
+	DeletionPreviewFutures.Empty();
+
+	AssetSizeCache.Shutdown();
+
+	PathExclusionRules.Shutdown();
+
+	PrefixTable.Shutdown();
+
+	AssetDeletionQueue.OnPreviewRequested.Unbind();
+	AssetDeletionQueue.Shutdown();
+
+	RedirectorFixUpService.Shutdown();
+
+	ReferencerIndex.Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,623 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Commandlets/BacgroundToolsBenchmarkCommandlet.h"
+#include "BacgroundTools.h"
+#include "AssetScan/EmptyFolderTree.h"
+#include "AssetScan/AssetReachability.h"
+#include "SlateWidgets/AdvanceDeletionFilter.h"
+#include "SlateWidgets/AdvanceDeletionWidget.h"
+#include "AssetScan/AssetRecordStore.h"
+#include "AssetScan/FolderRootSet.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/ObjectRedirector.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBacgroundToolsBenchmark, Log, All);
+
+namespace BacgroundToolsBenchmark
+{
+	const FString MountRoot(TEXT("/BacgroundToolsBench/"));
+
+	constexpr int32 NumCounters = static_cast<int32>(EOperationCounter::Num);
+
+	struct FConfig
+	{
+		TArray<int32> Sizes = { 1000, 10000, 100000 };
+
+		// references per asset
+		int32 FanOut = 4;
+
+		// references going through a redirector
+		int32 RedirectorPercent = 5;
+
+		// assets treated as roots for the reachability search
+		int32 RootPercent = 1;
+
+		int32 AssetsPerFolder = 100;
+
+		int32 EmptyFolders = 100;
+
+		int32 Seed = 1;
+
+		bool bKeepContent = false;
+	};
+
+	struct FStageResult
+	{
+		int32 NumAssets = 0;
+
+		FString Stage;
+
+		double Seconds = 0.0;
+
+		int64 CounterDeltas[NumCounters] = {};
+
+		uint64 UsedPhysical = 0;
+
+		uint64 PeakUsedPhysical = 0;
+	};
+
+	struct FTree
+	{
+		FString RootPath;
+
+		TArray<FName> AssetPackages;
+
+		int32 NumRedirectors = 0;
+
+		FReachabilityRoots Roots;
+
+		// what the operations have to find, known from the generated references
+
+		// asset and redirector packages the roots reach
+		TSet<FName> ReachablePackages;
+
+		int32 NumReachableAssets = 0;
+
+		// the generated empty folders, before anything is deleted
+		int32 NumEmptyFolders = 0;
+
+		// once the redirectors and the unreachable assets are gone
+		int32 NumEmptyFoldersAfterDeletion = 0;
+	};
+
+	/** Logs a mismatch between what an operation returned and what the generator expects */
+	bool CheckResult(int32 NumAssets, const TCHAR* Check, int32 Actual, int32 Expected)
+	{
+		if (Actual == Expected) return true;
+
+		UE_LOG(LogBacgroundToolsBenchmark, Error, TEXT("%d assets, %s: got %d, expected %d"), NumAssets, Check, Actual, Expected);
+		return false;
+	}
+
+	template <typename FuncType>
+	void RunStage(int32 NumAssets, const TCHAR* Stage, TArray<FStageResult>& OutResults, FuncType&& Func)
+	{
+		int64 StartCounts[NumCounters];
+		for (int32 i = 0; i < NumCounters; ++i)
+		{
+			StartCounts[i] = FOperationProfiler::GetCount(static_cast<EOperationCounter>(i));
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		Func();
+
+		FStageResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.NumAssets = NumAssets;
+		Result.Stage = Stage;
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		for (int32 i = 0; i < NumCounters; ++i)
+		{
+			Result.CounterDeltas[i] = FOperationProfiler::GetCount(static_cast<EOperationCounter>(i)) - StartCounts[i];
+		}
+
+		// the process peak can't be reset, a stage raising it is the one that shows up
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+		Result.UsedPhysical = MemoryStats.UsedPhysical;
+		Result.PeakUsedPhysical = MemoryStats.PeakUsedPhysical;
+
+		UE_LOG(LogBacgroundToolsBenchmark, Display, TEXT("%d assets, %s: %.3fs, %.1f MB used, %.1f MB peak"),
+			NumAssets, Stage, Result.Seconds, Result.UsedPhysical / (1024.0 * 1024.0), Result.PeakUsedPhysical / (1024.0 * 1024.0));
+	}
+
+	bool SaveNewPackage(UPackage* Package)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(),
+			FPackageName::GetAssetPackageExtension());
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+
+		return UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs);
+	}
+
+	void GenerateTree(int32 NumAssets, const FConfig& Config, FTree& Tree)
+	{
+		IAssetRegistry& AssetRegistry =
+			FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+		FRandomStream Random(Config.Seed);
+
+		TArray<UBacgroundToolsBenchmarkAsset*> Assets;
+		Assets.Reserve(NumAssets);
+
+		TArray<UObject*> CreatedObjects;
+		TArray<UPackage*> Packages;
+
+		Tree.AssetPackages.Reserve(NumAssets);
+
+		// per asset, the assets it references directly and the redirector packages it references
+		TArray<TArray<int32>> AssetReferences;
+		TArray<TArray<FName>> RedirectorReferences;
+		AssetReferences.SetNum(NumAssets);
+		RedirectorReferences.SetNum(NumAssets);
+
+		for (int32 i = 0; i < NumAssets; ++i)
+		{
+			const int32 FolderIndex = i / Config.AssetsPerFolder;
+			const FString PackageName = FString::Printf(TEXT("%s/G%03d/F%05d/Asset_%06d"),
+				*Tree.RootPath, FolderIndex / 100, FolderIndex, i);
+
+			UPackage* Package = CreatePackage(*PackageName);
+			UBacgroundToolsBenchmarkAsset* Asset = NewObject<UBacgroundToolsBenchmarkAsset>(Package,
+				*FPackageName::GetShortName(PackageName), RF_Public | RF_Standalone);
+
+			// references only point to lower indices, the highest assets are the roots
+			for (int32 Reference = 0; i > 0 && Reference < Config.FanOut; ++Reference)
+			{
+				const int32 TargetIndex = Random.RandHelper(i);
+				UBacgroundToolsBenchmarkAsset* Target = Assets[TargetIndex];
+
+				AssetReferences[i].Add(TargetIndex);
+
+				if (Random.RandHelper(100) >= Config.RedirectorPercent)
+				{
+					Asset->References.Add(Target);
+					continue;
+				}
+
+				const FString RedirectorName = FString::Printf(TEXT("%s_Redirector_%06d_%d"),
+					*Target->GetPackage()->GetName(), i, Reference);
+
+				UPackage* RedirectorPackage = CreatePackage(*RedirectorName);
+				UObjectRedirector* Redirector = NewObject<UObjectRedirector>(RedirectorPackage,
+					*FPackageName::GetShortName(RedirectorName), RF_Public | RF_Standalone);
+				Redirector->DestinationObject = Target;
+
+				Asset->References.Add(Redirector);
+				RedirectorReferences[i].Add(RedirectorPackage->GetFName());
+
+				CreatedObjects.Add(Redirector);
+				Packages.Add(RedirectorPackage);
+				++Tree.NumRedirectors;
+			}
+
+			Assets.Add(Asset);
+			CreatedObjects.Add(Asset);
+			Packages.Add(Package);
+			Tree.AssetPackages.Add(Package->GetFName());
+		}
+
+		const int32 NumRoots = FMath::Max(1, NumAssets * Config.RootPercent / 100);
+		for (int32 i = FMath::Max(0, NumAssets - NumRoots); i < NumAssets; ++i)
+		{
+			Tree.Roots.RootPackages.Add(Tree.AssetPackages[i]);
+		}
+
+		// references only point to lower indices, one descending pass propagates the reachability
+		TBitArray<> ReachableAssets(false, NumAssets);
+		for (int32 i = NumAssets - 1; i >= 0; --i)
+		{
+			if (!ReachableAssets[i] && !Tree.Roots.RootPackages.Contains(Tree.AssetPackages[i])) continue;
+
+			ReachableAssets[i] = true;
+			Tree.ReachablePackages.Add(Tree.AssetPackages[i]);
+
+			for (const int32 TargetIndex : AssetReferences[i])
+			{
+				ReachableAssets[TargetIndex] = true;
+			}
+
+			Tree.ReachablePackages.Append(RedirectorReferences[i]);
+		}
+		Tree.NumReachableAssets = ReachableAssets.CountSetBits();
+
+		// Empty, E####, and every other E#### has a Nested folder
+		Tree.NumEmptyFolders = Config.EmptyFolders > 0 ? 1 + Config.EmptyFolders + Config.EmptyFolders / 2 : 0;
+
+		// asset folders keep only their reachable assets, the redirectors in them are fixed up
+		const int32 NumAssetFolders = NumAssets > 0 ? (NumAssets - 1) / Config.AssetsPerFolder + 1 : 0;
+
+		TBitArray<> UsedAssetFolders(false, NumAssetFolders);
+		for (TConstSetBitIterator<> It(ReachableAssets); It; ++It)
+		{
+			UsedAssetFolders[It.GetIndex() / Config.AssetsPerFolder] = true;
+		}
+
+		Tree.NumEmptyFoldersAfterDeletion = Tree.NumEmptyFolders;
+		for (int32 GroupStart = 0; GroupStart < NumAssetFolders; GroupStart += 100)
+		{
+			const int32 NumGroupFolders = FMath::Min(100, NumAssetFolders - GroupStart);
+			const int32 NumUsedGroupFolders = UsedAssetFolders.CountSetBits(GroupStart, GroupStart + NumGroupFolders);
+
+			Tree.NumEmptyFoldersAfterDeletion += NumGroupFolders - NumUsedGroupFolders + (NumUsedGroupFolders == 0 ? 1 : 0);
+		}
+
+		for (UPackage* Package : Packages)
+		{
+			if (!SaveNewPackage(Package))
+			{
+				UE_LOG(LogBacgroundToolsBenchmark, Warning, TEXT("Could not save %s"), *Package->GetName());
+			}
+		}
+
+		// empty folders exist on disk and in the registry only, every other one nested one level deeper
+		for (int32 i = 0; i < Config.EmptyFolders; ++i)
+		{
+			FString FolderPath = FString::Printf(TEXT("%s/Empty/E%04d"), *Tree.RootPath, i);
+			if (i % 2 == 1)
+			{
+				FolderPath += TEXT("/Nested");
+			}
+
+			FString Directory;
+			if (FPackageName::TryConvertLongPackageNameToFilename(FolderPath + TEXT("/"), Directory))
+			{
+				IFileManager::Get().MakeDirectory(*Directory, true);
+			}
+
+			AssetRegistry.AddPath(FolderPath);
+		}
+
+		// the operations start cold, nothing of the tree stays loaded
+		for (UObject* Object : CreatedObjects)
+		{
+			Object->ClearFlags(RF_Standalone);
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	void BuildEmptyFolderTree(const FFolderRootSet& TreeRoots, FBacgroundToolsModule& BacgroundToolsModule, FEmptyFolderTree& OutEmptyFolderTree)
+	{
+		TArray<FString> FolderPaths;
+		TreeRoots.GetFolderPaths(FolderPaths);
+
+		OutEmptyFolderTree.Build(FolderPaths, BacgroundToolsModule.GetPathExclusionRules());
+	}
+
+	/** Returns false when an operation did not find what the generator put in the tree */
+	bool RunTree(int32 NumAssets, const FConfig& Config, FBacgroundToolsModule& BacgroundToolsModule,
+		TArray<FStageResult>& OutResults)
+	{
+		IAssetRegistry& AssetRegistry =
+			FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+		FTree Tree;
+		Tree.RootPath = FString::Printf(TEXT("%sTree_%d"), *MountRoot, NumAssets);
+
+		// the operations run over the tree the way the menu actions run over a folder selection
+		const FFolderRootSet TreeRoots({ Tree.RootPath });
+		const FPathExclusionRules& ExclusionRules = BacgroundToolsModule.GetPathExclusionRules();
+
+		RunStage(NumAssets, TEXT("Generate"), OutResults, [&]()
+		{
+			GenerateTree(NumAssets, Config, Tree);
+		});
+
+		UE_LOG(LogBacgroundToolsBenchmark, Display, TEXT("%s: %d assets, %d redirectors, %d roots"),
+			*Tree.RootPath, NumAssets, Tree.NumRedirectors, Tree.Roots.RootPackages.Num());
+
+		RunStage(NumAssets, TEXT("Discover"), OutResults, [&]()
+		{
+			AssetRegistry.ScanPathsSynchronous({ Tree.RootPath }, true);
+		});
+
+		TArray<FAssetData> Assets;
+		RunStage(NumAssets, TEXT("GetAssets"), OutResults, [&]()
+		{
+			TreeRoots.GetOnDiskAssets(ExclusionRules, Assets);
+		});
+
+		bool bIsValid = CheckResult(NumAssets, TEXT("discovered assets"), Assets.Num(), NumAssets + Tree.NumRedirectors);
+
+		FReferencerIndex& ReferencerIndex = BacgroundToolsModule.GetReferencerIndex();
+
+		// the on-disk cache still covers the rest of the project, the new tree is queried in full
+		ReferencerIndex.Invalidate();
+		RunStage(NumAssets, TEXT("ReferencerIndexBuild"), OutResults, [&]()
+		{
+			ReferencerIndex.Update();
+		});
+
+		RunStage(NumAssets, TEXT("FindUnused"), OutResults, [&]()
+		{
+			TArray<FAssetData> UnusedAssets;
+			ReferencerIndex.GetUnusedAssets(Assets, UnusedAssets);
+		});
+
+		TArray<FAssetData> UnreachableAssets;
+		RunStage(NumAssets, TEXT("FindUnreachable"), OutResults, [&]()
+		{
+			ReferencerIndex.GetUnreachableAssets(Assets, Tree.Roots, UnreachableAssets);
+		});
+
+		{
+			TSet<FName> UnreachablePackages;
+			for (const FAssetData& AssetData : UnreachableAssets)
+			{
+				UnreachablePackages.Add(AssetData.PackageName);
+			}
+
+			// a package is either reachable by the generated references or found unreachable, never both
+			int32 NumMisclassified = 0;
+			for (const FAssetData& AssetData : Assets)
+			{
+				if (UnreachablePackages.Contains(AssetData.PackageName) == Tree.ReachablePackages.Contains(AssetData.PackageName))
+				{
+					++NumMisclassified;
+				}
+			}
+
+			bIsValid &= CheckResult(NumAssets, TEXT("misclassified reachability"), NumMisclassified, 0);
+		}
+
+		RunStage(NumAssets, TEXT("TabFilterIndex"), OutResults, [&]()
+		{
+			// same path as the tab, records first, then the index over them
+			FAssetRecordStore Records;
+			Records.Reserve(Assets.Num());
+			for (const FAssetData& AssetData : Assets)
+			{
+				Records.AddOrUpdate(AssetData);
+			}
+
+			UE_LOG(LogBacgroundToolsBenchmark, Display, TEXT("%d records: %.1f KB, as FAssetData: %.1f KB"),
+				Records.Num(), Records.GetAllocatedSize() / 1024.0, Assets.GetAllocatedSize() / 1024.0);
+
+			FAdvanceDeletionAssetIndex AssetIndex;
+			AssetIndex.Build(Records);
+
+			FAdvanceDeletionFilterSettings FilterSettings;
+			TArray<int32> View;
+
+			for (const EAdvanceDeletionFilterType FilterType : { EAdvanceDeletionFilterType::All,
+				EAdvanceDeletionFilterType::UnusedOnly, EAdvanceDeletionFilterType::PrefixMismatch,
+				EAdvanceDeletionFilterType::LargerThan, EAdvanceDeletionFilterType::OlderThan })
+			{
+				FilterSettings.Type = FilterType;
+				AssetIndex.BuildView(FilterSettings, AdvanceDeletionColumns::AssetName, EColumnSortMode::Ascending, View);
+			}
+		});
+
+		int32 NumEmptyFolders = 0;
+		RunStage(NumAssets, TEXT("FindEmptyFolders"), OutResults, [&]()
+		{
+			FEmptyFolderTree EmptyFolderTree;
+			BuildEmptyFolderTree(TreeRoots, BacgroundToolsModule, EmptyFolderTree);
+
+			NumEmptyFolders = EmptyFolderTree.GetNumEmptyFolders();
+		});
+
+		bIsValid &= CheckResult(NumAssets, TEXT("empty folders"), NumEmptyFolders, Tree.NumEmptyFolders);
+
+		FRedirectorFixUpService& RedirectorFixUpService = BacgroundToolsModule.GetRedirectorFixUpService();
+
+		TArray<FSoftObjectPath> RedirectorPaths;
+		RedirectorFixUpService.GetRedirectorsUnderRoots(TreeRoots, RedirectorPaths);
+
+		bIsValid &= CheckResult(NumAssets, TEXT("redirectors"), RedirectorPaths.Num(), Tree.NumRedirectors);
+
+		// redirectors go first, as in the menu actions
+		RunStage(NumAssets, TEXT("FixUpRedirectors"), OutResults, [&]()
+		{
+			RedirectorFixUpService.FixUpRedirectorsUnderRoots(TreeRoots);
+		});
+
+		RedirectorPaths.Reset();
+		RedirectorFixUpService.GetRedirectorsUnderRoots(TreeRoots, RedirectorPaths);
+
+		bIsValid &= CheckResult(NumAssets, TEXT("redirectors left after the fix up"), RedirectorPaths.Num(), 0);
+
+		Assets.Reset();
+		TreeRoots.GetOnDiskAssets(ExclusionRules, Assets);
+
+		// the fix up pointed the references at the destinations, only the unreachable assets are left to find
+		UnreachableAssets.Reset();
+		ReferencerIndex.GetUnreachableAssets(Assets, Tree.Roots, UnreachableAssets);
+
+		const int32 NumExpectedDeleted = NumAssets - Tree.NumReachableAssets;
+
+		bIsValid &= CheckResult(NumAssets, TEXT("unreachable assets after the fix up"), UnreachableAssets.Num(), NumExpectedDeleted);
+
+		int32 NumDeletedAssets = 0;
+		RunStage(NumAssets, TEXT("DeleteUnreachable"), OutResults, [&]()
+		{
+			FAssetDeletionQueue& AssetDeletionQueue = BacgroundToolsModule.GetAssetDeletionQueue();
+			AssetDeletionQueue.Enqueue(UnreachableAssets);
+			NumDeletedAssets = AssetDeletionQueue.Flush(false);
+		});
+
+		bIsValid &= CheckResult(NumAssets, TEXT("deleted assets"), NumDeletedAssets, NumExpectedDeleted);
+
+		int32 NumDeletedFolders = 0;
+		RunStage(NumAssets, TEXT("DeleteEmptyFolders"), OutResults, [&]()
+		{
+			FEmptyFolderTree EmptyFolderTree;
+			BuildEmptyFolderTree(TreeRoots, BacgroundToolsModule, EmptyFolderTree);
+
+			for (const FEmptyFolderTree::FEmptySubtree& EmptySubtree : EmptyFolderTree.GetEmptySubtrees())
+			{
+				if (FEmptyFolderTree::DeleteEmptySubtree(EmptySubtree))
+				{
+					NumDeletedFolders += EmptySubtree.NumFolders;
+				}
+			}
+		});
+
+		bIsValid &= CheckResult(NumAssets, TEXT("deleted empty folders"), NumDeletedFolders, Tree.NumEmptyFoldersAfterDeletion);
+
+		if (!Config.bKeepContent)
+		{
+			FString Directory;
+			if (FPackageName::TryConvertLongPackageNameToFilename(Tree.RootPath + TEXT("/"), Directory))
+			{
+				IFileManager::Get().DeleteDirectory(*Directory, false, true);
+			}
+
+			AssetRegistry.RemovePath(Tree.RootPath);
+		}
+
+		return bIsValid;
+	}
+
+	bool WriteCsvResults(const TArray<FStageResult>& Results, const FString& ReportFilename)
+	{
+		FString CsvText = TEXT("Assets,Stage,Seconds");
+		for (int32 i = 0; i < NumCounters; ++i)
+		{
+			CsvText += TEXT(",");
+			CsvText += FOperationProfiler::GetCounterName(static_cast<EOperationCounter>(i));
+		}
+		CsvText += TEXT(",UsedPhysicalMB,PeakUsedPhysicalMB\n");
+
+		for (const FStageResult& Result : Results)
+		{
+			CsvText += FString::Printf(TEXT("%d,%s,%.6f"), Result.NumAssets, *Result.Stage, Result.Seconds);
+
+			for (int32 i = 0; i < NumCounters; ++i)
+			{
+				CsvText += FString::Printf(TEXT(",%lld"), Result.CounterDeltas[i]);
+			}
+
+			CsvText += FString::Printf(TEXT(",%.1f,%.1f\n"),
+				Result.UsedPhysical / (1024.0 * 1024.0), Result.PeakUsedPhysical / (1024.0 * 1024.0));
+		}
+
+		return FFileHelper::SaveStringToFile(CsvText, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+}
+
+UBacgroundToolsBenchmarkCommandlet::UBacgroundToolsBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UBacgroundToolsBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace BacgroundToolsBenchmark;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	auto GetIntParam = [&ParamVals](const TCHAR* Name, int32 DefaultValue)
+	{
+		const FString* Value = ParamVals.Find(Name);
+		return Value ? FCString::Atoi(**Value) : DefaultValue;
+	};
+
+	FConfig Config;
+
+	if (const FString* Sizes = ParamVals.Find(TEXT("Sizes")))
+	{
+		TArray<FString> SizeStrings;
+		Sizes->ParseIntoArray(SizeStrings, TEXT(","));
+
+		Config.Sizes.Reset();
+		for (const FString& SizeString : SizeStrings)
+		{
+			const int32 Size = FCString::Atoi(*SizeString);
+			if (Size > 0)
+			{
+				Config.Sizes.Add(Size);
+			}
+		}
+	}
+
+	Config.FanOut = FMath::Max(0, GetIntParam(TEXT("FanOut"), Config.FanOut));
+	Config.RedirectorPercent = FMath::Clamp(GetIntParam(TEXT("RedirectorPercent"), Config.RedirectorPercent), 0, 100);
+	Config.RootPercent = FMath::Clamp(GetIntParam(TEXT("RootPercent"), Config.RootPercent), 0, 100);
+	Config.AssetsPerFolder = FMath::Max(1, GetIntParam(TEXT("AssetsPerFolder"), Config.AssetsPerFolder));
+	Config.EmptyFolders = FMath::Max(0, GetIntParam(TEXT("EmptyFolders"), Config.EmptyFolders));
+	Config.Seed = GetIntParam(TEXT("Seed"), Config.Seed);
+	Config.bKeepContent = Switches.Contains(TEXT("KeepContent"));
+
+	const FString ReportFilename = ParamVals.Contains(TEXT("Report")) ?
+		FPaths::ConvertRelativePathToFull(ParamVals[TEXT("Report")]) :
+		FPaths::ProfilingDir() / TEXT("BacgroundToolsBenchmark.csv");
+
+	// no editor tick to finish the discovery in the background
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	// a temporary mount point keeps the synthetic trees out of the project content
+	const FString ContentDirectory = FPaths::ConvertRelativePathToFull(
+		FPaths::ProjectSavedDir() / TEXT("BacgroundTools") / TEXT("Benchmark") / TEXT("Content/"));
+	IFileManager::Get().DeleteDirectory(*ContentDirectory, false, true);
+	IFileManager::Get().MakeDirectory(*ContentDirectory, true);
+
+	FPackageName::RegisterMountPoint(MountRoot, ContentDirectory);
+
+	const FString MountPath = MountRoot.LeftChop(1);
+	BacgroundToolsModule.GetRedirectorFixUpService().AddTrackedRootPath(MountPath);
+
+	TArray<FStageResult> Results;
+
+	int32 NumInvalidTrees = 0;
+
+	for (const int32 NumAssets : Config.Sizes)
+	{
+		UE_LOG(LogBacgroundToolsBenchmark, Display, TEXT("Benchmarking %d assets"), NumAssets);
+
+		if (!RunTree(NumAssets, Config, BacgroundToolsModule, Results))
+		{
+			++NumInvalidTrees;
+		}
+	}
+
+	BacgroundToolsModule.GetRedirectorFixUpService().RemoveTrackedRootPath(MountPath);
+
+	FPackageName::UnRegisterMountPoint(MountRoot, ContentDirectory);
+
+	if (!Config.bKeepContent)
+	{
+		IFileManager::Get().DeleteDirectory(*ContentDirectory, false, true);
+	}
+
+	if (!WriteCsvResults(Results, ReportFilename))
+	{
+		UE_LOG(LogBacgroundToolsBenchmark, Error, TEXT("Could not write the results to %s"), *ReportFilename);
+		return 1;
+	}
+
+	UE_LOG(LogBacgroundToolsBenchmark, Display, TEXT("Results written to %s"), *ReportFilename);
+
+	// timings of wrong results mean nothing, a CI run has to fail on them
+	if (NumInvalidTrees > 0)
+	{
+		UE_LOG(LogBacgroundToolsBenchmark, Error, TEXT("%d of %d trees gave unexpected results"), NumInvalidTrees, Config.Sizes.Num());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,321 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Commandlets/BacgroundToolsReportCommandlet.h"
+#include "BacgroundTools.h"
+#include "AssetScan/EmptyFolderTree.h"
+#include "AssetScan/AssetReachability.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "Profiling/OperationProfiler.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogBacgroundToolsReport, Log, All);
+
+namespace BacgroundToolsReport
+{
+	struct FUnusedAssetEntry
+	{
+		FAssetData AssetData;
+
+		int64 DiskSize = 0;
+	};
+
+	struct FReport
+	{
+		FFolderRootSet FolderRoots;
+
+		bool bApplied = false;
+
+		TArray<FSoftObjectPath> Redirectors;
+
+		TArray<FUnusedAssetEntry> UnusedAssets;
+
+		// unused packages only referencing each other, one array per cycle
+		TArray<TArray<FName>> UnreachableCycles;
+
+		int32 NumDeletedAssets = 0;
+
+		TArray<FEmptyFolderTree::FEmptySubtree> EmptySubtrees;
+
+		int32 NumEmptyFolders = 0;
+
+		int32 NumDeletedFolders = 0;
+	};
+
+	void CollectUnusedAssets(FBacgroundToolsModule& BacgroundToolsModule, FReport& Report)
+	{
+		// one registry query per root, run in parallel
+		TArray<FAssetData> AssetsDataArray;
+		Report.FolderRoots.GetOnDiskAssets(BacgroundToolsModule.GetPathExclusionRules(), AssetsDataArray);
+
+		TArray<FAssetData> UnusedAssetsDataArray;
+
+		if (UBacgroundToolsSettings::Get()->bFindUnreachableAssets)
+		{
+			FReachabilityRoots Roots;
+			FAssetReachability::CollectRoots(Roots);
+
+			BacgroundToolsModule.GetReferencerIndex().GetUnreachableAssets(AssetsDataArray, Roots, UnusedAssetsDataArray,
+				&Report.UnreachableCycles);
+		}
+		else
+		{
+			BacgroundToolsModule.GetReferencerIndex().GetUnusedAssets(AssetsDataArray, UnusedAssetsDataArray);
+		}
+
+		UnusedAssetsDataArray.Sort([](const FAssetData& A, const FAssetData& B)
+		{
+			return A.PackageName.LexicalLess(B.PackageName);
+		});
+
+		Report.UnusedAssets.SetNum(UnusedAssetsDataArray.Num());
+
+		// reclaimable size, the stat calls are the expensive part and spread over the worker threads
+		ParallelFor(UnusedAssetsDataArray.Num(), [&Report, &UnusedAssetsDataArray](int32 i)
+		{
+			FUnusedAssetEntry& Entry = Report.UnusedAssets[i];
+			Entry.AssetData = UnusedAssetsDataArray[i];
+			Entry.DiskSize = FAssetSizeCache::StatPackage(FAssetSizeCache::GetPackageFilename(Entry.AssetData)).Footprint;
+		});
+	}
+
+	void CollectEmptyFolders(FBacgroundToolsModule& BacgroundToolsModule, FReport& Report)
+	{
+		TArray<FString> FolderPaths;
+		Report.FolderRoots.GetFolderPaths(FolderPaths);
+
+		// every root in the same tree, the asset counts come from one registry enumeration
+		FEmptyFolderTree EmptyFolderTree;
+		EmptyFolderTree.Build(FolderPaths, BacgroundToolsModule.GetPathExclusionRules());
+
+		Report.EmptySubtrees = EmptyFolderTree.GetEmptySubtrees();
+		Report.NumEmptyFolders = EmptyFolderTree.GetNumEmptyFolders();
+	}
+
+	bool WriteJsonReport(const FReport& Report, const FString& ReportFilename)
+	{
+		TSharedRef<FJsonObject> RootObject = MakeShared<FJsonObject>();
+		TArray<TSharedPtr<FJsonValue>> RootValues;
+		for (const FString& Root : Report.FolderRoots.GetRoots())
+		{
+			RootValues.Add(MakeShared<FJsonValueString>(Root));
+		}
+		RootObject->SetArrayField(TEXT("roots"), RootValues);
+		RootObject->SetBoolField(TEXT("applied"), Report.bApplied);
+
+		TArray<TSharedPtr<FJsonValue>> RedirectorValues;
+		for (const FSoftObjectPath& Redirector : Report.Redirectors)
+		{
+			RedirectorValues.Add(MakeShared<FJsonValueString>(Redirector.ToString()));
+		}
+		RootObject->SetArrayField(TEXT("redirectors"), RedirectorValues);
+
+		int64 UnusedDiskSize = 0;
+		TArray<TSharedPtr<FJsonValue>> UnusedAssetValues;
+		for (const FUnusedAssetEntry& Entry : Report.UnusedAssets)
+		{
+			TSharedRef<FJsonObject> AssetObject = MakeShared<FJsonObject>();
+			AssetObject->SetStringField(TEXT("path"), Entry.AssetData.GetSoftObjectPath().ToString());
+			AssetObject->SetStringField(TEXT("class"), Entry.AssetData.AssetClassPath.ToString());
+			AssetObject->SetNumberField(TEXT("diskSize"), static_cast<double>(Entry.DiskSize));
+
+			UnusedAssetValues.Add(MakeShared<FJsonValueObject>(AssetObject));
+			UnusedDiskSize += Entry.DiskSize;
+		}
+		RootObject->SetArrayField(TEXT("unusedAssets"), UnusedAssetValues);
+		RootObject->SetNumberField(TEXT("unusedDiskSize"), static_cast<double>(UnusedDiskSize));
+		RootObject->SetNumberField(TEXT("deletedAssets"), Report.NumDeletedAssets);
+
+		TArray<TSharedPtr<FJsonValue>> CycleValues;
+		for (const TArray<FName>& Cycle : Report.UnreachableCycles)
+		{
+			TArray<TSharedPtr<FJsonValue>> PackageValues;
+			for (const FName& PackageName : Cycle)
+			{
+				PackageValues.Add(MakeShared<FJsonValueString>(PackageName.ToString()));
+			}
+
+			CycleValues.Add(MakeShared<FJsonValueArray>(PackageValues));
+		}
+		RootObject->SetArrayField(TEXT("unreachableCycles"), CycleValues);
+
+		TArray<TSharedPtr<FJsonValue>> EmptyFolderValues;
+		for (const FEmptyFolderTree::FEmptySubtree& EmptySubtree : Report.EmptySubtrees)
+		{
+			TSharedRef<FJsonObject> FolderObject = MakeShared<FJsonObject>();
+			FolderObject->SetStringField(TEXT("path"), EmptySubtree.FolderPath);
+			FolderObject->SetNumberField(TEXT("numFolders"), EmptySubtree.NumFolders);
+
+			EmptyFolderValues.Add(MakeShared<FJsonValueObject>(FolderObject));
+		}
+		RootObject->SetArrayField(TEXT("emptyFolders"), EmptyFolderValues);
+		RootObject->SetNumberField(TEXT("numEmptyFolders"), Report.NumEmptyFolders);
+		RootObject->SetNumberField(TEXT("deletedFolders"), Report.NumDeletedFolders);
+
+		FString JsonText;
+		TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonText);
+		if (!FJsonSerializer::Serialize(RootObject, JsonWriter)) return false;
+
+		return FFileHelper::SaveStringToFile(JsonText, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+
+	bool WriteCsvReport(const FReport& Report, const FString& ReportFilename)
+	{
+		// one row per finding, paths never contain commas
+		FString CsvText = TEXT("Type,Path,Class,DiskSize\n");
+
+		for (const FSoftObjectPath& Redirector : Report.Redirectors)
+		{
+			CsvText += FString::Printf(TEXT("Redirector,%s,,\n"), *Redirector.ToString());
+		}
+
+		for (const FUnusedAssetEntry& Entry : Report.UnusedAssets)
+		{
+			CsvText += FString::Printf(TEXT("UnusedAsset,%s,%s,%lld\n"), *Entry.AssetData.GetSoftObjectPath().ToString(),
+				*Entry.AssetData.AssetClassPath.ToString(), Entry.DiskSize);
+		}
+
+		// package names have no spaces, the packages of a cycle share one row
+		for (const TArray<FName>& Cycle : Report.UnreachableCycles)
+		{
+			CsvText += FString::Printf(TEXT("UnreachableCycle,%s,,\n"),
+				*FString::JoinBy(Cycle, TEXT(" "), [](FName PackageName) { return PackageName.ToString(); }));
+		}
+
+		for (const FEmptyFolderTree::FEmptySubtree& EmptySubtree : Report.EmptySubtrees)
+		{
+			CsvText += FString::Printf(TEXT("EmptyFolder,%s,,\n"), *EmptySubtree.FolderPath);
+		}
+
+		return FFileHelper::SaveStringToFile(CsvText, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+	}
+}
+
+UBacgroundToolsReportCommandlet::UBacgroundToolsReportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UBacgroundToolsReportCommandlet::Main(const FString& Params)
+{
+	using namespace BacgroundToolsReport;
+
+	BACGROUNDTOOLS_PROFILE_OPERATION("ReportCommandlet");
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	// -Path=/Game/A+/Game/B, nested and duplicate folders are merged into their topmost one
+	TArray<FString> FolderPaths;
+	if (const FString* Path = ParamVals.Find(TEXT("Path")))
+	{
+		Path->ParseIntoArray(FolderPaths, TEXT("+"));
+	}
+
+	for (FString& FolderPath : FolderPaths)
+	{
+		FolderPath.RemoveFromEnd(TEXT("/"));
+	}
+
+	FolderPaths.RemoveAll([](const FString& FolderPath) { return FolderPath.IsEmpty(); });
+
+	if (FolderPaths.Num() == 0)
+	{
+		FolderPaths.Add(TEXT("/Game"));
+	}
+
+	FReport Report;
+	Report.FolderRoots = FFolderRootSet(FolderPaths);
+	Report.bApplied = Switches.Contains(TEXT("Apply"));
+
+	const FString ReportFilename = ParamVals.Contains(TEXT("Report")) ?
+		FPaths::ConvertRelativePathToFull(ParamVals[TEXT("Report")]) :
+		FPaths::ProjectSavedDir() / TEXT("BacgroundTools") / TEXT("Report.json");
+
+	UE_LOG(LogBacgroundToolsReport, Display, TEXT("Scanning %s%s"), *Report.FolderRoots.ToString(), Report.bApplied ? TEXT(" (apply)") : TEXT(""));
+
+	// no editor tick to finish the discovery in the background
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	FRedirectorFixUpService& RedirectorFixUpService = BacgroundToolsModule.GetRedirectorFixUpService();
+	RedirectorFixUpService.GetRedirectorsUnderRoots(Report.FolderRoots, Report.Redirectors);
+
+	UE_LOG(LogBacgroundToolsReport, Display, TEXT("%d redirectors"), Report.Redirectors.Num());
+
+	// redirectors reference their destination, they have to go before the unused check
+	if (Report.bApplied && Report.Redirectors.Num() > 0)
+	{
+		RedirectorFixUpService.FixUpRedirectorsUnderRoots(Report.FolderRoots);
+	}
+
+	CollectUnusedAssets(BacgroundToolsModule, Report);
+
+	UE_LOG(LogBacgroundToolsReport, Display, TEXT("%d unused assets, %d reference cycles among them"),
+		Report.UnusedAssets.Num(), Report.UnreachableCycles.Num());
+
+	if (Report.bApplied && Report.UnusedAssets.Num() > 0)
+	{
+		TArray<FAssetData> AssetsDataToDelete;
+		AssetsDataToDelete.Reserve(Report.UnusedAssets.Num());
+
+		for (const FUnusedAssetEntry& Entry : Report.UnusedAssets)
+		{
+			AssetsDataToDelete.Add(Entry.AssetData);
+		}
+
+		FAssetDeletionQueue& AssetDeletionQueue = BacgroundToolsModule.GetAssetDeletionQueue();
+		AssetDeletionQueue.Enqueue(AssetsDataToDelete);
+
+		Report.NumDeletedAssets = AssetDeletionQueue.Flush(false);
+
+		UE_LOG(LogBacgroundToolsReport, Display, TEXT("Deleted %d assets"), Report.NumDeletedAssets);
+	}
+
+	// after the deletion, folders emptied by it are reported too
+	CollectEmptyFolders(BacgroundToolsModule, Report);
+
+	UE_LOG(LogBacgroundToolsReport, Display, TEXT("%d empty folders in %d subtrees"), Report.NumEmptyFolders, Report.EmptySubtrees.Num());
+
+	if (Report.bApplied)
+	{
+		for (const FEmptyFolderTree::FEmptySubtree& EmptySubtree : Report.EmptySubtrees)
+		{
+			if (FEmptyFolderTree::DeleteEmptySubtree(EmptySubtree))
+			{
+				Report.NumDeletedFolders += EmptySubtree.NumFolders;
+			}
+			else
+			{
+				UE_LOG(LogBacgroundToolsReport, Warning, TEXT("Failed to delete %s"), *EmptySubtree.FolderPath);
+			}
+		}
+	}
+
+	const bool bReportWritten = FPaths::GetExtension(ReportFilename).Equals(TEXT("csv"), ESearchCase::IgnoreCase) ?
+		WriteCsvReport(Report, ReportFilename) : WriteJsonReport(Report, ReportFilename);
+
+	if (!bReportWritten)
+	{
+		UE_LOG(LogBacgroundToolsReport, Error, TEXT("Could not write the report to %s"), *ReportFilename);
+		return 1;
+	}
+
+	UE_LOG(LogBacgroundToolsReport, Display, TEXT("Report written to %s"), *ReportFilename);
+
+	return 0;
+}
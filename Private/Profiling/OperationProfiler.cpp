@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Profiling/OperationProfiler.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+
+DEFINE_STAT(STAT_BacgroundTools_AssetsScanned);
+DEFINE_STAT(STAT_BacgroundTools_RegistryQueries);
+DEFINE_STAT(STAT_BacgroundTools_PackagesLoaded);
+DEFINE_STAT(STAT_BacgroundTools_GCPasses);
+
+DEFINE_LOG_CATEGORY_STATIC(LogBacgroundToolsProfile, Log, All);
+
+namespace OperationProfiler
+{
+	constexpr int32 NumCounters = static_cast<int32>(EOperationCounter::Num);
+
+	std::atomic<int64> Counts[NumCounters];
+
+	const TCHAR* CounterNames[NumCounters] =
+	{
+		TEXT("AssetsScanned"),
+		TEXT("RegistryQueries"),
+		TEXT("PackagesLoaded"),
+		TEXT("GCPasses")
+	};
+
+	// operations finish on workers too, the csv is appended by one of them at a time
+	FCriticalSection CsvLock;
+}
+
+void FOperationProfiler::AddCount(EOperationCounter Counter, int64 Amount)
+{
+	OperationProfiler::Counts[static_cast<int32>(Counter)].fetch_add(Amount, std::memory_order_relaxed);
+
+	switch (Counter)
+	{
+	case EOperationCounter::AssetsScanned:   INC_DWORD_STAT_BY(STAT_BacgroundTools_AssetsScanned, Amount); break;
+	case EOperationCounter::RegistryQueries: INC_DWORD_STAT_BY(STAT_BacgroundTools_RegistryQueries, Amount); break;
+	case EOperationCounter::PackagesLoaded:  INC_DWORD_STAT_BY(STAT_BacgroundTools_PackagesLoaded, Amount); break;
+	case EOperationCounter::GCPasses:        INC_DWORD_STAT_BY(STAT_BacgroundTools_GCPasses, Amount); break;
+	default: break;
+	}
+}
+
+int64 FOperationProfiler::GetCount(EOperationCounter Counter)
+{
+	return OperationProfiler::Counts[static_cast<int32>(Counter)].load(std::memory_order_relaxed);
+}
+
+const TCHAR* FOperationProfiler::GetCounterName(EOperationCounter Counter)
+{
+	return OperationProfiler::CounterNames[static_cast<int32>(Counter)];
+}
+
+FString FOperationProfiler::GetCsvFilename()
+{
+	return FPaths::ProfilingDir() / TEXT("BacgroundTools.csv");
+}
+
+void FOperationProfiler::WriteSummary(const TCHAR* OperationName, double Seconds, const int64* CounterDeltas)
+{
+	FString Summary = FString::Printf(TEXT("%s took %.3fs"), OperationName, Seconds);
+	FString CsvRow = FString::Printf(TEXT("%s,%s,%.6f"), *FDateTime::UtcNow().ToIso8601(), OperationName, Seconds);
+
+	for (int32 i = 0; i < OperationProfiler::NumCounters; ++i)
+	{
+		if (CounterDeltas[i] != 0)
+		{
+			Summary += FString::Printf(TEXT(", %s %lld"), OperationProfiler::CounterNames[i], CounterDeltas[i]);
+		}
+
+		CsvRow += FString::Printf(TEXT(",%lld"), CounterDeltas[i]);
+	}
+
+	UE_LOG(LogBacgroundToolsProfile, Display, TEXT("%s"), *Summary);
+
+	if (!UBacgroundToolsSettings::Get()->bWriteOperationProfileCsv) return;
+
+	FScopeLock Lock(&OperationProfiler::CsvLock);
+
+	const FString CsvFilename = GetCsvFilename();
+
+	if (!IFileManager::Get().FileExists(*CsvFilename))
+	{
+		FString Header = TEXT("Time,Operation,Seconds");
+		for (const TCHAR* CounterName : OperationProfiler::CounterNames)
+		{
+			Header += TEXT(",");
+			Header += CounterName;
+		}
+
+		FFileHelper::SaveStringToFile(Header + LINE_TERMINATOR, *CsvFilename);
+	}
+
+	FFileHelper::SaveStringToFile(CsvRow + LINE_TERMINATOR, *CsvFilename,
+		FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
+
+FScopedOperationProfile::FScopedOperationProfile(const TCHAR* InOperationName)
+	: OperationName(InOperationName)
+	, StartTime(FPlatformTime::Seconds())
+{
+	for (int32 i = 0; i < OperationProfiler::NumCounters; ++i)
+	{
+		StartCounts[i] = FOperationProfiler::GetCount(static_cast<EOperationCounter>(i));
+	}
+}
+
+FScopedOperationProfile::~FScopedOperationProfile()
+{
+	// counters are global, an operation running meanwhile on another thread shows up here too
+	int64 CounterDeltas[OperationProfiler::NumCounters];
+
+	for (int32 i = 0; i < OperationProfiler::NumCounters; ++i)
+	{
+		CounterDeltas[i] = FOperationProfiler::GetCount(static_cast<EOperationCounter>(i)) - StartCounts[i];
+	}
+
+	FOperationProfiler::WriteSummary(OperationName, FPlatformTime::Seconds() - StartTime, CounterDeltas);
+}
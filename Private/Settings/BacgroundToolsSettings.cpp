@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Settings/BacgroundToolsSettings.h"
+
+UBacgroundToolsSettings::UBacgroundToolsSettings()
+{
+	// Soft paths so editor-only and plugin classes don't need a module dependency
+	AssetPrefixes =
+	{
+		{FSoftClassPath(TEXT("/Script/Engine.Blueprint")), TEXT("BP_")},
+		{FSoftClassPath(TEXT("/Script/UMGEditor.WidgetBlueprint")), TEXT("WBP_")},
+		{FSoftClassPath(TEXT("/Script/Engine.StaticMesh")), TEXT("SM_")},
+		{FSoftClassPath(TEXT("/Script/Engine.SkeletalMesh")), TEXT("SK_")},
+		{FSoftClassPath(TEXT("/Script/Engine.Material")), TEXT("M_")},
+		{FSoftClassPath(TEXT("/Script/Engine.MaterialInstanceConstant")), TEXT("MI_")},
+		{FSoftClassPath(TEXT("/Script/Engine.MaterialFunctionInterface")), TEXT("MF_")},
+		{FSoftClassPath(TEXT("/Script/Engine.ParticleSystem")), TEXT("PS_")},
+		{FSoftClassPath(TEXT("/Script/Engine.SoundCue")), TEXT("SC_")},
+		{FSoftClassPath(TEXT("/Script/Engine.SoundWave")), TEXT("SW_")},
+		{FSoftClassPath(TEXT("/Script/Engine.Texture")), TEXT("T_")},
+		{FSoftClassPath(TEXT("/Script/Niagara.NiagaraSystem")), TEXT("NS_")},
+		{FSoftClassPath(TEXT("/Script/Niagara.NiagaraEmitter")), TEXT("NE_")}
+	};
+
+	ExcludedPaths =
+	{
+		TEXT("Developers"),
+		TEXT("Collections")
+	};
+}
@@ -0,0 +1,331 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/AdvanceDeletionFilter.h"
+#include "SlateWidgets/AdvanceDeletionWidget.h"
+#include "AssetScan/AssetRecordStore.h"
+#include "BacgroundTools.h"
+#include "Algo/BinarySearch.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+void FAdvanceDeletionAssetIndex::Build(FAssetRecordStore& InRecords)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAdvanceDeletionAssetIndex::Build);
+
+	Reset();
+
+	Records = &InRecords;
+	const int32 NumAssets = InRecords.Num();
+
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	// registry size of the new records, then whatever the size cache already has
+	InRecords.FillMissingDiskSizes();
+	InRecords.UpdateDiskSizes(BacgroundToolsModule.GetAssetSizeCache());
+
+	// prefixes are resolved once per class, not per asset
+	const TArray<FTopLevelAssetPath>& ClassPaths = InRecords.GetClassPaths();
+
+	TArray<const FString*> ClassPrefixes;
+	ClassPrefixes.SetNumZeroed(ClassPaths.Num());
+
+	for (int32 ClassIndex = 0; ClassIndex < ClassPaths.Num(); ++ClassIndex)
+	{
+		if (const FAssetPrefixTable::FResolvedPrefix* ResolvedPrefix = BacgroundToolsModule.GetPrefixTable().FindPrefix(ClassPaths[ClassIndex]))
+		{
+			ClassPrefixes[ClassIndex] = &ResolvedPrefix->Prefix;
+		}
+	}
+
+	ClassIndices.SetNum(ClassPaths.Num());
+
+	for (int32 i = 0; i < NumAssets; ++i)
+	{
+		const int32 ClassIndex = InRecords.GetClassIndex(i);
+
+		ClassIndices[ClassIndex].Add(i);
+
+		if (ClassPrefixes[ClassIndex] && !InRecords.GetAssetName(i).ToString().StartsWith(*ClassPrefixes[ClassIndex]))
+		{
+			PrefixMismatchIndices.Add(i);
+		}
+	}
+
+	for (int32 ClassIndex = 0; ClassIndex < ClassPaths.Num(); ++ClassIndex)
+	{
+		if (ClassIndices[ClassIndex].Num() > 0)
+		{
+			AssetClasses.Add(ClassPaths[ClassIndex]);
+		}
+	}
+
+	AssetClasses.Sort([](const FTopLevelAssetPath& A, const FTopLevelAssetPath& B)
+	{
+		return A.GetAssetName().LexicalLess(B.GetAssetName());
+	});
+
+	auto MakeIdentityOrder = [NumAssets](TArray<int32>& Order)
+	{
+		Order.SetNumUninitialized(NumAssets);
+		for (int32 i = 0; i < NumAssets; ++i)
+		{
+			Order[i] = i;
+		}
+	};
+
+	MakeIdentityOrder(NameOrder);
+	NameOrder.Sort([&InRecords](int32 A, int32 B)
+	{
+		return InRecords.GetAssetName(A).LexicalLess(InRecords.GetAssetName(B));
+	});
+
+	// classes are already sorted, concatenating their index arrays gives the class order
+	ClassOrder.Reserve(NumAssets);
+	for (const FTopLevelAssetPath& AssetClass : AssetClasses)
+	{
+		ClassOrder.Append(ClassIndices[InRecords.FindClassIndex(AssetClass)]);
+	}
+
+	MakeIdentityOrder(SizeOrder);
+	SizeOrder.Sort([&InRecords](int32 A, int32 B)
+	{
+		return InRecords.GetDiskSize(A) < InRecords.GetDiskSize(B);
+	});
+
+	// unloaded assets sort first, below every measured one
+	InRecords.UpdateResourceSizes();
+
+	MakeIdentityOrder(ResourceSizeOrder);
+	ResourceSizeOrder.Sort([&InRecords](int32 A, int32 B)
+	{
+		return InRecords.GetResourceSize(A) < InRecords.GetResourceSize(B);
+	});
+}
+
+void FAdvanceDeletionAssetIndex::Reset()
+{
+	Records = nullptr;
+
+	ClassIndices.Reset();
+	AssetClasses.Reset();
+	PrefixMismatchIndices.Reset();
+
+	UnusedIndices.Reset();
+	bHasUnusedIndices = false;
+
+	ModificationTimes.Reset();
+	bHasModificationTimes = false;
+
+	NameOrder.Reset();
+	ClassOrder.Reset();
+	SizeOrder.Reset();
+	ResourceSizeOrder.Reset();
+	AgeOrder.Reset();
+}
+
+bool FAdvanceDeletionAssetIndex::BuildView(const FAdvanceDeletionFilterSettings& Filter, FName SortColumn,
+	EColumnSortMode::Type SortMode, TArray<int32>& OutView)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAdvanceDeletionAssetIndex::BuildView);
+
+	OutView.Reset();
+
+	if (!Records) return true;
+
+	const int32 NumAssets = Records->Num();
+
+	// Candidates of the filter, taken straight from the precomputed arrays
+	TArrayView<const int32> Candidates;
+	bool bFiltered = true;
+	bool bIsComplete = true;
+
+	switch (Filter.Type)
+	{
+	case EAdvanceDeletionFilterType::UnusedOnly:
+		bIsComplete = EnsureUnusedIndices();
+		Candidates = UnusedIndices;
+		break;
+
+	case EAdvanceDeletionFilterType::ByClass:
+	{
+		const int32 ClassIndex = Records->FindClassIndex(Filter.AssetClass);
+		if (ClassIndices.IsValidIndex(ClassIndex))
+		{
+			Candidates = ClassIndices[ClassIndex];
+		}
+		break;
+	}
+
+	case EAdvanceDeletionFilterType::PrefixMismatch:
+		Candidates = PrefixMismatchIndices;
+		break;
+
+	case EAdvanceDeletionFilterType::LargerThan:
+	{
+		// SizeOrder is ascending, the matching assets are its tail
+		const int32 FirstLarger = Algo::UpperBoundBy(SizeOrder, Filter.MinSizeBytes,
+			[this](int32 AssetIndex) { return Records->GetDiskSize(AssetIndex); });
+		Candidates = MakeArrayView(SizeOrder.GetData() + FirstLarger, SizeOrder.Num() - FirstLarger);
+		break;
+	}
+
+	case EAdvanceDeletionFilterType::OlderThan:
+	{
+		bIsComplete = EnsureModificationTimes();
+
+		// AgeOrder is oldest first, the matching assets are its head
+		const FDateTime Threshold = FDateTime::UtcNow() - FTimespan::FromDays(Filter.MinAgeDays);
+		const int32 FirstNewer = Algo::LowerBoundBy(AgeOrder, Threshold,
+			[this](int32 AssetIndex) { return ModificationTimes[AssetIndex]; });
+		Candidates = MakeArrayView(AgeOrder.GetData(), FirstNewer);
+		break;
+	}
+
+	default:
+		bFiltered = false;
+		break;
+	}
+
+	const TArray<int32>* SortOrder = SortMode != EColumnSortMode::None ? GetSortOrder(SortColumn) : nullptr;
+
+	if (!SortOrder)
+	{
+		if (!bFiltered)
+		{
+			OutView.SetNumUninitialized(NumAssets);
+			for (int32 i = 0; i < NumAssets; ++i)
+			{
+				OutView[i] = i;
+			}
+		}
+		else
+		{
+			OutView.Append(Candidates.GetData(), Candidates.Num());
+			OutView.Sort();
+		}
+		return bIsComplete;
+	}
+
+	// Sorting is a walk over the presorted order keeping the candidates, no comparison involved
+	TBitArray<> Mask(!bFiltered, NumAssets);
+	for (const int32 AssetIndex : Candidates)
+	{
+		Mask[AssetIndex] = true;
+	}
+
+	OutView.Reserve(bFiltered ? Candidates.Num() : NumAssets);
+
+	if (SortMode == EColumnSortMode::Ascending)
+	{
+		for (const int32 AssetIndex : *SortOrder)
+		{
+			if (Mask[AssetIndex]) OutView.Add(AssetIndex);
+		}
+	}
+	else
+	{
+		for (int32 i = SortOrder->Num() - 1; i >= 0; --i)
+		{
+			if (Mask[(*SortOrder)[i]]) OutView.Add((*SortOrder)[i]);
+		}
+	}
+
+	return bIsComplete;
+}
+
+void FAdvanceDeletionAssetIndex::RefreshDiskSizes()
+{
+	if (!Records) return;
+
+	Records->UpdateDiskSizes(
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetAssetSizeCache());
+
+	SizeOrder.Sort([this](int32 A, int32 B)
+	{
+		return Records->GetDiskSize(A) < Records->GetDiskSize(B);
+	});
+
+	// re-stat-ed files may have new times too, they are read again on the next use
+	bHasModificationTimes = false;
+}
+
+bool FAdvanceDeletionAssetIndex::RefreshResourceSizes()
+{
+	if (!Records || !Records->UpdateResourceSizes()) return false;
+
+	ResourceSizeOrder.Sort([this](int32 A, int32 B)
+	{
+		return Records->GetResourceSize(A) < Records->GetResourceSize(B);
+	});
+
+	return true;
+}
+
+bool FAdvanceDeletionAssetIndex::EnsureUnusedIndices()
+{
+	if (bHasUnusedIndices) return true;
+
+	FReferencerIndex& ReferencerIndex =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetReferencerIndex();
+
+	TArray<int32> ReferencerCounts;
+	ReferencerCounts.SetNumUninitialized(Records->Num());
+
+	if (!ReferencerIndex.TryGetReferencerCounts(Records->GetPackageNames(), ReferencerCounts)) return false;
+
+	bHasUnusedIndices = true;
+
+	for (int32 i = 0; i < ReferencerCounts.Num(); ++i)
+	{
+		if (ReferencerCounts[i] == 0)
+		{
+			UnusedIndices.Add(i);
+		}
+	}
+
+	return true;
+}
+
+bool FAdvanceDeletionAssetIndex::EnsureModificationTimes()
+{
+	if (bHasModificationTimes) return true;
+
+	const int32 NumAssets = Records->Num();
+
+	// unknown times are newest, they stay out of the older than filter until their stat arrives
+	ModificationTimes.Init(FDateTime::MaxValue(), NumAssets);
+
+	FAssetSizeCache& AssetSizeCache =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetAssetSizeCache();
+
+	bHasModificationTimes = AssetSizeCache.GetKnownTimestamps(Records->GetPackageNames(), ModificationTimes) == NumAssets;
+
+	if (!bHasModificationTimes)
+	{
+		// saved packages left the cache since the records were requested
+		AssetSizeCache.RequestDiskSizes(*Records, false);
+	}
+
+	AgeOrder.SetNumUninitialized(NumAssets);
+	for (int32 i = 0; i < NumAssets; ++i)
+	{
+		AgeOrder[i] = i;
+	}
+
+	AgeOrder.Sort([this](int32 A, int32 B)
+	{
+		return ModificationTimes[A] < ModificationTimes[B];
+	});
+
+	return bHasModificationTimes;
+}
+
+const TArray<int32>* FAdvanceDeletionAssetIndex::GetSortOrder(FName SortColumn)
+{
+	if (SortColumn == AdvanceDeletionColumns::AssetName) return &NameOrder;
+	if (SortColumn == AdvanceDeletionColumns::AssetClass) return &ClassOrder;
+	if (SortColumn == AdvanceDeletionColumns::DiskSize) return &SizeOrder;
+	if (SortColumn == AdvanceDeletionColumns::ResourceSize) return &ResourceSizeOrder;
+
+	return nullptr;
+}
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "BacgroundTools.h"
+
+FAdvanceDeletionListModel::FAdvanceDeletionListModel(const FFolderRootSet& InFolderRoots, TSharedPtr<FAssetRecordStore> InRecords)
+	: FolderRoots(InFolderRoots)
+	, Records(InRecords)
+{
+	if (!Records.IsValid())
+	{
+		Records = MakeShared<FAssetRecordStore>();
+	}
+
+	IAssetRegistry& AssetRegistry =
+		FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FAdvanceDeletionListModel::OnAssetAdded);
+	AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FAdvanceDeletionListModel::OnAssetRemoved);
+	AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FAdvanceDeletionListModel::OnAssetRenamed);
+	AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FAdvanceDeletionListModel::OnAssetUpdated);
+}
+
+FAdvanceDeletionListModel::~FAdvanceDeletionListModel()
+{
+	if (FAssetRegistryModule* AssetRegistryModule =
+		FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+
+		AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+	}
+}
+
+bool FAdvanceDeletionListModel::ApplyPendingChanges()
+{
+	if (!HasPendingChanges()) return false;
+
+	if (PendingRemovals.Num() > 0)
+	{
+		// Compact once for the whole batch
+		TBitArray<> RecordsToRemove(false, Records->Num());
+		bool bAnyRemoved = false;
+
+		for (const FSoftObjectPath& ObjectPath : PendingRemovals)
+		{
+			const int32 Index = Records->Find(ObjectPath);
+			if (Index != INDEX_NONE)
+			{
+				RecordsToRemove[Index] = true;
+				bAnyRemoved = true;
+			}
+		}
+
+		if (bAnyRemoved)
+		{
+			Records->RemoveAll(RecordsToRemove);
+		}
+
+		PendingRemovals.Reset();
+	}
+
+	// the records keep what they need, the pending FAssetData are dropped right after
+	for (const TPair<FSoftObjectPath, FAssetData>& Upsert : PendingUpserts)
+	{
+		Records->AddOrUpdate(Upsert.Value);
+	}
+
+	PendingUpserts.Reset();
+
+	return true;
+}
+
+void FAdvanceDeletionListModel::RemoveAsset(int32 AssetIndex)
+{
+	Records->RemoveAt(AssetIndex);
+}
+
+bool FAdvanceDeletionListModel::IsUnderRoot(const FAssetData& AssetData) const
+{
+	if (!FolderRoots.ContainsPath(AssetData.PackagePath)) return false;
+
+	return !FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"))
+		.GetPathExclusionRules().IsPathExcluded(AssetData.PackagePath);
+}
+
+bool FAdvanceDeletionListModel::IsTracked(const FSoftObjectPath& ObjectPath) const
+{
+	return Records->Find(ObjectPath) != INDEX_NONE || PendingUpserts.Contains(ObjectPath);
+}
+
+void FAdvanceDeletionListModel::QueueUpsert(const FAssetData& AssetData)
+{
+	const bool bWasEmpty = !HasPendingChanges();
+
+	const FSoftObjectPath ObjectPath = AssetData.GetSoftObjectPath();
+	PendingRemovals.Remove(ObjectPath);
+	PendingUpserts.Add(ObjectPath, AssetData);
+
+	if (bWasEmpty)
+	{
+		OnChangesQueued.ExecuteIfBound();
+	}
+}
+
+void FAdvanceDeletionListModel::QueueRemoval(const FSoftObjectPath& ObjectPath)
+{
+	const bool bWasEmpty = !HasPendingChanges();
+
+	PendingUpserts.Remove(ObjectPath);
+	PendingRemovals.Add(ObjectPath);
+
+	if (bWasEmpty)
+	{
+		OnChangesQueued.ExecuteIfBound();
+	}
+}
+
+#pragma region AssetRegistryEvents
+
+void FAdvanceDeletionListModel::OnAssetAdded(const FAssetData& AssetData)
+{
+	if (!IsUnderRoot(AssetData)) return;
+
+	QueueUpsert(AssetData);
+}
+
+void FAdvanceDeletionListModel::OnAssetRemoved(const FAssetData& AssetData)
+{
+	const FSoftObjectPath ObjectPath = AssetData.GetSoftObjectPath();
+
+	if (!IsTracked(ObjectPath)) return;
+
+	QueueRemoval(ObjectPath);
+}
+
+void FAdvanceDeletionListModel::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	const FSoftObjectPath OldPath(OldObjectPath);
+
+	if (IsTracked(OldPath))
+	{
+		QueueRemoval(OldPath);
+	}
+
+	// Renamed out of the root folder is a plain removal
+	if (IsUnderRoot(AssetData))
+	{
+		QueueUpsert(AssetData);
+	}
+}
+
+void FAdvanceDeletionListModel::OnAssetUpdated(const FAssetData& AssetData)
+{
+	if (Records->Find(AssetData.GetSoftObjectPath()) == INDEX_NONE) return;
+
+	QueueUpsert(AssetData);
+}
+
+#pragma endregion
@@ -4,16 +4,71 @@
 #include "SlateBasics.h"
 #include "BacgroundTools.h"
 #include "Debug.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	// same order as EAdvanceDeletionFilterType
+	const TCHAR* const FilterOptionLabels[] =
+	{
+		TEXT("All assets"),
+		TEXT("Unused only"),
+		TEXT("By class"),
+		TEXT("Prefix mismatch"),
+		TEXT("Larger than"),
+		TEXT("Older than"),
+	};
+}
+
+using SAdvanceDeletionRow = SForwardingTableRow<SAdvanceDeletionTab, int32>;
 
 void SAdvanceDeletionTab::Construct(const FArguments& InArgs)
 {
 	bCanSupportFocus = true;
 
-	StoredAssetData = InArgs._AssetsDataToStore;
+	AssetListModel = InArgs._AssetListModel;
+
+	if (!AssetListModel.IsValid())
+	{
+		AssetListModel = MakeShared<FAdvanceDeletionListModel>(FFolderRootSet(), nullptr);
+	}
+
+	AssetListModel->OnChangesQueued.BindSP(this, &SAdvanceDeletionTab::OnAssetListChangesQueued);
+
+	Records = AssetListModel->GetRecords();
+
+	// sizes are filled on the thread pool, rows show the registry size until then
+	FAssetSizeCache& AssetSizeCache =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetAssetSizeCache();
+
+	AssetSizeCache.OnDiskSizesUpdated.AddSP(this, &SAdvanceDeletionTab::OnAssetDiskSizesUpdated);
+	AssetSizeCache.RequestDiskSizes(*Records, false);
+
+	// memory sizes are measured by the index, again whenever assets are loaded or collected
+	FCoreUObjectDelegates::OnAssetLoaded.AddSP(this, &SAdvanceDeletionTab::OnAssetLoaded);
+	FCoreUObjectDelegates::GetPostGarbageCollect().AddSP(this, &SAdvanceDeletionTab::OnLoadedAssetsChanged);
+
+	for (const TCHAR* FilterOptionLabel : FilterOptionLabels)
+	{
+		FilterOptions.Add(MakeShared<FString>(FilterOptionLabel));
+	}
+
+	FilterSettings.MinSizeBytes = static_cast<int64>(FilterValue) * 1024 * 1024;
+	FilterSettings.MinAgeDays = FilterValue;
+
+	ApplyFilterAndSort();
 
 	FSlateFontInfo TitleTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
 	TitleTextFont.Size = 30;
 
+	// row fonts are looked up once, not per generated row
+	AssetClassFont = GetEmbossedTextFont();
+	AssetClassFont.Size = 10;
+
+	AssetNameFont = GetEmbossedTextFont();
+	AssetNameFont.Size = 15;
+
 	ChildSlot
 		[
 			// Main vertical box
@@ -34,20 +89,14 @@ void SAdvanceDeletionTab::Construct(const FArguments& InArgs)
 			+SVerticalBox::Slot()
 			.AutoHeight()
 			[
-				SNew(SHorizontalBox)
+				ConstructFilterBar()
 			]
 
-			//Third slot for the asset list
+			//Third slot for the asset list, SListView scrolls itself so it can virtualize the rows
 			+SVerticalBox::Slot()
 			.VAlign(VAlign_Fill)
 			[
-				SNew(SScrollBox)
-				
-				+SScrollBox::Slot()
-				[
-					ConstructAssetListView()
-				]
-				
+				ConstructAssetListView()
 			]
 
 			//Foutrh slot for 3 buttons
@@ -81,98 +130,241 @@ void SAdvanceDeletionTab::Construct(const FArguments& InArgs)
 		];
 }
 
-TSharedRef<SListView<TSharedPtr<FAssetData>>> SAdvanceDeletionTab::ConstructAssetListView()
+TSharedRef<SListView<TSharedPtr<int32>>> SAdvanceDeletionTab::ConstructAssetListView()
 {
-	ConstructedAssetListView = SNew(SListView< TSharedPtr <FAssetData> >)
+	ConstructedAssetListView = SNew(SListView< TSharedPtr <int32> >)
 		.ItemHeight(24.f)
-		.ListItemsSource(&StoredAssetData)
-		.OnGenerateRow(this, &SAdvanceDeletionTab::OnGenerateRowForList);
+		.ListItemsSource(&AssetListItems)
+		.OnGenerateRow(this, &SAdvanceDeletionTab::OnGenerateRowForList)
+		.HeaderRow(ConstructHeaderRow());
 
 	return ConstructedAssetListView.ToSharedRef();
 }
 
+TSharedRef<SHeaderRow> SAdvanceDeletionTab::ConstructHeaderRow()
+{
+	return SNew(SHeaderRow)
+
+		+ SHeaderRow::Column(AdvanceDeletionColumns::CheckBox)
+		.FixedWidth(24.f)
+		.DefaultLabel(FText::GetEmpty())
+
+		+ SHeaderRow::Column(AdvanceDeletionColumns::AssetClass)
+		.FillWidth(.2f)
+		.HAlignCell(HAlign_Center)
+		.DefaultLabel(FText::FromString(TEXT("Class")))
+		.SortMode(this, &SAdvanceDeletionTab::GetColumnSortMode, AdvanceDeletionColumns::AssetClass)
+		.OnSort(this, &SAdvanceDeletionTab::OnColumnSortModeChanged)
+
+		+ SHeaderRow::Column(AdvanceDeletionColumns::AssetName)
+		.FillWidth(.6f)
+		.DefaultLabel(FText::FromString(TEXT("Name")))
+		.SortMode(this, &SAdvanceDeletionTab::GetColumnSortMode, AdvanceDeletionColumns::AssetName)
+		.OnSort(this, &SAdvanceDeletionTab::OnColumnSortModeChanged)
+
+		+ SHeaderRow::Column(AdvanceDeletionColumns::DiskSize)
+		.FixedWidth(90.f)
+		.HAlignCell(HAlign_Right)
+		.DefaultLabel(FText::FromString(TEXT("Disk Size")))
+		.SortMode(this, &SAdvanceDeletionTab::GetColumnSortMode, AdvanceDeletionColumns::DiskSize)
+		.OnSort(this, &SAdvanceDeletionTab::OnColumnSortModeChanged)
+
+		+ SHeaderRow::Column(AdvanceDeletionColumns::ResourceSize)
+		.FixedWidth(90.f)
+		.HAlignCell(HAlign_Right)
+		.DefaultLabel(FText::FromString(TEXT("Memory")))
+		.SortMode(this, &SAdvanceDeletionTab::GetColumnSortMode, AdvanceDeletionColumns::ResourceSize)
+		.OnSort(this, &SAdvanceDeletionTab::OnColumnSortModeChanged)
+
+		+ SHeaderRow::Column(AdvanceDeletionColumns::DeleteButton)
+		.FixedWidth(80.f)
+		.HAlignCell(HAlign_Right)
+		.DefaultLabel(FText::GetEmpty());
+}
+
+int32 SAdvanceDeletionTab::GetAssetIndex(const TSharedPtr<int32>& Item) const
+{
+	if (!Item.IsValid()) return INDEX_NONE;
+
+	return Records->IsValidIndex(*Item) ? *Item : INDEX_NONE;
+}
+
+void SAdvanceDeletionTab::RebuildAssetListItems()
+{
+	AssetListItems.Reset(ViewIndices->Num());
+
+	TArray<int32>& ViewArray = *ViewIndices;
+
+	for (int32 i = 0; i < ViewArray.Num(); ++i)
+	{
+		// aliasing constructor : shares ViewIndices' reference count, points at the element
+		AssetListItems.Emplace(ViewIndices, &ViewArray[i]);
+	}
+}
+
 #pragma region RowWidgetForAssetListView
 
-TSharedRef<ITableRow> SAdvanceDeletionTab::OnGenerateRowForList(TSharedPtr<FAssetData> AssetDataToDisplay,
+TSharedRef<ITableRow> SAdvanceDeletionTab::OnGenerateRowForList(TSharedPtr<int32> ItemToDisplay,
 	const TSharedRef<STableViewBase>& OwnerTable)
 {
-	if (!AssetDataToDisplay.IsValid()) return SNew(STableRow< TSharedPtr <FAssetData> >, OwnerTable);
+	if (GetAssetIndex(ItemToDisplay) == INDEX_NONE) return SNew(STableRow< TSharedPtr <int32> >, OwnerTable);
+
+	return SNew(SAdvanceDeletionRow, OwnerTable)
+		.Item(ItemToDisplay)
+		.OwnerTab(SharedThis(this));
+}
+
+TSharedRef<SWidget> SAdvanceDeletionTab::ConstructWidgetForColumn(const FName& ColumnName,
+	const TSharedPtr<int32>& ItemToDisplay)
+{
+	const int32 RecordIndex = GetAssetIndex(ItemToDisplay);
+
+	if (RecordIndex == INDEX_NONE) return SNullWidget::NullWidget;
+
+	// first : check box
+	if (ColumnName == AdvanceDeletionColumns::CheckBox)
+	{
+		return ConstructCheckBox(ItemToDisplay);
+	}
+
+	// second : asset class name
+	if (ColumnName == AdvanceDeletionColumns::AssetClass)
+	{
+		return ConstructTextForRowWidget(GetAssetClassText(RecordIndex), AssetClassFont);
+	}
+
+	// third : display asset name
+	if (ColumnName == AdvanceDeletionColumns::AssetName)
+	{
+		TSharedRef<STextBlock> AssetNameText =
+			ConstructTextForRowWidget(FText::FromName(Records->GetAssetName(RecordIndex)), AssetNameFont);
+
+		AssetNameText->SetToolTipText(TAttribute<FText>::Create(
+			TAttribute<FText>::FGetter::CreateSP(this, &SAdvanceDeletionTab::GetAssetToolTipText, ItemToDisplay)));
 
+		return AssetNameText;
+	}
+
+	// disk footprint, the row asks for it ahead of the background fill
+	if (ColumnName == AdvanceDeletionColumns::DiskSize)
+	{
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetAssetSizeCache()
+			.RequestDiskSize(Records->GetPackageName(RecordIndex), Records->HasAnyFlags(RecordIndex, EAssetRecordFlags::Map), true);
+
+		return SNew(STextBlock)
+			.Text(this, &SAdvanceDeletionTab::GetDiskSizeText, ItemToDisplay)
+			.Font(AssetClassFont)
+			.ColorAndOpacity(FColor::White);
+	}
+
+	if (ColumnName == AdvanceDeletionColumns::ResourceSize)
+	{
+		return SNew(STextBlock)
+			.Text(this, &SAdvanceDeletionTab::GetResourceSizeText, ItemToDisplay)
+			.Font(AssetClassFont)
+			.ColorAndOpacity(FColor::White);
+	}
+
+	//fourth : buttom
+	if (ColumnName == AdvanceDeletionColumns::DeleteButton)
+	{
+		return ConstructButtonForRowWidget(ItemToDisplay);
+	}
+
+	return SNullWidget::NullWidget;
+}
+
+const FText& SAdvanceDeletionTab::GetAssetClassText(int32 RecordIndex)
+{
 	// UE 5 ̻ AssetClass -> AssetClassPath  AssetClassPath .  ȿ ٳ ؾ Ŭ
-	const FString DisplayAssetClass = AssetDataToDisplay->AssetClassPath.GetAssetName().ToString();
-	const FString DisplayAssetName = AssetDataToDisplay->AssetName.ToString();
+	const int32 ClassIndex = Records->GetClassIndex(RecordIndex);
 
-	FSlateFontInfo AssetClassFont = GetEmbossedTextFont();
-	AssetClassFont.Size = 10;
+	if (const FText* CachedText = AssetClassTextCache.Find(ClassIndex))
+	{
+		return *CachedText;
+	}
 
-	FSlateFontInfo AssetNameFont = GetEmbossedTextFont();
-	AssetNameFont.Size = 15;
+	return AssetClassTextCache.Add(ClassIndex, FText::FromName(Records->GetClassPath(RecordIndex).GetAssetName()));
+}
 
+FText SAdvanceDeletionTab::GetDiskSizeText(TSharedPtr<int32> Item) const
+{
+	const int32 RecordIndex = GetAssetIndex(Item);
 
-	TSharedRef < STableRow < TSharedPtr <FAssetData> > > ListViewRowWidget =
-		SNew(STableRow < TSharedPtr<FAssetData> >, OwnerTable)
-		[
-			SNew(SHorizontalBox)
+	if (RecordIndex == INDEX_NONE) return FText::GetEmpty();
 
-				// first : check box
-				+ SHorizontalBox::Slot()
-				.HAlign(HAlign_Left)
-				.VAlign(VAlign_Bottom)
-				.FillWidth(.02f)
-				[
-					ConstructCheckBox(AssetDataToDisplay)
-				]
+	FAssetDiskSize DiskSize;
 
-				// second : asset class name
-				+ SHorizontalBox::Slot()
-				.HAlign(HAlign_Center)
-				.VAlign(VAlign_Fill)
-				.FillWidth(.2f)
-				[
-					ConstructTextForRowWidget(DisplayAssetClass, AssetClassFont)
-				]
+	if (FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetAssetSizeCache()
+		.FindDiskSize(Records->GetPackageName(RecordIndex), DiskSize))
+	{
+		return FText::AsMemory(DiskSize.Footprint);
+	}
 
+	return FText::AsMemory(Records->GetDiskSize(RecordIndex));
+}
 
-				// third : display asset name
-				+SHorizontalBox::Slot()
-				.HAlign(HAlign_Left)
-				.VAlign(VAlign_Fill)
-				[
-					ConstructTextForRowWidget(DisplayAssetName, AssetNameFont)
-				]
+FText SAdvanceDeletionTab::GetResourceSizeText(TSharedPtr<int32> Item) const
+{
+	const int32 RecordIndex = GetAssetIndex(Item);
 
-				//fourth : buttom
-				+SHorizontalBox::Slot()
-				.HAlign(HAlign_Right)
-				.VAlign(VAlign_Fill)
-				[
-					ConstructButtonForRowWidget(AssetDataToDisplay)
-				]
-		];
+	if (RecordIndex == INDEX_NONE) return FText::GetEmpty();
 
-	return ListViewRowWidget;
+	// unloaded assets have no resource size to report
+	const int64 ResourceSize = Records->GetResourceSize(RecordIndex);
+
+	return ResourceSize >= 0 ? FText::AsMemory(ResourceSize) : FText::FromString(TEXT("-"));
 }
 
+FText SAdvanceDeletionTab::GetAssetToolTipText(TSharedPtr<int32> Item) const
+{
+	const int32 RecordIndex = GetAssetIndex(Item);
+
+	if (RecordIndex == INDEX_NONE) return FText::GetEmpty();
+
+	const FAssetData AssetData = Records->GetAssetData(RecordIndex);
 
-TSharedRef<SCheckBox> SAdvanceDeletionTab::ConstructCheckBox(const TSharedPtr<FAssetData>& AssetDataToDisplay)
+	if (!AssetData.IsValid()) return FText::FromName(Records->GetPackageName(RecordIndex));
+
+	FString ToolTip = FString::Printf(TEXT("%s\nClass : %s\nDisk size : %s"),
+		*AssetData.GetObjectPathString(),
+		*AssetData.AssetClassPath.GetAssetName().ToString(),
+		*FText::AsMemory(Records->GetDiskSize(RecordIndex)).ToString());
+
+	// a few tags are enough to tell assets of the same name apart
+	constexpr int32 MaxToolTipTags = 4;
+	int32 NumTags = 0;
+
+	for (const TPair<FName, FAssetTagValueRef>& Tag : AssetData.TagsAndValues)
+	{
+		if (NumTags++ == MaxToolTipTags) break;
+
+		ToolTip += FString::Printf(TEXT("\n%s : %s"), *Tag.Key.ToString(), *Tag.Value.AsString());
+	}
+
+	return FText::FromString(ToolTip);
+}
+
+TSharedRef<SCheckBox> SAdvanceDeletionTab::ConstructCheckBox(const TSharedPtr<int32>& ItemToDisplay)
 {
 	TSharedRef<SCheckBox> ConstructedCheckBox = SNew(SCheckBox)
 		.Type(ESlateCheckBoxType::CheckBox)
-		.OnCheckStateChanged(this, &SAdvanceDeletionTab::OnCheckBoxStateChanged, AssetDataToDisplay)
+		.OnCheckStateChanged(this, &SAdvanceDeletionTab::OnCheckBoxStateChanged, ItemToDisplay)
+		.IsChecked(this, &SAdvanceDeletionTab::GetCheckBoxState, ItemToDisplay)
 		.Visibility(EVisibility::Visible);
 
 	return ConstructedCheckBox;
 }
 
-void SAdvanceDeletionTab::OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FAssetData> AssetData)
+void SAdvanceDeletionTab::OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<int32> Item)
 {
 	switch (NewState)
 	{
 	case ECheckBoxState::Unchecked:
-		Debug::PrintMessage(AssetData->AssetName.ToString() + TEXT(" is unchecked"), FColor::Red);
+		AssetListModel->SetSelected(GetAssetIndex(Item), false);
 		break;
 	case ECheckBoxState::Checked:
-		Debug::PrintMessage(AssetData->AssetName.ToString() + TEXT(" is checked"), FColor::Green);
+		AssetListModel->SetSelected(GetAssetIndex(Item), true);
 		break;
 	case ECheckBoxState::Undetermined:
 		break;
@@ -181,46 +373,53 @@ void SAdvanceDeletionTab::OnCheckBoxStateChanged(ECheckBoxState NewState, TShare
 	}
 }
 
-TSharedRef<SButton> SAdvanceDeletionTab::ConstructButtonForRowWidget(const TSharedPtr<FAssetData>& AssetDataToDisplay)
+ECheckBoxState SAdvanceDeletionTab::GetCheckBoxState(TSharedPtr<int32> Item) const
+{
+	return AssetListModel->IsSelected(GetAssetIndex(Item)) ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+TSharedRef<SButton> SAdvanceDeletionTab::ConstructButtonForRowWidget(const TSharedPtr<int32>& ItemToDisplay)
 {
 	TSharedRef<SButton> ConstructButton = SNew(SButton)
 		.Text(FText::FromString(TEXT("Delete")))
-		.OnClicked(this, &SAdvanceDeletionTab::OnDeleteButtonClicked, AssetDataToDisplay);
+		.OnClicked(this, &SAdvanceDeletionTab::OnDeleteButtonClicked, ItemToDisplay);
 
 	return ConstructButton;
 }
 
-FReply SAdvanceDeletionTab::OnDeleteButtonClicked(TSharedPtr<FAssetData> ClickedAssetdata)
+FReply SAdvanceDeletionTab::OnDeleteButtonClicked(TSharedPtr<int32> ClickedItem)
 {
+	const int32 RecordIndex = GetAssetIndex(ClickedItem);
+
+	if (RecordIndex == INDEX_NONE) return FReply::Handled();
+
+	// the only row action needing the full registry data
+	const FAssetData ClickedAssetData = Records->GetAssetData(RecordIndex);
+
+	if (!ClickedAssetData.IsValid()) return FReply::Handled();
+
 	FBacgroundToolsModule& BacgroundToolsModule = 
 		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
 
-	const bool bAssetDeleted = BacgroundToolsModule.DeleteSingleAssetForAssetList(*ClickedAssetdata.Get());
+	const bool bAssetDeleted = BacgroundToolsModule.DeleteSingleAssetForAssetList(ClickedAssetData);
 
 	if(bAssetDeleted)
 	{
 		//Updationg the list source items
-		if (StoredAssetData.Contains(ClickedAssetdata))
-		{
-			StoredAssetData.Remove(ClickedAssetdata);
-		}
-
-		// refresh the list
-		/*RefreshAssetListView();*/
-		if (ConstructedAssetListView.IsValid())
-		{
-			ConstructedAssetListView->RequestListRefresh();
-		}
+		AssetListModel->RemoveAsset(RecordIndex);
+
+		// records moved, every item index has to be rebuilt along with the rows
+		OnAssetRecordsChanged();
 	}
 
 	return FReply::Handled();
 }
 
 
-TSharedRef<STextBlock> SAdvanceDeletionTab::ConstructTextForRowWidget(const FString& TextContent, const FSlateFontInfo& FontToUse)
+TSharedRef<STextBlock> SAdvanceDeletionTab::ConstructTextForRowWidget(const FText& TextContent, const FSlateFontInfo& FontToUse)
 {
 	TSharedRef<STextBlock> ConstructTextBlock = SNew(STextBlock)
-		.Text(FText::FromString(TextContent))
+		.Text(TextContent)
 		.Font(FontToUse)
 		.ColorAndOpacity(FColor::White);
 
@@ -265,19 +464,45 @@ TSharedRef<SButton> SAdvanceDeletionTab::ConstructDeselectAllButton()
 
 FReply SAdvanceDeletionTab::OnDeleteAllButtonClicked()
 {
-	Debug::PrintMessage(TEXT("Delete All Button Clicked"), FColor::Cyan);
+	TArray<FAssetData> AssetDataToDelete;
+	AssetListModel->GetSelectedAssets(AssetDataToDelete);
+
+	if (AssetDataToDelete.Num() == 0)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No asset currently selected"));
+		return FReply::Handled();
+	}
+
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	// one deletion queue flush and one confirmation for the whole selection,
+	// the deleted rows leave the list through the registry events on the next frame
+	BacgroundToolsModule.DeleteMultipleAssetsForAssetList(AssetDataToDelete);
+
 	return FReply::Handled();
 }
 
 FReply SAdvanceDeletionTab::OnSelectAllButtonClicked()
 {
-	Debug::PrintMessage(TEXT("Select All Button Clicked"), FColor::Cyan);
+	// check boxes read the selection bits, no need to rebuild the rows
+	if (FilterSettings.Type == EAdvanceDeletionFilterType::All)
+	{
+		AssetListModel->SelectAll();
+		return FReply::Handled();
+	}
+
+	// only what the filter shows
+	for (const int32 AssetIndex : *ViewIndices)
+	{
+		AssetListModel->SetSelected(AssetIndex, true);
+	}
 	return FReply::Handled();
 }
 
 FReply SAdvanceDeletionTab::OnDeselectAllButtonClicked()
 {
-	Debug::PrintMessage(TEXT("Deselect All Button Clicked"), FColor::Cyan);
+	AssetListModel->DeselectAll();
 	return FReply::Handled();
 }
 
@@ -302,3 +527,318 @@ void SAdvanceDeletionTab::RefreshAssetListView()
 		ConstructedAssetListView->RebuildList();
 	}
 }
+
+void SAdvanceDeletionTab::OnAssetListChangesQueued()
+{
+	if (bIsApplyChangesTimerRegistered) return;
+
+	// registry events are batched, an import or a save burst rebuilds the index once per period instead of once per frame
+	constexpr double AssetListRebuildPeriod = 1.0;
+
+	const double Delay = FMath::Max(0.0, LastAssetRecordsChangeTime + AssetListRebuildPeriod - FPlatformTime::Seconds());
+
+	RegisterActiveTimer(static_cast<float>(Delay), FWidgetActiveTimerDelegate::CreateSP(this, &SAdvanceDeletionTab::ApplyAssetListChanges));
+	bIsApplyChangesTimerRegistered = true;
+}
+
+EActiveTimerReturnType SAdvanceDeletionTab::ApplyAssetListChanges(double InCurrentTime, float InDeltaTime)
+{
+	bIsApplyChangesTimerRegistered = false;
+
+	if (AssetListModel->ApplyPendingChanges())
+	{
+		OnAssetRecordsChanged();
+	}
+
+	return EActiveTimerReturnType::Stop;
+}
+
+#pragma region FilterAndSort
+
+void SAdvanceDeletionTab::ApplyFilterAndSort()
+{
+	if (!AssetIndex.IsBuilt())
+	{
+		AssetIndex.Build(*Records);
+		RefreshClassOptions();
+	}
+
+	// only index arrays are walked here, the registry is not queried
+	ViewIndices = MakeShared<TArray<int32>>();
+	bIsViewPending = !AssetIndex.BuildView(FilterSettings, SortColumn, SortMode, *ViewIndices);
+
+	RebuildAssetListItems();
+	RefreshAssetListView();
+
+	if (bIsViewPending && !bIsPendingViewRetryRegistered)
+	{
+		constexpr float PendingViewRetryPeriod = .5f;
+
+		RegisterActiveTimer(PendingViewRetryPeriod, FWidgetActiveTimerDelegate::CreateSP(this, &SAdvanceDeletionTab::RetryPendingView));
+		bIsPendingViewRetryRegistered = true;
+	}
+}
+
+EActiveTimerReturnType SAdvanceDeletionTab::RetryPendingView(double InCurrentTime, float InDeltaTime)
+{
+	bIsPendingViewRetryRegistered = false;
+
+	// the filter may have changed to one that needs nothing in the meantime
+	if (bIsViewPending)
+	{
+		ApplyFilterAndSort();
+	}
+
+	return EActiveTimerReturnType::Stop;
+}
+
+void SAdvanceDeletionTab::OnAssetRecordsChanged()
+{
+	LastAssetRecordsChangeTime = FPlatformTime::Seconds();
+
+	AssetIndex.Reset();
+	ApplyFilterAndSort();
+
+	// new assets only, cached and queued ones are skipped
+	FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).GetAssetSizeCache()
+		.RequestDiskSizes(*Records, false);
+}
+
+void SAdvanceDeletionTab::OnAssetDiskSizesUpdated()
+{
+	if (bIsDiskSizeRefreshRegistered) return;
+
+	// size text is polled by the rows, only the size order and the size and age filters need the refresh
+	constexpr float DiskSizeRefreshPeriod = .5f;
+
+	RegisterActiveTimer(DiskSizeRefreshPeriod, FWidgetActiveTimerDelegate::CreateSP(this, &SAdvanceDeletionTab::RefreshDiskSizes));
+	bIsDiskSizeRefreshRegistered = true;
+}
+
+EActiveTimerReturnType SAdvanceDeletionTab::RefreshDiskSizes(double InCurrentTime, float InDeltaTime)
+{
+	bIsDiskSizeRefreshRegistered = false;
+
+	AssetIndex.RefreshDiskSizes();
+
+	if (SortColumn == AdvanceDeletionColumns::DiskSize || FilterSettings.Type == EAdvanceDeletionFilterType::LargerThan ||
+		FilterSettings.Type == EAdvanceDeletionFilterType::OlderThan)
+	{
+		ApplyFilterAndSort();
+	}
+
+	return EActiveTimerReturnType::Stop;
+}
+
+void SAdvanceDeletionTab::OnLoadedAssetsChanged()
+{
+	if (bIsResourceSizeRefreshRegistered) return;
+
+	// a level load fires once per asset, the records are measured once for the whole burst
+	constexpr float ResourceSizeRefreshPeriod = 1.f;
+
+	RegisterActiveTimer(ResourceSizeRefreshPeriod, FWidgetActiveTimerDelegate::CreateSP(this, &SAdvanceDeletionTab::RefreshResourceSizes));
+	bIsResourceSizeRefreshRegistered = true;
+}
+
+EActiveTimerReturnType SAdvanceDeletionTab::RefreshResourceSizes(double InCurrentTime, float InDeltaTime)
+{
+	bIsResourceSizeRefreshRegistered = false;
+
+	// memory text is polled by the rows, only the memory order needs the view rebuilt
+	if (AssetIndex.RefreshResourceSizes() && SortColumn == AdvanceDeletionColumns::ResourceSize)
+	{
+		ApplyFilterAndSort();
+	}
+
+	return EActiveTimerReturnType::Stop;
+}
+
+TSharedRef<SWidget> SAdvanceDeletionTab::ConstructFilterBar()
+{
+	return SNew(SHorizontalBox)
+
+		// filter type
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding(5.f)
+		[
+			SNew(SComboBox< TSharedPtr <FString> >)
+			.OptionsSource(&FilterOptions)
+			.OnGenerateWidget(this, &SAdvanceDeletionTab::OnGenerateComboContent)
+			.OnSelectionChanged(this, &SAdvanceDeletionTab::OnFilterOptionSelected)
+			[
+				SNew(STextBlock)
+				.Text(this, &SAdvanceDeletionTab::GetFilterOptionText)
+			]
+		]
+
+		// class, for "By class"
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding(5.f)
+		[
+			SAssignNew(ClassComboBox, SComboBox< TSharedPtr <FString> >)
+			.OptionsSource(&ClassOptions)
+			.OnGenerateWidget(this, &SAdvanceDeletionTab::OnGenerateComboContent)
+			.OnSelectionChanged(this, &SAdvanceDeletionTab::OnClassOptionSelected)
+			.Visibility(this, &SAdvanceDeletionTab::GetClassComboVisibility)
+			[
+				SNew(STextBlock)
+				.Text(this, &SAdvanceDeletionTab::GetClassOptionText)
+			]
+		]
+
+		// N, for "Larger than" and "Older than"
+		+ SHorizontalBox::Slot()
+		.AutoWidth()
+		.Padding(5.f)
+		[
+			SNew(SHorizontalBox)
+			.Visibility(this, &SAdvanceDeletionTab::GetFilterValueVisibility)
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				SNew(SBox)
+				.MinDesiredWidth(80.f)
+				[
+					SNew(SSpinBox<int32>)
+					.MinValue(0)
+					.MaxValue(100000)
+					.Value(this, &SAdvanceDeletionTab::GetFilterValue)
+					.OnValueCommitted(this, &SAdvanceDeletionTab::OnFilterValueCommitted)
+				]
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(5.f, 0.f)
+			[
+				SNew(STextBlock)
+				.Text(this, &SAdvanceDeletionTab::GetFilterValueUnitText)
+			]
+		]
+
+		+ SHorizontalBox::Slot()
+		.FillWidth(1.f)
+		.HAlign(HAlign_Right)
+		.VAlign(VAlign_Center)
+		.Padding(5.f)
+		[
+			SNew(STextBlock)
+			.Text(this, &SAdvanceDeletionTab::GetViewCountText)
+		];
+}
+
+void SAdvanceDeletionTab::RefreshClassOptions()
+{
+	ClassOptions.Reset();
+	ClassOptionPaths = AssetIndex.GetAssetClasses();
+
+	for (const FTopLevelAssetPath& ClassPath : ClassOptionPaths)
+	{
+		ClassOptions.Add(MakeShared<FString>(ClassPath.GetAssetName().ToString()));
+	}
+
+	if (ClassComboBox.IsValid())
+	{
+		ClassComboBox->RefreshOptions();
+	}
+}
+
+TSharedRef<SWidget> SAdvanceDeletionTab::OnGenerateComboContent(TSharedPtr<FString> Option)
+{
+	return SNew(STextBlock)
+		.Text(FText::FromString(*Option.Get()));
+}
+
+void SAdvanceDeletionTab::OnFilterOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo)
+{
+	const int32 OptionIndex = FilterOptions.Find(SelectedOption);
+
+	if (OptionIndex == INDEX_NONE) return;
+
+	FilterSettings.Type = static_cast<EAdvanceDeletionFilterType>(OptionIndex);
+
+	// "By class" without a class yet shows the first one
+	if (FilterSettings.Type == EAdvanceDeletionFilterType::ByClass &&
+		FilterSettings.AssetClass.IsNull() && ClassOptionPaths.Num() > 0)
+	{
+		FilterSettings.AssetClass = ClassOptionPaths[0];
+	}
+
+	ApplyFilterAndSort();
+}
+
+void SAdvanceDeletionTab::OnClassOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo)
+{
+	const int32 OptionIndex = ClassOptions.Find(SelectedOption);
+
+	if (!ClassOptionPaths.IsValidIndex(OptionIndex)) return;
+
+	FilterSettings.AssetClass = ClassOptionPaths[OptionIndex];
+
+	ApplyFilterAndSort();
+}
+
+FText SAdvanceDeletionTab::GetFilterOptionText() const
+{
+	return FText::FromString(FilterOptionLabels[static_cast<int32>(FilterSettings.Type)]);
+}
+
+FText SAdvanceDeletionTab::GetClassOptionText() const
+{
+	if (FilterSettings.AssetClass.IsNull()) return FText::FromString(TEXT("Class"));
+
+	return FText::FromName(FilterSettings.AssetClass.GetAssetName());
+}
+
+EVisibility SAdvanceDeletionTab::GetClassComboVisibility() const
+{
+	return FilterSettings.Type == EAdvanceDeletionFilterType::ByClass ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+void SAdvanceDeletionTab::OnFilterValueCommitted(int32 NewValue, ETextCommit::Type CommitType)
+{
+	FilterValue = NewValue;
+
+	FilterSettings.MinSizeBytes = static_cast<int64>(FilterValue) * 1024 * 1024;
+	FilterSettings.MinAgeDays = FilterValue;
+
+	ApplyFilterAndSort();
+}
+
+EVisibility SAdvanceDeletionTab::GetFilterValueVisibility() const
+{
+	return FilterSettings.Type == EAdvanceDeletionFilterType::LargerThan ||
+		FilterSettings.Type == EAdvanceDeletionFilterType::OlderThan ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+FText SAdvanceDeletionTab::GetFilterValueUnitText() const
+{
+	return FText::FromString(FilterSettings.Type == EAdvanceDeletionFilterType::LargerThan ? TEXT("MB") : TEXT("days"));
+}
+
+FText SAdvanceDeletionTab::GetViewCountText() const
+{
+	return FText::FromString(FString::Printf(bIsViewPending ? TEXT("Showing %d of %d, still loading") : TEXT("Showing %d of %d"),
+		ViewIndices->Num(), Records->Num()));
+}
+
+EColumnSortMode::Type SAdvanceDeletionTab::GetColumnSortMode(FName ColumnName) const
+{
+	return SortColumn == ColumnName ? SortMode : EColumnSortMode::None;
+}
+
+void SAdvanceDeletionTab::OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnName,
+	EColumnSortMode::Type NewSortMode)
+{
+	SortColumn = ColumnName;
+	SortMode = NewSortMode;
+
+	ApplyFilterAndSort();
+}
+
+#pragma endregion
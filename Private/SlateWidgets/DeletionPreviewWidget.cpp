@@ -0,0 +1,433 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/DeletionPreviewWidget.h"
+#include "SlateWidgets/DependencyGraphView.h"
+#include "SlateBasics.h"
+#include "Widgets/Input/SSpinBox.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "Settings/BacgroundToolsSettings.h"
+#include "BacgroundTools.h"
+#include "Debug.h"
+
+using SDeletionPreviewRow = SForwardingTableRow<SDeletionPreviewTab, FDeletionPreviewEntry>;
+
+void SDeletionPreviewTab::Construct(const FArguments& InArgs)
+{
+	bCanSupportFocus = true;
+
+	RowFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	RowFont.Size = 10;
+
+	FSlateFontInfo TitleTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	TitleTextFont.Size = 30;
+
+	ChildSlot
+		[
+			SNew(SVerticalBox)
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(TEXT("Deletion Preview")))
+				.Font(TitleTextFont)
+				.Justification(ETextJustify::Center)
+				.ColorAndOpacity(FColor::White)
+			]
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.f)
+				.VAlign(VAlign_Center)
+				.Padding(5.f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SDeletionPreviewTab::GetSummaryText)
+				]
+
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.VAlign(VAlign_Center)
+				.Padding(5.f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SDeletionPreviewTab::GetGraphStatusText)
+				]
+
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.VAlign(VAlign_Center)
+				.Padding(5.f)
+				[
+					SNew(STextBlock)
+					.Text(FText::FromString(TEXT("Graph depth")))
+				]
+
+				// committed only, every drag step would rebuild the graph
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.VAlign(VAlign_Center)
+				.Padding(5.f)
+				[
+					SNew(SSpinBox<int32>)
+					.MinValue(1)
+					.MaxValue(8)
+					.MinDesiredWidth(50.f)
+					.Value(this, &SDeletionPreviewTab::GetGraphDepth)
+					.OnValueCommitted(this, &SDeletionPreviewTab::OnGraphDepthCommitted)
+				]
+			]
+
+			+ SVerticalBox::Slot()
+			.VAlign(VAlign_Fill)
+			[
+				SNew(SSplitter)
+				.Orientation(Orient_Horizontal)
+
+				+ SSplitter::Slot()
+				.Value(.55f)
+				[
+					SAssignNew(EntryListView, SListView< TSharedPtr <FDeletionPreviewEntry> >)
+					.ItemHeight(24.f)
+					.ListItemsSource(&EntryListItems)
+					.SelectionMode(ESelectionMode::Single)
+					.OnGenerateRow(this, &SDeletionPreviewTab::OnGenerateRowForList)
+					.OnSelectionChanged(this, &SDeletionPreviewTab::OnEntrySelectionChanged)
+					.HeaderRow(ConstructHeaderRow())
+				]
+
+				+ SSplitter::Slot()
+				.Value(.45f)
+				[
+					SAssignNew(GraphView, SDependencyGraphView)
+					.OnNodeClicked(this, &SDeletionPreviewTab::OnGraphNodeClicked)
+				]
+			]
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Delete Checked"), &SDeletionPreviewTab::OnDeleteButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Select All"), &SDeletionPreviewTab::OnSelectAllButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Deselect All"), &SDeletionPreviewTab::OnDeselectAllButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Cancel"), &SDeletionPreviewTab::OnCancelButtonClicked)
+				]
+			]
+		];
+
+	SetPreview(InArgs._Preview);
+}
+
+void SDeletionPreviewTab::SetPreview(TSharedPtr<FDeletionPreview> InPreview)
+{
+	Preview = InPreview;
+
+	// everything the user asked to delete starts checked, referenced assets are flagged in their column
+	Selection.Init(true, Preview.IsValid() ? Preview->GetEntries().Num() : 0);
+
+	RebuildEntryListItems();
+
+	GraphView->SetPreview(Preview);
+}
+
+void SDeletionPreviewTab::RebuildEntryListItems()
+{
+	EntryListItems.Reset();
+
+	if (Preview.IsValid())
+	{
+		for (FDeletionPreviewEntry& Entry : Preview->GetEntries())
+		{
+			EntryListItems.Emplace(Preview, &Entry);
+		}
+	}
+
+	if (EntryListView.IsValid())
+	{
+		EntryListView->ClearSelection();
+		EntryListView->RequestListRefresh();
+	}
+}
+
+int32 SDeletionPreviewTab::GetEntryIndex(const TSharedPtr<FDeletionPreviewEntry>& Entry) const
+{
+	if (!Entry.IsValid() || !Preview.IsValid()) return INDEX_NONE;
+
+	const TArray<FDeletionPreviewEntry>& Entries = Preview->GetEntries();
+	const int32 EntryIndex = static_cast<int32>(Entry.Get() - Entries.GetData());
+
+	return Entries.IsValidIndex(EntryIndex) ? EntryIndex : INDEX_NONE;
+}
+
+TSharedRef<SHeaderRow> SDeletionPreviewTab::ConstructHeaderRow()
+{
+	return SNew(SHeaderRow)
+
+		+ SHeaderRow::Column(DeletionPreviewColumns::CheckBox)
+		.FixedWidth(24.f)
+		.DefaultLabel(FText::GetEmpty())
+
+		+ SHeaderRow::Column(DeletionPreviewColumns::AssetClass)
+		.FillWidth(.2f)
+		.DefaultLabel(FText::FromString(TEXT("Class")))
+
+		+ SHeaderRow::Column(DeletionPreviewColumns::AssetName)
+		.FillWidth(.4f)
+		.DefaultLabel(FText::FromString(TEXT("Name")))
+
+		+ SHeaderRow::Column(DeletionPreviewColumns::DiskSize)
+		.FixedWidth(90.f)
+		.DefaultLabel(FText::FromString(TEXT("Size")))
+
+		+ SHeaderRow::Column(DeletionPreviewColumns::Modified)
+		.FixedWidth(120.f)
+		.DefaultLabel(FText::FromString(TEXT("Modified")))
+
+		+ SHeaderRow::Column(DeletionPreviewColumns::Referencers)
+		.FixedWidth(90.f)
+		.DefaultLabel(FText::FromString(TEXT("Referencers")));
+}
+
+TSharedRef<ITableRow> SDeletionPreviewTab::OnGenerateRowForList(TSharedPtr<FDeletionPreviewEntry> Entry,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!Entry.IsValid()) return SNew(STableRow< TSharedPtr <FDeletionPreviewEntry> >, OwnerTable);
+
+	return SNew(SDeletionPreviewRow, OwnerTable)
+		.Item(Entry)
+		.OwnerTab(SharedThis(this));
+}
+
+TSharedRef<SWidget> SDeletionPreviewTab::ConstructWidgetForColumn(const FName& ColumnName,
+	const TSharedPtr<FDeletionPreviewEntry>& Entry)
+{
+	if (ColumnName == DeletionPreviewColumns::CheckBox)
+	{
+		return SNew(SCheckBox)
+			.Type(ESlateCheckBoxType::CheckBox)
+			.OnCheckStateChanged(this, &SDeletionPreviewTab::OnCheckBoxStateChanged, Entry)
+			.IsChecked(this, &SDeletionPreviewTab::GetCheckBoxState, Entry);
+	}
+
+	FText Text;
+	FColor Color = FColor::White;
+
+	if (ColumnName == DeletionPreviewColumns::AssetClass)
+	{
+		Text = FText::FromName(Entry->AssetData.AssetClassPath.GetAssetName());
+	}
+	else if (ColumnName == DeletionPreviewColumns::AssetName)
+	{
+		Text = FText::FromName(Entry->AssetData.AssetName);
+	}
+	else if (ColumnName == DeletionPreviewColumns::DiskSize)
+	{
+		Text = FText::AsMemory(Entry->DiskSize);
+	}
+	else if (ColumnName == DeletionPreviewColumns::Modified)
+	{
+		// no file on disk yet
+		Text = Entry->ModifiedTime != FDateTime::MaxValue()
+			? FText::FromString(Entry->ModifiedTime.ToString(TEXT("%Y-%m-%d %H:%M")))
+			: FText::FromString(TEXT("-"));
+	}
+	else if (ColumnName == DeletionPreviewColumns::Referencers)
+	{
+		Text = FText::AsNumber(Entry->NumExternalReferencers);
+		Color = Entry->NumExternalReferencers > 0 ? FColor::Orange : FColor::Green;
+	}
+	else
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	return SNew(STextBlock)
+		.Text(Text)
+		.Font(RowFont)
+		.ColorAndOpacity(Color);
+}
+
+void SDeletionPreviewTab::OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FDeletionPreviewEntry> Entry)
+{
+	const int32 EntryIndex = GetEntryIndex(Entry);
+
+	if (!Selection.IsValidIndex(EntryIndex)) return;
+
+	Selection[EntryIndex] = NewState == ECheckBoxState::Checked;
+}
+
+ECheckBoxState SDeletionPreviewTab::GetCheckBoxState(TSharedPtr<FDeletionPreviewEntry> Entry) const
+{
+	const int32 EntryIndex = GetEntryIndex(Entry);
+
+	return Selection.IsValidIndex(EntryIndex) && Selection[EntryIndex] ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+FText SDeletionPreviewTab::GetSummaryText() const
+{
+	if (!Preview.IsValid()) return FText::FromString(TEXT("No pending deletion"));
+
+	return FText::Format(FText::FromString(TEXT("{0} assets, {1} on disk, {2} still referenced")),
+		FText::AsNumber(Preview->GetEntries().Num()), FText::AsMemory(Preview->GetTotalDiskSize()),
+		FText::AsNumber(Preview->GetNumReferencedEntries()));
+}
+
+#pragma region Graph
+
+void SDeletionPreviewTab::OnEntrySelectionChanged(TSharedPtr<FDeletionPreviewEntry> Entry, ESelectInfo::Type SelectInfo)
+{
+	// selections made from the graph are already focused there
+	if (!Entry.IsValid() || SelectInfo == ESelectInfo::Direct) return;
+
+	GraphView->FocusNode(Entry->GraphNode);
+}
+
+void SDeletionPreviewTab::OnGraphNodeClicked(int32 NodeIndex)
+{
+	if (!Preview.IsValid() || NodeIndex == INDEX_NONE) return;
+
+	// the list is never filtered, item i is entry i
+	const int32 EntryIndex = Preview->GetEntries().IndexOfByPredicate([NodeIndex](const FDeletionPreviewEntry& Entry)
+	{
+		return Entry.GraphNode == NodeIndex;
+	});
+
+	if (!EntryListItems.IsValidIndex(EntryIndex)) return;
+
+	EntryListView->SetSelection(EntryListItems[EntryIndex], ESelectInfo::Direct);
+	EntryListView->RequestScrollIntoView(EntryListItems[EntryIndex]);
+}
+
+int32 SDeletionPreviewTab::GetGraphDepth() const
+{
+	return Preview.IsValid() ? Preview->GetGraphDepth() : UBacgroundToolsSettings::Get()->PreviewGraphDepth;
+}
+
+void SDeletionPreviewTab::OnGraphDepthCommitted(int32 NewDepth, ETextCommit::Type CommitType)
+{
+	if (!Preview.IsValid() || NewDepth == Preview->GetGraphDepth()) return;
+
+	// walks the snapshot taken when the preview was built, no registry query
+	Preview->BuildGraph(NewDepth, UBacgroundToolsSettings::Get()->PreviewGraphMaxNodes);
+
+	GraphView->SetPreview(Preview);
+}
+
+FText SDeletionPreviewTab::GetGraphStatusText() const
+{
+	if (!Preview.IsValid()) return FText::GetEmpty();
+
+	const FDeletionPreviewGraph& Graph = Preview->GetGraph();
+
+	FString Status = FString::Printf(TEXT("%d packages, %d references"), Graph.Num(), Graph.Edges.Num());
+
+	if (Graph.bTruncated)
+	{
+		Status += TEXT(", capped");
+	}
+
+	if (!GraphView->IsLayoutSettled())
+	{
+		Status += TEXT(", laying out...");
+	}
+
+	return FText::FromString(Status);
+}
+
+#pragma endregion
+
+FReply SDeletionPreviewTab::OnDeleteButtonClicked()
+{
+	if (!Preview.IsValid()) return FReply::Handled();
+
+	const TArray<FDeletionPreviewEntry>& Entries = Preview->GetEntries();
+
+	TArray<FAssetData> AssetsToDelete;
+	for (TConstSetBitIterator<> It(Selection); It; ++It)
+	{
+		AssetsToDelete.Add(Entries[It.GetIndex()].AssetData);
+	}
+
+	if (AssetsToDelete.Num() == 0)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No asset currently selected"));
+		return FReply::Handled();
+	}
+
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	// this tab was the confirmation, the queue doesn't ask again
+	const int32 NumDeleted = BacgroundToolsModule.GetAssetDeletionQueue().DeleteApprovedAssets(MoveTemp(AssetsToDelete));
+
+	if (NumDeleted > 0)
+	{
+		Debug::ShowNotifyInfo(TEXT("Successfully deleted ") + FString::FromInt(NumDeleted) + TEXT(" assets"));
+	}
+
+	SetPreview(nullptr);
+
+	return FReply::Handled();
+}
+
+FReply SDeletionPreviewTab::OnSelectAllButtonClicked()
+{
+	Selection.SetRange(0, Selection.Num(), true);
+	return FReply::Handled();
+}
+
+FReply SDeletionPreviewTab::OnDeselectAllButtonClicked()
+{
+	Selection.SetRange(0, Selection.Num(), false);
+	return FReply::Handled();
+}
+
+FReply SDeletionPreviewTab::OnCancelButtonClicked()
+{
+	SetPreview(nullptr);
+	return FReply::Handled();
+}
+
+TSharedRef<SButton> SDeletionPreviewTab::ConstructTabButton(const FString& TextContent, FReply (SDeletionPreviewTab::*OnClicked)())
+{
+	FSlateFontInfo ButtonTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	ButtonTextFont.Size = 15;
+
+	return SNew(SButton)
+		.ContentPadding(FMargin(5.f))
+		.OnClicked(this, OnClicked)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(TextContent))
+			.Font(ButtonTextFont)
+			.Justification(ETextJustify::Center)
+		];
+}
@@ -0,0 +1,447 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/DependencyGraphView.h"
+#include "Misc/PackageName.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+namespace DependencyGraphView
+{
+	// graph space units
+	constexpr float ColumnSpacing = 320.f;
+	constexpr float RowSpacing = 28.f;
+	const FVector2D NodeSize(240.f, 20.f);
+
+	// a sweep moving nothing ends the layout earlier
+	constexpr int32 MaxSweeps = 16;
+
+	// nodes between two clock reads while computing barycenters
+	constexpr int32 TimeCheckInterval = 256;
+
+	// per frame, the rest of the frame stays for painting and input
+	constexpr double LayoutTimeBudget = 0.004;
+
+	constexpr float MinZoom = 0.02f;
+	constexpr float MaxZoom = 2.f;
+
+	// labels are unreadable below this
+	constexpr float LabelZoom = 0.5f;
+
+	// past this only the edges of the focused node are added
+	constexpr int32 MaxPaintedEdges = 5000;
+}
+
+#pragma region Layout
+
+void FDependencyGraphLayout::Reset(const FDeletionPreviewGraph& InGraph)
+{
+	const int32 NumNodes = InGraph.Num();
+
+	Columns.Reset();
+	ColumnOfNode.SetNumUninitialized(NumNodes);
+	Positions.SetNumUninitialized(NumNodes);
+	Barycenters.SetNumZeroed(NumNodes);
+
+	Sweep = 0;
+	SweepColumn = 0;
+	NextNodeInColumn = 0;
+	bSweepMovedNodes = false;
+	bIsSettled = NumNodes == 0;
+
+	Bounds = FBox2D(ForceInit);
+
+	if (NumNodes == 0) return;
+
+	int32 MinLayer = MAX_int32;
+	int32 MaxLayer = MIN_int32;
+
+	for (const int8 Layer : InGraph.Layers)
+	{
+		MinLayer = FMath::Min<int32>(MinLayer, Layer);
+		MaxLayer = FMath::Max<int32>(MaxLayer, Layer);
+	}
+
+	Columns.SetNum(MaxLayer - MinLayer + 1);
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		ColumnOfNode[Node] = InGraph.Layers[Node] - MinLayer;
+		Columns[ColumnOfNode[Node]].Add(Node);
+	}
+
+	// count, prefix sum, fill. both ends of an edge see each other
+	NeighbourOffsets.Reset();
+	NeighbourOffsets.SetNumZeroed(NumNodes + 1);
+	for (const FDeletionPreviewGraph::FEdge& Edge : InGraph.Edges)
+	{
+		if (Edge.From == Edge.To) continue;
+
+		++NeighbourOffsets[Edge.From + 1];
+		++NeighbourOffsets[Edge.To + 1];
+	}
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		NeighbourOffsets[Node + 1] += NeighbourOffsets[Node];
+	}
+
+	TArray<int32> FillCursors(NeighbourOffsets.GetData(), NumNodes);
+	Neighbours.SetNumUninitialized(NeighbourOffsets[NumNodes]);
+
+	for (const FDeletionPreviewGraph::FEdge& Edge : InGraph.Edges)
+	{
+		if (Edge.From == Edge.To) continue;
+
+		Neighbours[FillCursors[Edge.From]++] = Edge.To;
+		Neighbours[FillCursors[Edge.To]++] = Edge.From;
+	}
+
+	// discovery order to start with, usable before the first sweep
+	for (int32 ColumnIndex = 0; ColumnIndex < Columns.Num(); ++ColumnIndex)
+	{
+		const TArray<int32>& Column = Columns[ColumnIndex];
+
+		for (int32 Row = 0; Row < Column.Num(); ++Row)
+		{
+			Positions[Column[Row]] = FVector2D(ColumnIndex * DependencyGraphView::ColumnSpacing,
+				(Row - (Column.Num() - 1) * .5f) * DependencyGraphView::RowSpacing);
+		}
+	}
+
+	// sweeps only reorder rows inside a column, the extent is known now
+	UpdateBounds();
+}
+
+bool FDependencyGraphLayout::Step(double TimeBudget)
+{
+	if (bIsSettled) return true;
+
+	const double EndTime = FPlatformTime::Seconds() + TimeBudget;
+
+	while (!bIsSettled)
+	{
+		const int32 ColumnIndex = Sweep % 2 == 0 ? SweepColumn : Columns.Num() - 1 - SweepColumn;
+		const TArray<int32>& Column = Columns[ColumnIndex];
+
+		// a huge column is spread over several frames
+		while (NextNodeInColumn < Column.Num())
+		{
+			const int32 Node = Column[NextNodeInColumn++];
+
+			float Sum = 0.f;
+			int32 Count = 0;
+
+			for (int32 i = NeighbourOffsets[Node]; i < NeighbourOffsets[Node + 1]; ++i)
+			{
+				if (ColumnOfNode[Neighbours[i]] == ColumnIndex) continue;
+
+				Sum += Positions[Neighbours[i]].Y;
+				++Count;
+			}
+
+			Barycenters[Node] = Count > 0 ? Sum / Count : Positions[Node].Y;
+
+			if (NextNodeInColumn % DependencyGraphView::TimeCheckInterval == 0 && FPlatformTime::Seconds() > EndTime)
+			{
+				return false;
+			}
+		}
+
+		PlaceColumn(ColumnIndex);
+		NextNodeInColumn = 0;
+
+		if (++SweepColumn == Columns.Num())
+		{
+			SweepColumn = 0;
+			++Sweep;
+
+			if (!bSweepMovedNodes || Sweep >= DependencyGraphView::MaxSweeps)
+			{
+				bIsSettled = true;
+				break;
+			}
+
+			bSweepMovedNodes = false;
+		}
+
+		if (FPlatformTime::Seconds() > EndTime) break;
+	}
+
+	return bIsSettled;
+}
+
+void FDependencyGraphLayout::PlaceColumn(int32 ColumnIndex)
+{
+	TArray<int32>& Column = Columns[ColumnIndex];
+
+	Column.StableSort([this](int32 A, int32 B)
+	{
+		return Barycenters[A] < Barycenters[B];
+	});
+
+	for (int32 Row = 0; Row < Column.Num(); ++Row)
+	{
+		const float NewY = (Row - (Column.Num() - 1) * .5f) * DependencyGraphView::RowSpacing;
+		FVector2D& Position = Positions[Column[Row]];
+
+		if (Position.Y != NewY)
+		{
+			Position.Y = NewY;
+			bSweepMovedNodes = true;
+		}
+	}
+}
+
+void FDependencyGraphLayout::UpdateBounds()
+{
+	Bounds = FBox2D(ForceInit);
+
+	for (const FVector2D& Position : Positions)
+	{
+		Bounds += Position;
+	}
+
+	Bounds = FBox2D(Bounds.Min - DependencyGraphView::NodeSize, Bounds.Max + DependencyGraphView::NodeSize);
+}
+
+#pragma endregion
+
+void SDependencyGraphView::Construct(const FArguments& InArgs)
+{
+	OnNodeClicked = InArgs._OnNodeClicked;
+
+	LabelFont = FCoreStyle::GetDefaultFontStyle("Regular", 8);
+
+	SetPreview(InArgs._Preview);
+}
+
+void SDependencyGraphView::SetPreview(TSharedPtr<FDeletionPreview> InPreview)
+{
+	Preview = InPreview;
+	FocusedNode = INDEX_NONE;
+
+	if (Preview.IsValid())
+	{
+		Layout.Reset(Preview->GetGraph());
+	}
+	else
+	{
+		Layout.Reset(FDeletionPreviewGraph());
+	}
+
+	ViewCenter = Layout.GetBounds().bIsValid ? Layout.GetBounds().GetCenter() : FVector2D::ZeroVector;
+	Zoom = 1.f;
+
+	StartLayout();
+}
+
+void SDependencyGraphView::FocusNode(int32 NodeIndex)
+{
+	if (!Layout.GetPositions().IsValidIndex(NodeIndex)) return;
+
+	FocusedNode = NodeIndex;
+	ViewCenter = Layout.GetPositions()[NodeIndex];
+	Zoom = FMath::Max(Zoom, DependencyGraphView::LabelZoom);
+}
+
+void SDependencyGraphView::StartLayout()
+{
+	if (bIsLayoutTimerRegistered || Layout.IsSettled()) return;
+
+	RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SDependencyGraphView::StepLayout));
+	bIsLayoutTimerRegistered = true;
+}
+
+EActiveTimerReturnType SDependencyGraphView::StepLayout(double InCurrentTime, float InDeltaTime)
+{
+	if (!Layout.Step(DependencyGraphView::LayoutTimeBudget))
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	bIsLayoutTimerRegistered = false;
+	return EActiveTimerReturnType::Stop;
+}
+
+int32 SDependencyGraphView::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const FSlateBrush* WhiteBrush = FCoreStyle::Get().GetBrush("GenericWhiteBox");
+	const FVector2D LocalSize = AllottedGeometry.GetLocalSize();
+
+	FSlateDrawElement::MakeBox(OutDrawElements, LayerId, AllottedGeometry.ToPaintGeometry(), WhiteBrush,
+		ESlateDrawEffect::None, FLinearColor(.015f, .015f, .015f));
+
+	if (!Preview.IsValid()) return LayerId;
+
+	const FDeletionPreviewGraph& Graph = Preview->GetGraph();
+	const TArray<FVector2D>& Positions = Layout.GetPositions();
+
+	if (Positions.Num() != Graph.Num()) return LayerId;
+
+	// graph space viewport, padded by a node so boxes and edges crossing the border are kept
+	const FBox2D VisibleBox(
+		LocalToGraph(FVector2D::ZeroVector, LocalSize) - DependencyGraphView::NodeSize,
+		LocalToGraph(LocalSize, LocalSize) + DependencyGraphView::NodeSize);
+
+	TArray<FVector2D> LinePoints;
+	LinePoints.SetNumUninitialized(2);
+
+	int32 NumPaintedEdges = 0;
+
+	for (const FDeletionPreviewGraph::FEdge& Edge : Graph.Edges)
+	{
+		const bool bIsFocused = FocusedNode != INDEX_NONE && (Edge.From == FocusedNode || Edge.To == FocusedNode);
+
+		if (!bIsFocused && NumPaintedEdges >= DependencyGraphView::MaxPaintedEdges) continue;
+
+		FBox2D EdgeBox(ForceInit);
+		EdgeBox += Positions[Edge.From];
+		EdgeBox += Positions[Edge.To];
+
+		if (!EdgeBox.Intersect(VisibleBox)) continue;
+
+		LinePoints[0] = GraphToLocal(Positions[Edge.From], LocalSize);
+		LinePoints[1] = GraphToLocal(Positions[Edge.To], LocalSize);
+
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(), LinePoints,
+			ESlateDrawEffect::None, bIsFocused ? FLinearColor::Yellow : FLinearColor(1.f, 1.f, 1.f, .15f), true, bIsFocused ? 2.f : 1.f);
+
+		++NumPaintedEdges;
+	}
+
+	const bool bDrawLabels = Zoom >= DependencyGraphView::LabelZoom;
+	const FVector2D HalfNodeSize = DependencyGraphView::NodeSize * .5f;
+
+	for (int32 Node = 0; Node < Graph.Num(); ++Node)
+	{
+		if (!VisibleBox.IsInside(Positions[Node])) continue;
+
+		const FVector2D TopLeft = GraphToLocal(Positions[Node] - HalfNodeSize, LocalSize);
+
+		// node size in graph units, scaled by the zoom so labels shrink along with the boxes
+		const FPaintGeometry NodeGeometry = AllottedGeometry.ToPaintGeometry(TopLeft, DependencyGraphView::NodeSize, Zoom);
+
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId + 2, NodeGeometry, WhiteBrush, ESlateDrawEffect::None,
+			Node == FocusedNode ? FLinearColor::Yellow : GetNodeColor(Node));
+
+		if (bDrawLabels)
+		{
+			FSlateDrawElement::MakeText(OutDrawElements, LayerId + 3,
+				AllottedGeometry.ToPaintGeometry(TopLeft + FVector2D(4.f, 2.f) * Zoom, DependencyGraphView::NodeSize, Zoom),
+				FPackageName::GetShortName(Graph.PackageNames[Node]), LabelFont, ESlateDrawEffect::None,
+				Node == FocusedNode ? FLinearColor::Black : FLinearColor::White);
+		}
+	}
+
+	return LayerId + 3;
+}
+
+FLinearColor SDependencyGraphView::GetNodeColor(int32 NodeIndex) const
+{
+	const int8 Layer = Preview->GetGraph().Layers[NodeIndex];
+
+	// deleted red, referencers (what breaks) orange, dependencies (what may become unused) blue
+	if (Layer == 0) return FLinearColor(.75f, .12f, .08f);
+
+	const float Fade = 1.f / FMath::Abs(Layer);
+
+	return Layer < 0
+		? FLinearColor(.35f + .5f * Fade, .2f + .3f * Fade, .05f)
+		: FLinearColor(.1f, .2f + .15f * Fade, .35f + .35f * Fade);
+}
+
+FVector2D SDependencyGraphView::GraphToLocal(const FVector2D& GraphPosition, const FVector2D& LocalSize) const
+{
+	return (GraphPosition - ViewCenter) * Zoom + LocalSize * .5f;
+}
+
+FVector2D SDependencyGraphView::LocalToGraph(const FVector2D& LocalPosition, const FVector2D& LocalSize) const
+{
+	return (LocalPosition - LocalSize * .5f) / Zoom + ViewCenter;
+}
+
+int32 SDependencyGraphView::FindNodeAt(const FVector2D& LocalPosition, const FVector2D& LocalSize) const
+{
+	const FVector2D GraphPosition = LocalToGraph(LocalPosition, LocalSize);
+	const FVector2D HalfNodeSize = DependencyGraphView::NodeSize * .5f;
+
+	const TArray<FVector2D>& Positions = Layout.GetPositions();
+
+	for (int32 Node = 0; Node < Positions.Num(); ++Node)
+	{
+		if (FMath::Abs(Positions[Node].X - GraphPosition.X) <= HalfNodeSize.X &&
+			FMath::Abs(Positions[Node].Y - GraphPosition.Y) <= HalfNodeSize.Y)
+		{
+			return Node;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+FReply SDependencyGraphView::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (MouseEvent.GetEffectingButton() != EKeys::LeftMouseButton &&
+		MouseEvent.GetEffectingButton() != EKeys::RightMouseButton)
+	{
+		return FReply::Unhandled();
+	}
+
+	bIsPanning = true;
+	bMovedWhilePanning = false;
+
+	return FReply::Handled().CaptureMouse(SharedThis(this));
+}
+
+FReply SDependencyGraphView::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (!bIsPanning) return FReply::Unhandled();
+
+	bIsPanning = false;
+
+	// a left click without drag picks a node, an empty spot clears the focus
+	if (!bMovedWhilePanning && MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton)
+	{
+		FocusedNode = FindNodeAt(MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition()), MyGeometry.GetLocalSize());
+		OnNodeClicked.ExecuteIfBound(FocusedNode);
+	}
+
+	return FReply::Handled().ReleaseMouseCapture();
+}
+
+FReply SDependencyGraphView::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (!bIsPanning || !HasMouseCapture()) return FReply::Unhandled();
+
+	const FVector2D LocalDelta = MouseEvent.GetCursorDelta() / MyGeometry.Scale;
+
+	if (!LocalDelta.IsNearlyZero())
+	{
+		ViewCenter -= LocalDelta / Zoom;
+		bMovedWhilePanning = true;
+	}
+
+	return FReply::Handled();
+}
+
+FReply SDependencyGraphView::OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	const FVector2D LocalSize = MyGeometry.GetLocalSize();
+	const FVector2D CursorPosition = MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition());
+
+	// the graph point under the cursor stays under it
+	const FVector2D GraphPositionBefore = LocalToGraph(CursorPosition, LocalSize);
+
+	Zoom = FMath::Clamp(Zoom * FMath::Pow(1.15f, MouseEvent.GetWheelDelta()),
+		DependencyGraphView::MinZoom, DependencyGraphView::MaxZoom);
+
+	ViewCenter += GraphPositionBefore - LocalToGraph(CursorPosition, LocalSize);
+
+	return FReply::Handled();
+}
+
+FVector2D SDependencyGraphView::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D(400.f, 300.f);
+}
@@ -0,0 +1,461 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/DuplicateContentWidget.h"
+#include "SlateBasics.h"
+#include "BacgroundTools.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Debug.h"
+
+namespace
+{
+	const TCHAR* const DuplicateContentFilterLabels[] =
+	{
+		TEXT("All groups"),
+		TEXT("Identical only"),
+	};
+}
+
+using SDuplicateContentRow = SForwardingTableRow<SDuplicateContentTab, FDuplicateContentListItem>;
+
+void SDuplicateContentTab::Construct(const FArguments& InArgs)
+{
+	bCanSupportFocus = true;
+
+	for (const TCHAR* FilterLabel : DuplicateContentFilterLabels)
+	{
+		FilterOptions.Add(MakeShared<FString>(FilterLabel));
+	}
+
+	RowFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	RowFont.Size = 10;
+
+	FSlateFontInfo TitleTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	TitleTextFont.Size = 30;
+
+	ChildSlot
+		[
+			SNew(SVerticalBox)
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(TEXT("Duplicate Content")))
+				.Font(TitleTextFont)
+				.Justification(ETextJustify::Center)
+				.ColorAndOpacity(FColor::White)
+			]
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(5.f)
+				[
+					SNew(SComboBox< TSharedPtr <FString> >)
+					.OptionsSource(&FilterOptions)
+					.OnGenerateWidget(this, &SDuplicateContentTab::OnGenerateComboContent)
+					.OnSelectionChanged(this, &SDuplicateContentTab::OnFilterOptionSelected)
+					[
+						SNew(STextBlock)
+						.Text(this, &SDuplicateContentTab::GetFilterOptionText)
+					]
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.f)
+				.HAlign(HAlign_Right)
+				.VAlign(VAlign_Center)
+				.Padding(5.f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SDuplicateContentTab::GetSummaryText)
+				]
+			]
+
+			+ SVerticalBox::Slot()
+			.VAlign(VAlign_Fill)
+			[
+				SAssignNew(ListView, SListView< TSharedPtr <FDuplicateContentListItem> >)
+				.ItemHeight(24.f)
+				.ListItemsSource(&ListItems)
+				.OnGenerateRow(this, &SDuplicateContentTab::OnGenerateRowForList)
+				.HeaderRow(ConstructHeaderRow())
+			]
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Consolidate Selected"), &SDuplicateContentTab::OnConsolidateButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Select All"), &SDuplicateContentTab::OnSelectAllButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Deselect All"), &SDuplicateContentTab::OnDeselectAllButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Rescan"), &SDuplicateContentTab::OnRescanButtonClicked)
+				]
+			]
+		];
+
+	SetGroups(InArgs._FolderRoots, InArgs._Groups);
+}
+
+void SDuplicateContentTab::SetGroups(const FFolderRootSet& InFolderRoots, TSharedPtr< TArray <FDuplicateContentGroup> > InGroups)
+{
+	FolderRoots = InFolderRoots;
+	Groups = InGroups.IsValid() ? InGroups : MakeShared<TArray<FDuplicateContentGroup>>();
+
+	KeeperIndices.Init(0, Groups->Num());
+
+	// consolidating is destructive, only groups identical down to the bulk payload start checked.
+	// export only matches (material instances, data assets) are left for the user to review
+	GroupSelection.Init(false, Groups->Num());
+	for (int32 i = 0; i < Groups->Num(); ++i)
+	{
+		GroupSelection[i] = (*Groups)[i].bIdentical && (*Groups)[i].bMatchedOnBulkData;
+	}
+
+	RebuildListItems();
+}
+
+void SDuplicateContentTab::RebuildListItems()
+{
+	ListItems.Reset();
+
+	for (int32 GroupIndex = 0; GroupIndex < Groups->Num(); ++GroupIndex)
+	{
+		const FDuplicateContentGroup& Group = (*Groups)[GroupIndex];
+
+		if (!PassesFilter(Group)) continue;
+
+		for (int32 EntryIndex = 0; EntryIndex < Group.Entries.Num(); ++EntryIndex)
+		{
+			ListItems.Add(MakeShared<FDuplicateContentListItem>(FDuplicateContentListItem{GroupIndex, EntryIndex}));
+		}
+	}
+
+	if (ListView.IsValid())
+	{
+		ListView->RequestListRefresh();
+	}
+}
+
+const FDuplicateContentGroup* SDuplicateContentTab::GetGroup(const TSharedPtr<FDuplicateContentListItem>& Item) const
+{
+	if (!Item.IsValid() || !Groups->IsValidIndex(Item->GroupIndex)) return nullptr;
+
+	return &(*Groups)[Item->GroupIndex];
+}
+
+const FDuplicateContentEntry* SDuplicateContentTab::GetEntry(const TSharedPtr<FDuplicateContentListItem>& Item) const
+{
+	const FDuplicateContentGroup* Group = GetGroup(Item);
+
+	if (!Group || !Group->Entries.IsValidIndex(Item->EntryIndex)) return nullptr;
+
+	return &Group->Entries[Item->EntryIndex];
+}
+
+TSharedRef<SHeaderRow> SDuplicateContentTab::ConstructHeaderRow()
+{
+	return SNew(SHeaderRow)
+
+		+ SHeaderRow::Column(DuplicateContentColumns::CheckBox)
+		.FixedWidth(24.f)
+		.DefaultLabel(FText::GetEmpty())
+
+		+ SHeaderRow::Column(DuplicateContentColumns::Keep)
+		.FixedWidth(48.f)
+		.DefaultLabel(FText::FromString(TEXT("Keep")))
+
+		+ SHeaderRow::Column(DuplicateContentColumns::Group)
+		.FixedWidth(60.f)
+		.DefaultLabel(FText::FromString(TEXT("Group")))
+
+		+ SHeaderRow::Column(DuplicateContentColumns::Match)
+		.FixedWidth(110.f)
+		.DefaultLabel(FText::FromString(TEXT("Match")))
+
+		+ SHeaderRow::Column(DuplicateContentColumns::AssetClass)
+		.FillWidth(.2f)
+		.DefaultLabel(FText::FromString(TEXT("Class")))
+
+		+ SHeaderRow::Column(DuplicateContentColumns::AssetName)
+		.FillWidth(.6f)
+		.DefaultLabel(FText::FromString(TEXT("Asset")))
+
+		+ SHeaderRow::Column(DuplicateContentColumns::DiskSize)
+		.FillWidth(.2f)
+		.DefaultLabel(FText::FromString(TEXT("Size")));
+}
+
+TSharedRef<ITableRow> SDuplicateContentTab::OnGenerateRowForList(TSharedPtr<FDuplicateContentListItem> Item,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!GetEntry(Item)) return SNew(STableRow< TSharedPtr <FDuplicateContentListItem> >, OwnerTable);
+
+	return SNew(SDuplicateContentRow, OwnerTable)
+		.Item(Item)
+		.OwnerTab(SharedThis(this));
+}
+
+TSharedRef<SWidget> SDuplicateContentTab::ConstructWidgetForColumn(const FName& ColumnName,
+	const TSharedPtr<FDuplicateContentListItem>& Item)
+{
+	const FDuplicateContentGroup* Group = GetGroup(Item);
+	const FDuplicateContentEntry* Entry = GetEntry(Item);
+
+	if (!Group || !Entry) return SNullWidget::NullWidget;
+
+	if (ColumnName == DuplicateContentColumns::CheckBox)
+	{
+		return SNew(SCheckBox)
+			.Type(ESlateCheckBoxType::CheckBox)
+			.OnCheckStateChanged(this, &SDuplicateContentTab::OnGroupCheckBoxStateChanged, Item)
+			.IsChecked(this, &SDuplicateContentTab::GetGroupCheckBoxState, Item);
+	}
+
+	if (ColumnName == DuplicateContentColumns::Keep)
+	{
+		return SNew(SCheckBox)
+			.Type(ESlateCheckBoxType::CheckBox)
+			.OnCheckStateChanged(this, &SDuplicateContentTab::OnKeepCheckBoxStateChanged, Item)
+			.IsChecked(this, &SDuplicateContentTab::GetKeepCheckBoxState, Item);
+	}
+
+	FString Text;
+	FColor Color = FColor::White;
+
+	if (ColumnName == DuplicateContentColumns::Group)
+	{
+		Text = TEXT("#") + FString::FromInt(Item->GroupIndex + 1);
+	}
+	else if (ColumnName == DuplicateContentColumns::Match)
+	{
+		if (!Group->bMatchedOnBulkData)
+		{
+			Text = TEXT("Same export data");
+			Color = FColor::Yellow;
+		}
+		else
+		{
+			Text = Group->bIdentical ? TEXT("Identical") : TEXT("Same bulk data");
+			Color = Group->bIdentical ? FColor::Green : FColor::Yellow;
+		}
+	}
+	else if (ColumnName == DuplicateContentColumns::AssetClass)
+	{
+		Text = Entry->AssetData.AssetClassPath.GetAssetName().ToString();
+	}
+	else if (ColumnName == DuplicateContentColumns::AssetName)
+	{
+		Text = Entry->AssetData.PackageName.ToString();
+	}
+	else if (ColumnName == DuplicateContentColumns::DiskSize)
+	{
+		Text = FText::AsMemory(Entry->ExportSize + Entry->BulkSize).ToString();
+	}
+	else
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	return SNew(STextBlock)
+		.Text(FText::FromString(Text))
+		.Font(RowFont)
+		.ColorAndOpacity(Color);
+}
+
+void SDuplicateContentTab::OnGroupCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FDuplicateContentListItem> Item)
+{
+	if (!GetGroup(Item)) return;
+
+	GroupSelection[Item->GroupIndex] = NewState == ECheckBoxState::Checked;
+}
+
+ECheckBoxState SDuplicateContentTab::GetGroupCheckBoxState(TSharedPtr<FDuplicateContentListItem> Item) const
+{
+	return GetGroup(Item) && GroupSelection[Item->GroupIndex] ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void SDuplicateContentTab::OnKeepCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FDuplicateContentListItem> Item)
+{
+	// one kept asset per group, unchecking it keeps it
+	if (!GetEntry(Item) || NewState != ECheckBoxState::Checked) return;
+
+	KeeperIndices[Item->GroupIndex] = Item->EntryIndex;
+}
+
+ECheckBoxState SDuplicateContentTab::GetKeepCheckBoxState(TSharedPtr<FDuplicateContentListItem> Item) const
+{
+	return GetEntry(Item) && KeeperIndices[Item->GroupIndex] == Item->EntryIndex ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+#pragma region Filter
+
+bool SDuplicateContentTab::PassesFilter(const FDuplicateContentGroup& Group) const
+{
+	return FilterIndex == 0 || (Group.bIdentical && Group.bMatchedOnBulkData);
+}
+
+TSharedRef<SWidget> SDuplicateContentTab::OnGenerateComboContent(TSharedPtr<FString> Option)
+{
+	return SNew(STextBlock).Text(FText::FromString(*Option.Get()));
+}
+
+void SDuplicateContentTab::OnFilterOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo)
+{
+	const int32 SelectedIndex = FilterOptions.IndexOfByKey(SelectedOption);
+
+	if (SelectedIndex == INDEX_NONE || SelectedIndex == FilterIndex) return;
+
+	FilterIndex = SelectedIndex;
+	RebuildListItems();
+}
+
+FText SDuplicateContentTab::GetFilterOptionText() const
+{
+	return FText::FromString(DuplicateContentFilterLabels[FilterIndex]);
+}
+
+FText SDuplicateContentTab::GetSummaryText() const
+{
+	int32 NumDuplicates = 0;
+	int64 WastedBytes = 0;
+
+	for (const FDuplicateContentGroup& Group : *Groups)
+	{
+		NumDuplicates += Group.Entries.Num() - 1;
+		WastedBytes += Group.WastedBytes;
+	}
+
+	return FText::FromString(FString::Printf(TEXT("%d groups, %d duplicates, %s reclaimable"),
+		Groups->Num(), NumDuplicates, *FText::AsMemory(WastedBytes).ToString()));
+}
+
+#pragma endregion
+
+FReply SDuplicateContentTab::OnConsolidateButtonClicked()
+{
+	TArray<int32> GroupsToConsolidate;
+	for (TConstSetBitIterator<> It(GroupSelection); It; ++It)
+	{
+		// hidden by the filter means not consolidated
+		if (PassesFilter((*Groups)[It.GetIndex()]))
+		{
+			GroupsToConsolidate.Add(It.GetIndex());
+		}
+	}
+
+	if (GroupsToConsolidate.Num() == 0)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No group currently selected"));
+		return FReply::Handled();
+	}
+
+	const EAppReturnType::Type ConfirmResult = Debug::ShowMsgDialog(EAppMsgType::YesNo,
+		FString::Printf(TEXT("Consolidate %d groups?\nReferences move to the kept asset of each group, the other assets are deleted."),
+			GroupsToConsolidate.Num()), false);
+
+	if (ConfirmResult == EAppReturnType::No) return FReply::Handled();
+
+	TArray<FAssetData> ConsolidatedAssets;
+	int32 NumConsolidated = 0;
+
+	{
+		FScopedSlowTask SlowTask(GroupsToConsolidate.Num(), FText::FromString(TEXT("Consolidating duplicate content")));
+		SlowTask.MakeDialog(true);
+
+		for (const int32 GroupIndex : GroupsToConsolidate)
+		{
+			if (SlowTask.ShouldCancel()) break;
+
+			SlowTask.EnterProgressFrame();
+
+			const FDuplicateContentGroup& Group = (*Groups)[GroupIndex];
+
+			NumConsolidated += FDuplicateContentScan::Consolidate(Group, KeeperIndices[GroupIndex]);
+
+			for (int32 EntryIndex = 0; EntryIndex < Group.Entries.Num(); ++EntryIndex)
+			{
+				if (EntryIndex != KeeperIndices[GroupIndex])
+				{
+					ConsolidatedAssets.Add(Group.Entries[EntryIndex].AssetData);
+				}
+			}
+		}
+	}
+
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	// the deleted duplicates left redirectors behind
+	BacgroundToolsModule.GetRedirectorFixUpService().FixUpRedirectorsForAssets(ConsolidatedAssets);
+
+	if (NumConsolidated > 0)
+	{
+		Debug::ShowNotifyInfo(TEXT("Successfully consolidated ") + FString::FromInt(NumConsolidated) + TEXT(" assets"));
+	}
+
+	BacgroundToolsModule.StartDuplicateContentScan(FolderRoots);
+
+	return FReply::Handled();
+}
+
+FReply SDuplicateContentTab::OnSelectAllButtonClicked()
+{
+	GroupSelection.SetRange(0, GroupSelection.Num(), true);
+	return FReply::Handled();
+}
+
+FReply SDuplicateContentTab::OnDeselectAllButtonClicked()
+{
+	GroupSelection.SetRange(0, GroupSelection.Num(), false);
+	return FReply::Handled();
+}
+
+FReply SDuplicateContentTab::OnRescanButtonClicked()
+{
+	FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools")).StartDuplicateContentScan(FolderRoots);
+	return FReply::Handled();
+}
+
+TSharedRef<SButton> SDuplicateContentTab::ConstructTabButton(const FString& TextContent, FReply (SDuplicateContentTab::*OnClicked)())
+{
+	FSlateFontInfo ButtonTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	ButtonTextFont.Size = 15;
+
+	return SNew(SButton)
+		.ContentPadding(FMargin(5.f))
+		.OnClicked(this, OnClicked)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(TextContent))
+			.Font(ButtonTextFont)
+			.Justification(ETextJustify::Center)
+		];
+}
@@ -0,0 +1,405 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/NamingAuditWidget.h"
+#include "SlateBasics.h"
+#include "BacgroundTools.h"
+#include "Debug.h"
+
+namespace
+{
+	const TCHAR* const NamingAuditFilterLabels[] =
+	{
+		TEXT("All issues"),
+		TEXT("Missing prefix"),
+		TEXT("Wrong prefix"),
+	};
+}
+
+using SNamingAuditRow = SForwardingTableRow<SNamingAuditTab, FNamingAuditEntry>;
+
+void SNamingAuditTab::Construct(const FArguments& InArgs)
+{
+	bCanSupportFocus = true;
+
+	FolderRoots = InArgs._FolderRoots;
+
+	for (const TCHAR* FilterLabel : NamingAuditFilterLabels)
+	{
+		FilterOptions.Add(MakeShared<FString>(FilterLabel));
+	}
+
+	RowFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	RowFont.Size = 10;
+
+	FSlateFontInfo TitleTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	TitleTextFont.Size = 30;
+
+	ChildSlot
+		[
+			SNew(SVerticalBox)
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(TEXT("Naming Audit")))
+				.Font(TitleTextFont)
+				.Justification(ETextJustify::Center)
+				.ColorAndOpacity(FColor::White)
+			]
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(5.f)
+				[
+					SNew(SComboBox< TSharedPtr <FString> >)
+					.OptionsSource(&FilterOptions)
+					.OnGenerateWidget(this, &SNamingAuditTab::OnGenerateComboContent)
+					.OnSelectionChanged(this, &SNamingAuditTab::OnFilterOptionSelected)
+					[
+						SNew(STextBlock)
+						.Text(this, &SNamingAuditTab::GetFilterOptionText)
+					]
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.f)
+				.HAlign(HAlign_Right)
+				.VAlign(VAlign_Center)
+				.Padding(5.f)
+				[
+					SNew(STextBlock)
+					.Text(this, &SNamingAuditTab::GetSummaryText)
+				]
+			]
+
+			+ SVerticalBox::Slot()
+			.VAlign(VAlign_Fill)
+			[
+				SAssignNew(IssueListView, SListView< TSharedPtr <FNamingAuditEntry> >)
+				.ItemHeight(24.f)
+				.ListItemsSource(&IssueListItems)
+				.OnGenerateRow(this, &SNamingAuditTab::OnGenerateRowForList)
+				.HeaderRow(ConstructHeaderRow())
+			]
+
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			[
+				SNew(SHorizontalBox)
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Apply Fixes"), &SNamingAuditTab::OnApplyButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Select All"), &SNamingAuditTab::OnSelectAllButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Deselect All"), &SNamingAuditTab::OnDeselectAllButtonClicked)
+				]
+
+				+ SHorizontalBox::Slot()
+				.FillWidth(10.f)
+				.Padding(5.f)
+				[
+					ConstructTabButton(TEXT("Refresh"), &SNamingAuditTab::OnRefreshButtonClicked)
+				]
+			]
+		];
+
+	RunAudit();
+}
+
+void SNamingAuditTab::RunAudit()
+{
+	FBacgroundToolsModule& BacgroundToolsModule =
+		FModuleManager::LoadModuleChecked<FBacgroundToolsModule>(TEXT("BacgroundTools"));
+
+	// a new audit object, items of the previous one keep it alive until the list lets go of them
+	Audit = MakeShared<FNamingAudit>();
+	Audit->Run(FolderRoots, BacgroundToolsModule.GetPrefixTable(), BacgroundToolsModule.GetPathExclusionRules());
+
+	// every fix starts checked, except the ones whose new name is taken
+	const TArray<FNamingAuditEntry>& Issues = Audit->GetIssues();
+	Selection.Init(true, Issues.Num());
+
+	for (int32 i = 0; i < Issues.Num(); ++i)
+	{
+		if (Issues[i].bNameTaken)
+		{
+			Selection[i] = false;
+		}
+	}
+
+	RebuildIssueListItems();
+}
+
+void SNamingAuditTab::RebuildIssueListItems()
+{
+	IssueListItems.Reset();
+
+	if (Audit.IsValid())
+	{
+		const TArray<FNamingAuditEntry>& Issues = Audit->GetIssues();
+
+		for (const FNamingAuditEntry& Entry : Issues)
+		{
+			if (!PassesFilter(Entry)) continue;
+
+			IssueListItems.Emplace(Audit, const_cast<FNamingAuditEntry*>(&Entry));
+		}
+	}
+
+	if (IssueListView.IsValid())
+	{
+		IssueListView->RequestListRefresh();
+	}
+}
+
+int32 SNamingAuditTab::GetIssueIndex(const TSharedPtr<FNamingAuditEntry>& Entry) const
+{
+	if (!Entry.IsValid() || !Audit.IsValid()) return INDEX_NONE;
+
+	const TArray<FNamingAuditEntry>& Issues = Audit->GetIssues();
+	const int32 IssueIndex = static_cast<int32>(Entry.Get() - Issues.GetData());
+
+	return Issues.IsValidIndex(IssueIndex) ? IssueIndex : INDEX_NONE;
+}
+
+TSharedRef<SHeaderRow> SNamingAuditTab::ConstructHeaderRow()
+{
+	return SNew(SHeaderRow)
+
+		+ SHeaderRow::Column(NamingAuditColumns::CheckBox)
+		.FixedWidth(24.f)
+		.DefaultLabel(FText::GetEmpty())
+
+		+ SHeaderRow::Column(NamingAuditColumns::Status)
+		.FixedWidth(110.f)
+		.DefaultLabel(FText::FromString(TEXT("Status")))
+
+		+ SHeaderRow::Column(NamingAuditColumns::AssetClass)
+		.FillWidth(.2f)
+		.DefaultLabel(FText::FromString(TEXT("Class")))
+
+		+ SHeaderRow::Column(NamingAuditColumns::AssetName)
+		.FillWidth(.4f)
+		.DefaultLabel(FText::FromString(TEXT("Name")))
+
+		+ SHeaderRow::Column(NamingAuditColumns::NewName)
+		.FillWidth(.4f)
+		.DefaultLabel(FText::FromString(TEXT("New Name")));
+}
+
+TSharedRef<ITableRow> SNamingAuditTab::OnGenerateRowForList(TSharedPtr<FNamingAuditEntry> Entry,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!Entry.IsValid()) return SNew(STableRow< TSharedPtr <FNamingAuditEntry> >, OwnerTable);
+
+	return SNew(SNamingAuditRow, OwnerTable)
+		.Item(Entry)
+		.OwnerTab(SharedThis(this));
+}
+
+TSharedRef<SWidget> SNamingAuditTab::ConstructWidgetForColumn(const FName& ColumnName,
+	const TSharedPtr<FNamingAuditEntry>& Entry)
+{
+	if (ColumnName == NamingAuditColumns::CheckBox)
+	{
+		return SNew(SCheckBox)
+			.Type(ESlateCheckBoxType::CheckBox)
+			.OnCheckStateChanged(this, &SNamingAuditTab::OnCheckBoxStateChanged, Entry)
+			.IsChecked(this, &SNamingAuditTab::GetCheckBoxState, Entry);
+	}
+
+	FString Text;
+	FColor Color = FColor::White;
+
+	if (ColumnName == NamingAuditColumns::Status)
+	{
+		Text = Entry->Status == ENamingAuditStatus::WrongPrefix ? TEXT("Wrong prefix") : TEXT("Missing prefix");
+	}
+	else if (ColumnName == NamingAuditColumns::AssetClass)
+	{
+		Text = Entry->AssetData.AssetClassPath.GetAssetName().ToString();
+	}
+	else if (ColumnName == NamingAuditColumns::AssetName)
+	{
+		Text = Entry->AssetData.AssetName.ToString();
+	}
+	else if (ColumnName == NamingAuditColumns::NewName)
+	{
+		Text = Entry->bNameTaken ? Entry->NewName + TEXT(" (name taken)") : Entry->NewName;
+		Color = Entry->bNameTaken ? FColor::Red : FColor::Green;
+	}
+	else
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	return SNew(STextBlock)
+		.Text(FText::FromString(Text))
+		.Font(RowFont)
+		.ColorAndOpacity(Color);
+}
+
+void SNamingAuditTab::OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FNamingAuditEntry> Entry)
+{
+	const int32 IssueIndex = GetIssueIndex(Entry);
+
+	if (!Selection.IsValidIndex(IssueIndex)) return;
+
+	Selection[IssueIndex] = NewState == ECheckBoxState::Checked;
+}
+
+ECheckBoxState SNamingAuditTab::GetCheckBoxState(TSharedPtr<FNamingAuditEntry> Entry) const
+{
+	const int32 IssueIndex = GetIssueIndex(Entry);
+
+	return Selection.IsValidIndex(IssueIndex) && Selection[IssueIndex] ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+#pragma region Filter
+
+bool SNamingAuditTab::PassesFilter(const FNamingAuditEntry& Entry) const
+{
+	switch (FilterIndex)
+	{
+	case 1: return Entry.Status == ENamingAuditStatus::MissingPrefix;
+	case 2: return Entry.Status == ENamingAuditStatus::WrongPrefix;
+	default: return true;
+	}
+}
+
+TSharedRef<SWidget> SNamingAuditTab::OnGenerateComboContent(TSharedPtr<FString> Option)
+{
+	return SNew(STextBlock).Text(FText::FromString(*Option.Get()));
+}
+
+void SNamingAuditTab::OnFilterOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo)
+{
+	const int32 SelectedIndex = FilterOptions.IndexOfByKey(SelectedOption);
+
+	if (SelectedIndex == INDEX_NONE || SelectedIndex == FilterIndex) return;
+
+	FilterIndex = SelectedIndex;
+	RebuildIssueListItems();
+}
+
+FText SNamingAuditTab::GetFilterOptionText() const
+{
+	return FText::FromString(NamingAuditFilterLabels[FilterIndex]);
+}
+
+FText SNamingAuditTab::GetSummaryText() const
+{
+	if (!Audit.IsValid()) return FText::GetEmpty();
+
+	int32 NumMissingPrefix = 0;
+	for (const FNamingAuditEntry& Entry : Audit->GetIssues())
+	{
+		if (Entry.Status == ENamingAuditStatus::MissingPrefix) ++NumMissingPrefix;
+	}
+
+	return FText::FromString(FString::Printf(TEXT("%d correct, %d missing prefix, %d wrong prefix, %d without rule"),
+		Audit->GetNumCorrect(), NumMissingPrefix, Audit->GetIssues().Num() - NumMissingPrefix, Audit->GetNumWithoutPrefix()));
+}
+
+#pragma endregion
+
+FReply SNamingAuditTab::OnApplyButtonClicked()
+{
+	if (!Audit.IsValid()) return FReply::Handled();
+
+	const TArray<FNamingAuditEntry>& Issues = Audit->GetIssues();
+
+	TArray<FNamingAuditEntry> FixesToApply;
+	for (TConstSetBitIterator<> It(Selection); It; ++It)
+	{
+		// hidden by the filter means not applied
+		if (PassesFilter(Issues[It.GetIndex()]))
+		{
+			FixesToApply.Add(Issues[It.GetIndex()]);
+		}
+	}
+
+	if (FixesToApply.Num() == 0)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No fix currently selected"));
+		return FReply::Handled();
+	}
+
+	const int32 NumRenamed = FNamingAudit::ApplyFixes(FixesToApply);
+
+	if (NumRenamed < FixesToApply.Num())
+	{
+		Debug::ShowNotifyInfo(FString::Printf(TEXT("Renamed %d of %d assets, the others have a taken name or failed to rename"),
+			NumRenamed, FixesToApply.Num()));
+	}
+	else if (NumRenamed > 0)
+	{
+		Debug::ShowNotifyInfo(TEXT("Successfully renamed ") + FString::FromInt(NumRenamed) + TEXT(" assets"));
+	}
+
+	RunAudit();
+
+	return FReply::Handled();
+}
+
+FReply SNamingAuditTab::OnSelectAllButtonClicked()
+{
+	if (!Audit.IsValid()) return FReply::Handled();
+
+	// taken names stay unchecked, as after the audit
+	const TArray<FNamingAuditEntry>& Issues = Audit->GetIssues();
+
+	for (int32 i = 0; i < Issues.Num(); ++i)
+	{
+		Selection[i] = !Issues[i].bNameTaken;
+	}
+	return FReply::Handled();
+}
+
+FReply SNamingAuditTab::OnDeselectAllButtonClicked()
+{
+	Selection.SetRange(0, Selection.Num(), false);
+	return FReply::Handled();
+}
+
+FReply SNamingAuditTab::OnRefreshButtonClicked()
+{
+	RunAudit();
+	return FReply::Handled();
+}
+
+TSharedRef<SButton> SNamingAuditTab::ConstructTabButton(const FString& TextContent, FReply (SNamingAuditTab::*OnClicked)())
+{
+	FSlateFontInfo ButtonTextFont = FCoreStyle::Get().GetFontStyle(FName("EmbossedText"));
+	ButtonTextFont.Size = 15;
+
+	return SNew(SButton)
+		.ContentPadding(FMargin(5.f))
+		.OnClicked(this, OnClicked)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(TextContent))
+			.Font(ButtonTextFont)
+			.Justification(ETextJustify::Center)
+		];
+}
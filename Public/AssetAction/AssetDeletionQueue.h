@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Containers/Ticker.h"
+
+class FRedirectorFixUpService;
+
+DECLARE_DELEGATE_OneParam(FOnDeletionPreviewRequested, const TArray<FAssetData>& /*AssetsToDelete*/);
+
+/**
+ * Deletion pipeline behind every delete action of the plugin.
+ * Queued assets are deleted together: one confirmation, one redirector fix-up and one registry reference check
+ * of the whole flush, which also keeps everything a kept asset depends on. The rest is deleted referencers first
+ * in chunks of UBacgroundToolsSettings::DeletionChunkSize assets, each chunk is loaded, checked again against
+ * what is in memory (unsaved levels, open editors, undo buffer) and deleted.
+ * Garbage collection, source control and file removal run once for the whole flush.
+ * With UBacgroundToolsSettings::bPreviewDeletions, a confirmed flush of several assets hands them to
+ * OnPreviewRequested instead of asking, the preview deletes what the user approves through DeleteApprovedAssets.
+ */
+class BACGROUNDTOOLS_API FAssetDeletionQueue
+{
+public:
+	void Initialize(FRedirectorFixUpService& InRedirectorFixUpService);
+	void Shutdown();
+
+	/** Queues assets, everything queued is flushed on the next tick unless Flush is called first */
+	void Enqueue(TArrayView<const FAssetData> Assets);
+
+	/** Deletes everything queued, returns the number of deleted packages. 0 when the assets went to the preview */
+	int32 Flush(bool bShowConfirmation = true);
+
+	/** Deletes assets the user already reviewed, no confirmation. Referenced ones still get the engine dialog */
+	int32 DeleteApprovedAssets(TArray<FAssetData>&& Assets);
+
+	FOnDeletionPreviewRequested OnPreviewRequested;
+
+private:
+	bool OnDeferredFlush(float DeltaTime);
+
+	int32 DeleteAssets(TArray<FAssetData>&& AssetsToDelete, bool bInteractive);
+
+	FRedirectorFixUpService* RedirectorFixUpService = nullptr;
+
+	TArray<FAssetData> QueuedAssets;
+
+	TSet<FSoftObjectPath> QueuedObjectPaths;
+
+	FTSTicker::FDelegateHandle DeferredFlushHandle;
+
+	// confirmation dialogs tick, a flush must not start another one
+	bool bIsFlushing = false;
+};
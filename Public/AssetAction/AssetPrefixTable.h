@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/TopLevelAssetPath.h"
+#include "Modules/ModuleManager.h"
+
+/**
+ * Asset class path -> name prefix, resolved through the class hierarchy.
+ * Prefixes come from UBacgroundToolsSettings. Every loaded class is resolved once up front
+ * (again when modules load or the settings change), so a lookup is a single hash probe.
+ * Classes that aren't loaded are resolved from the asset registry class hierarchy on first use.
+ */
+class BACGROUNDTOOLS_API FAssetPrefixTable
+{
+public:
+	struct FResolvedPrefix
+	{
+		FString Prefix;
+
+		// configured class the prefix comes from, the class itself or one of its parents
+		FTopLevelAssetPath PrefixClassPath;
+	};
+
+	void Initialize();
+	void Shutdown();
+
+	/** nullptr when neither the class nor any of its parents has a prefix */
+	const FResolvedPrefix* FindPrefix(const FTopLevelAssetPath& AssetClassPath);
+
+	/** Longest configured prefix AssetName starts with, of any class, nullptr when none */
+	const FString* FindKnownPrefix(const FString& AssetName);
+
+	/** Resolution is redone on next lookup */
+	void Invalidate() { bNeedsRebuild = true; }
+
+private:
+	void Rebuild();
+
+	int32 ResolveLoadedClass(UClass* Class);
+
+	int32 ResolveFromAssetRegistry(const FTopLevelAssetPath& AssetClassPath);
+
+	void OnSettingChanged(UObject* Settings, struct FPropertyChangedEvent& PropertyChangedEvent);
+
+	void OnModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
+	TArray<FResolvedPrefix> Prefixes;
+
+	// class path -> index in Prefixes, INDEX_NONE caches classes without prefix
+	TMap<FTopLevelAssetPath, int32> ResolvedPrefixIndices;
+
+	bool bNeedsRebuild = true;
+
+	FDelegateHandle SettingChangedHandle;
+	FDelegateHandle ModulesChangedHandle;
+};
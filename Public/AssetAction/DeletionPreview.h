@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetScan/AssetReachability.h"
+
+class FReferencerIndex;
+class FAssetSizeCache;
+
+/** One asset about to be deleted, as listed in the preview */
+struct FDeletionPreviewEntry
+{
+	FAssetData AssetData;
+
+	int64 DiskSize = 0;
+
+	// MaxValue when the package has no file on disk
+	FDateTime ModifiedTime = FDateTime::MaxValue();
+
+	// referencing packages not deleted along with this asset, they break or block the deletion
+	int32 NumExternalReferencers = 0;
+
+	// node of the package in the graph, INDEX_NONE when the node cap was reached before it
+	int32 GraphNode = INDEX_NONE;
+};
+
+/**
+ * Packages around the deleted ones, Layers[i] < 0 for referencers, 0 for deleted packages
+ * and > 0 for dependencies, the absolute value being the distance to the nearest deleted package.
+ */
+struct FDeletionPreviewGraph
+{
+	struct FEdge
+	{
+		// From depends on To
+		int32 From = INDEX_NONE;
+
+		int32 To = INDEX_NONE;
+	};
+
+	TArray<FName> PackageNames;
+
+	TArray<int8> Layers;
+
+	TArray<FEdge> Edges;
+
+	// the node cap cut the search short
+	bool bTruncated = false;
+
+	int32 Num() const { return PackageNames.Num(); }
+
+	void Reset();
+};
+
+/**
+ * Dry run of a deletion: size and modification time of every asset, plus the reference graph
+ * around them limited to a depth. The graph comes from an in-memory snapshot of the referencer index,
+ * changing the depth walks the snapshot again without querying the registry.
+ */
+class BACGROUNDTOOLS_API FDeletionPreview
+{
+public:
+	/** Any thread, waits for the referencer index. Package files missing from the size cache are stat-ed in parallel */
+	void Build(TArray<FAssetData>&& InAssets, FReferencerIndex& ReferencerIndex, const FAssetSizeCache& AssetSizeCache,
+		int32 MaxDepth, int32 MaxNodes);
+
+	/** Rebuilds the graph from the snapshot taken by Build */
+	void BuildGraph(int32 MaxDepth, int32 MaxNodes);
+
+	TArray<FDeletionPreviewEntry>& GetEntries() { return Entries; }
+
+	const TArray<FDeletionPreviewEntry>& GetEntries() const { return Entries; }
+
+	const FDeletionPreviewGraph& GetGraph() const { return Graph; }
+
+	int32 GetGraphDepth() const { return GraphDepth; }
+
+	int64 GetTotalDiskSize() const { return TotalDiskSize; }
+
+	/** Assets still referenced from outside the deletion */
+	int32 GetNumReferencedEntries() const { return NumReferencedEntries; }
+
+private:
+	void ReverseSnapshot();
+
+	TArray<FDeletionPreviewEntry> Entries;
+
+	FDeletionPreviewGraph Graph;
+
+	int32 GraphDepth = 0;
+
+	int64 TotalDiskSize = 0;
+
+	int32 NumReferencedEntries = 0;
+
+	// whole project dependencies at Build time
+	FPackageDependencyGraph Snapshot;
+
+	// referencers in the same CSR layout as the snapshot's dependencies
+	TArray<int32> ReverseOffsets;
+
+	TArray<int32> ReverseTargets;
+
+	// snapshot node of every entry, INDEX_NONE for packages the index doesn't know yet
+	TArray<int32> EntryNodes;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class FAssetPrefixTable;
+class FPathExclusionRules;
+class FFolderRootSet;
+
+enum class ENamingAuditStatus : uint8
+{
+	Correct,
+	MissingPrefix,
+	WrongPrefix
+};
+
+struct FNamingAuditEntry
+{
+	FAssetData AssetData;
+
+	ENamingAuditStatus Status = ENamingAuditStatus::Correct;
+
+	// fixed asset name, empty when the name is correct
+	FString NewName;
+
+	// another asset of the folder already has NewName, or an earlier issue is renamed to it
+	bool bNameTaken = false;
+};
+
+/**
+ * Prefix check of whole folders from asset registry data only, no package gets loaded.
+ * A name starting with the prefix configured for another class has a wrong prefix and gets it
+ * replaced, any other name without its prefix gets it prepended.
+ */
+class BACGROUNDTOOLS_API FNamingAudit
+{
+public:
+	/** Audits every asset under the roots, assets without a configured prefix are skipped */
+	void Run(const FFolderRootSet& FolderRoots, FAssetPrefixTable& PrefixTable, const FPathExclusionRules& ExclusionRules);
+
+	/** False when neither the asset class nor its parents have a prefix */
+	static bool AuditAsset(const FAssetData& AssetData, FAssetPrefixTable& PrefixTable, FNamingAuditEntry& OutEntry);
+
+	/**
+	 * Renames the entries in one AssetTools batch, returns the number of assets found under their new name afterwards.
+	 * Entries whose name is taken, by another asset or by an earlier entry of the batch, are skipped
+	 */
+	static int32 ApplyFixes(TArrayView<const FNamingAuditEntry> Entries);
+
+	/** Misnamed assets only, sorted by path */
+	const TArray<FNamingAuditEntry>& GetIssues() const { return Issues; }
+
+	int32 GetNumCorrect() const { return NumCorrect; }
+
+	int32 GetNumWithoutPrefix() const { return NumWithoutPrefix; }
+
+private:
+	TArray<FNamingAuditEntry> Issues;
+
+	int32 NumCorrect = 0;
+
+	int32 NumWithoutPrefix = 0;
+};
@@ -5,18 +5,6 @@
 #include "CoreMinimal.h"
 #include "AssetActionUtility.h"
 
-// for PrefixMap
-#include "Materials/Material.h"
-#include "Materials/MaterialInstanceConstant.h"
-#include "Particles/ParticleSystem.h"	
-#include "Sound/SoundCue.h"
-#include "Sound/SoundWave.h"
-#include "Engine/Texture.h"
-#include "Blueprint/UserWidget.h"
-#include "Components/SkeletalMeshComponent.h"
-#include "NiagaraSystem.h"
-#include "NiagaraEmitter.h"	
-
 #include "QuickAssetAction.generated.h"
 
 /**
@@ -37,26 +25,4 @@ public:
 
 	UFUNCTION(CallInEditor)
 	void RemoveUnusedAssets();
-
-
-private:
-	TMap<UClass*, FString> PrefixMap =
-	{
-		{UBlueprint::StaticClass(),TEXT("BP_")},
-		{UStaticMesh::StaticClass(),TEXT("SM_")},
-		{UMaterial::StaticClass(), TEXT("M_")},
-		{UMaterialInstanceConstant::StaticClass(),TEXT("MI_")},
-		{UMaterialFunctionInterface::StaticClass(), TEXT("MF_")},
-		{UParticleSystem::StaticClass(), TEXT("PS_")},
-		{USoundCue::StaticClass(), TEXT("SC_")},
-		{USoundWave::StaticClass(), TEXT("SW_")},
-		{UTexture::StaticClass(), TEXT("T_")},
-		{UTexture2D::StaticClass(), TEXT("T_")},
-		{UUserWidget::StaticClass(), TEXT("WBP_")},
-		{USkeletalMeshComponent::StaticClass(), TEXT("SK_")},
-		{UNiagaraSystem::StaticClass(), TEXT("NS_")},
-		{UNiagaraEmitter::StaticClass(), TEXT("NE_")}
-	};
-
-	void FixUpRedirectors();
 };
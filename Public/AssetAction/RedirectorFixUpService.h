@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "UObject/SoftObjectPath.h"
+
+class FFolderRootSet;
+
+/**
+ * Redirector fix-up shared by the module menu actions and UQuickAssetAction.
+ * Redirectors under /Game (and any root added with AddTrackedRootPath) are queried once and then tracked through asset registry events,
+ * so a fix-up with nothing to do costs no registry query, and only the redirectors
+ * touching the assets or folder being processed are loaded and fixed up.
+ */
+class BACGROUNDTOOLS_API FRedirectorFixUpService
+{
+public:
+	void Initialize();
+	void Shutdown();
+
+	/** Fixes up redirectors pointing at any of Assets */
+	void FixUpRedirectorsForAssets(const TArray<FAssetData>& Assets);
+
+	/** Fixes up redirectors located under any of the roots or pointing into one, in one batch */
+	void FixUpRedirectorsUnderRoots(const FFolderRootSet& FolderRoots);
+
+	/** Redirectors located under any of the roots or pointing into one, a redirector from one root into another is listed once */
+	void GetRedirectorsUnderRoots(const FFolderRootSet& FolderRoots, TArray<FSoftObjectPath>& OutRedirectorPaths);
+
+	/** Tracks redirectors under another mounted root as well, e.g. a temporary mount point */
+	void AddTrackedRootPath(const FString& RootPath);
+
+	void RemoveTrackedRootPath(const FString& RootPath);
+
+private:
+	struct FTrackedRedirector
+	{
+		FSoftObjectPath ObjectPath;
+
+		FName PackagePath;
+
+		// package of the object the redirector points at
+		FName DestinationPackage;
+	};
+
+	void EnsureTracking();
+
+	void TrackRedirector(const FAssetData& AssetData);
+
+	static bool IsRedirector(const FAssetData& AssetData);
+
+	bool IsUnderTrackedRoot(FName PackagePath) const;
+
+	void FixUpRedirectors(const TArray<FSoftObjectPath>& RedirectorPaths);
+
+#pragma region AssetRegistryEvents
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void OnFilesLoaded();
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle FilesLoadedHandle;
+
+#pragma endregion
+
+	// redirector package -> redirector
+	TMap<FName, FTrackedRedirector> TrackedRedirectors;
+
+	TArray<FString> TrackedRootPaths = { TEXT("/Game") };
+
+	bool bIsTracking = false;
+};
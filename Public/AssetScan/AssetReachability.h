@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** Forward package dependencies in compressed sparse row layout, node i depends on EdgeTargets[EdgeOffsets[i] .. EdgeOffsets[i + 1]) */
+struct FPackageDependencyGraph
+{
+	TArray<FName> PackageNames;
+
+	TMap<FName, int32> NodeIndices;
+
+	TArray<int32> EdgeOffsets;
+
+	TArray<int32> EdgeTargets;
+
+	int32 Num() const { return PackageNames.Num(); }
+};
+
+/** What the cook keeps no matter what references it */
+struct FReachabilityRoots
+{
+	TSet<FName> RootPackages;
+
+	// "/Game/Folder/" style prefixes, everything below is a root
+	TArray<FString> RootPaths;
+
+	bool IsRoot(FName PackageName) const;
+};
+
+/**
+ * Packages reachable from the roots through package dependencies (hard and soft).
+ * An asset nobody reachable depends on is dead even when other dead assets reference it,
+ * so chains and cycles of unused assets are found in one pass instead of one layer per run.
+ * The search is a level synchronous BFS spread over the task graph, cycles among the dead
+ * packages are grouped with an iterative Tarjan SCC pass.
+ */
+class BACGROUNDTOOLS_API FAssetReachability
+{
+public:
+	explicit FAssetReachability(FPackageDependencyGraph&& InGraph);
+
+	/** Roots from the project packaging and map settings, the asset manager and UBacgroundToolsSettings, game thread only */
+	static void CollectRoots(FReachabilityRoots& OutRoots);
+
+	/** Checks bCancelRequested between BFS levels, returns false when it stopped early and nothing is reachable then */
+	bool Compute(const FReachabilityRoots& InRoots, const std::atomic<bool>* bCancelRequested = nullptr);
+
+	/** Packages missing from the graph are reachable only if they are roots themselves */
+	bool IsReachable(FName PackageName) const;
+
+	/** Unreachable packages depending on each other in a cycle, one array per strongly connected component */
+	void FindUnreachableCycles(TArray<TArray<FName>>& OutCycles) const;
+
+private:
+	FPackageDependencyGraph Graph;
+
+	FReachabilityRoots Roots;
+
+	TBitArray<> Reachable;
+};
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Containers/HashTable.h"
+#include "UObject/SoftObjectPath.h"
+
+class FAssetSizeCache;
+
+enum class EAssetRecordFlags : uint8
+{
+	None = 0,
+
+	// level package, its file is a .umap
+	Map = 1 << 0,
+};
+ENUM_CLASS_FLAGS(EAssetRecordFlags);
+
+/**
+ * Slim asset records of a tab, one array per field instead of one FAssetData per asset.
+ * A record is two names, a class index, flags, two sizes and a selection bit; the tags and the rest of
+ * FAssetData stay in the registry and are fetched on demand, for tooltips and deletion.
+ * Indices are stable until a removal, which compacts every column in one pass.
+ */
+class BACGROUNDTOOLS_API FAssetRecordStore
+{
+public:
+	int32 Num() const { return PackageNames.Num(); }
+
+	bool IsValidIndex(int32 Index) const { return PackageNames.IsValidIndex(Index); }
+
+	void Reserve(int32 Number);
+
+	void Reset();
+
+	/** Adds the asset or overwrites its record, the selection bit is kept. No registry query, safe inside an enumeration */
+	int32 AddOrUpdate(const FAssetData& AssetData);
+
+	int32 Find(const FSoftObjectPath& ObjectPath) const;
+
+	/** Removes the records whose bit is set, the others keep their order */
+	void RemoveAll(const TBitArray<>& RecordsToRemove);
+
+	void RemoveAt(int32 Index);
+
+#pragma region Fields
+
+	FName GetPackageName(int32 Index) const { return PackageNames[Index]; }
+
+	FName GetAssetName(int32 Index) const { return AssetNames[Index]; }
+
+	FSoftObjectPath GetObjectPath(int32 Index) const;
+
+	/** Index into GetClassPaths */
+	int32 GetClassIndex(int32 Index) const { return ClassIndices[Index]; }
+
+	const FTopLevelAssetPath& GetClassPath(int32 Index) const { return ClassPaths[ClassIndices[Index]]; }
+
+	/** Every class seen so far, a class may have no record left */
+	const TArray<FTopLevelAssetPath>& GetClassPaths() const { return ClassPaths; }
+
+	int32 FindClassIndex(const FTopLevelAssetPath& ClassPath) const;
+
+	bool HasAnyFlags(int32 Index, EAssetRecordFlags InFlags) const { return EnumHasAnyFlags(Flags[Index], InFlags); }
+
+	/** Disk footprint once the size cache has it, registry package size until then */
+	int64 GetDiskSize(int32 Index) const { return FMath::Max<int64>(DiskSizes[Index], 0); }
+
+	/** Estimated memory size as of the last UpdateResourceSizes, negative when the asset wasn't loaded */
+	int64 GetResourceSize(int32 Index) const { return ResourceSizes[Index]; }
+
+	const TArray<FName>& GetPackageNames() const { return PackageNames; }
+
+#pragma endregion
+
+	/** Registry package size of the records added or updated since the last call, not inside a registry enumeration */
+	void FillMissingDiskSizes();
+
+	/** Takes the footprints the size cache computed so far */
+	void UpdateDiskSizes(const FAssetSizeCache& AssetSizeCache);
+
+	/** Game thread, measures the loaded assets and never loads one. Returns true when a size changed */
+	bool UpdateResourceSizes();
+
+#pragma region Selection
+
+	bool IsSelected(int32 Index) const { return Selection.IsValidIndex(Index) && Selection[Index]; }
+
+	void SetSelected(int32 Index, bool bSelected);
+
+	void SelectAll() { Selection.SetRange(0, Selection.Num(), true); }
+
+	void DeselectAll() { Selection.SetRange(0, Selection.Num(), false); }
+
+	int32 GetNumSelected() const { return Selection.CountSetBits(); }
+
+#pragma endregion
+
+	/** Full registry data of one record, e.g. for a tooltip */
+	FAssetData GetAssetData(int32 Index) const;
+
+	/** Full registry data of the selected records, one registry query */
+	void GetSelectedAssetData(TArray<FAssetData>& OutAssetData) const;
+
+	/** Heap memory of the columns and the path hash */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	static uint32 HashObjectPath(FName PackageName, FName AssetName);
+
+	void RebuildPathHash();
+
+	TArray<FName> PackageNames;
+
+	TArray<FName> AssetNames;
+
+	TArray<uint16> ClassIndices;
+
+	TArray<EAssetRecordFlags> Flags;
+
+	// negative until FillMissingDiskSizes
+	TArray<int64> DiskSizes;
+
+	// negative for assets not loaded
+	TArray<int64> ResourceSizes;
+
+	TBitArray<> Selection;
+
+	TArray<FTopLevelAssetPath> ClassPaths;
+
+	TMap<FTopLevelAssetPath, uint16> ClassPathToIndex;
+
+	// object path hash -> record indices, the paths themselves are not stored twice
+	FHashTable PathHash;
+
+	uint32 PathHashSize = 0;
+};
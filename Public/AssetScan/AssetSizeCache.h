@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
+
+class UPackage;
+class FObjectPostSaveContext;
+class FAssetRecordStore;
+
+struct FAssetDiskSize
+{
+	// package file and its .uexp / .ubulk / .uptnl companions
+	int64 Footprint = 0;
+
+	// newest modification time of those files, MaxValue while the package has no file (never saved or removed)
+	FDateTime Timestamp = FDateTime::MaxValue();
+};
+
+DECLARE_MULTICAST_DELEGATE(FOnAssetDiskSizesUpdated);
+
+/**
+ * Disk footprint per package, stat-ed on the thread pool and cached by package name.
+ * Requests from visible rows are served before the background fill of the rest, nothing is stat-ed
+ * on the game thread. Entries keep the file timestamp and are dropped when the package is saved or removed.
+ * An entry requested again after a while is still served but re-stat-ed on the worker, so files changed behind
+ * the editor's back, e.g. by a source control sync, are picked up.
+ */
+class BACGROUNDTOOLS_API FAssetSizeCache
+{
+public:
+	void Initialize();
+
+	/** Stops the worker and waits for it */
+	void Shutdown();
+
+	bool FindDiskSize(FName PackageName, FAssetDiskSize& OutDiskSize) const;
+
+	/** Overwrites InOutFootprints[i] for every package already cached, one lock for the whole array */
+	void GetKnownFootprints(TArrayView<const FName> PackageNames, TArrayView<int64> InOutFootprints) const;
+
+	/** Same for the file timestamps, returns how many of the packages are cached */
+	int32 GetKnownTimestamps(TArrayView<const FName> PackageNames, TArrayView<FDateTime> InOutTimestamps) const;
+
+	/** Queues the packages not cached yet, bVisible requests are served first */
+	void RequestDiskSizes(const FAssetRecordStore& Records, bool bVisible);
+
+	void RequestDiskSize(FName PackageName, bool bIsMap, bool bVisible);
+
+	/** Broadcast on the game thread, at most once per frame while the worker runs */
+	FOnAssetDiskSizesUpdated OnDiskSizesUpdated;
+
+	/** Package file of an asset, .umap for levels */
+	static FString GetPackageFilename(const FAssetData& AssetData);
+
+	static FString GetPackageFilename(FName PackageName, bool bIsMap);
+
+	/** Stats a package file and its companions, zero footprint when the package file is missing */
+	static FAssetDiskSize StatPackage(const FString& Filename);
+
+private:
+	struct FRequest
+	{
+		FName PackageName;
+
+		// resolved on the worker when empty
+		FString Filename;
+
+		bool bIsMap = false;
+	};
+
+	// expects Lock to be held
+	void QueueRequest(FRequest&& Request, bool bVisible);
+
+	// expects Lock to be held
+	void RequestDiskSizeLocked(FName PackageName, bool bIsMap, bool bVisible);
+
+	void RunWorker();
+
+	void PostUpdated();
+
+	void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
+
+	void OnAssetRemoved(const FAssetData& AssetData);
+
+	struct FCachedDiskSize
+	{
+		FAssetDiskSize DiskSize;
+
+		// FPlatformTime::Seconds of the stat
+		double StatTime = 0.0;
+	};
+
+	mutable FCriticalSection Lock;
+
+	TMap<FName, FCachedDiskSize> DiskSizes;
+
+	TSet<FName> QueuedPackages;
+
+	// served last in first, the rows shown most recently come first
+	TArray<FRequest> VisibleRequests;
+
+	TArray<FRequest> BackgroundRequests;
+
+	bool bIsWorkerRunning = false;
+
+	TFuture<void> WorkerFuture;
+
+	std::atomic<bool> bShutdownRequested { false };
+
+	std::atomic<bool> bIsUpdatePosted { false };
+
+	// game thread callbacks check it, the module may be gone by the time they run
+	TSharedPtr<bool, ESPMode::ThreadSafe> AliveToken;
+
+	FDelegateHandle PackageSavedHandle;
+	FDelegateHandle AssetRemovedHandle;
+};
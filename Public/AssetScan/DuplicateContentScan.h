@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Async/Future.h"
+#include "IO/IoHash.h"
+#include "Hash/Blake3.h"
+#include "AssetScan/FolderRootSet.h"
+
+class FReferencerIndex;
+class FPathExclusionRules;
+class SNotificationItem;
+
+struct FDuplicateContentEntry
+{
+	FAssetData AssetData;
+
+	// export data after the package header, plus the name, import and export tables it indexes into.
+	// the table entries are resolved and the asset's own name and path left out, they differ between copies
+	FIoHash ExportHash;
+	int64 ExportSize = 0;
+
+	// inline bulk data plus the .ubulk / .uptnl companions, source art and audio live there
+	FIoHash BulkHash;
+	int64 BulkSize = 0;
+};
+
+struct FDuplicateContentGroup
+{
+	// suggested keeper first : most referencers, then shortest path
+	TArray<FDuplicateContentEntry> Entries;
+
+	// same export data too, not only the same bulk payload
+	bool bIdentical = true;
+
+	// grouped on the bulk payload, groups without bulk data were matched on export data only
+	bool bMatchedOnBulkData = false;
+
+	// freed by consolidating the group into one asset
+	int64 WastedBytes = 0;
+};
+
+DECLARE_DELEGATE_OneParam(FOnDuplicateContentScanFinished, const TArray<FDuplicateContentGroup>& /*Groups*/);
+
+/**
+ * Background scan for assets of a folder sharing the same content on disk.
+ * Package summaries are read first and only assets whose payload sizes collide get hashed,
+ * by a fixed number of workers streaming the files through one read buffer each, so memory
+ * does not grow with the amount of content. Packages with bulk data are grouped by the bulk
+ * payload (re-imports of the same source), the others by their whole export data.
+ */
+class BACGROUNDTOOLS_API FDuplicateContentScan : public TSharedFromThis<FDuplicateContentScan, ESPMode::ThreadSafe>
+{
+public:
+	FDuplicateContentScan(const FFolderRootSet& InFolderRoots, FReferencerIndex& InReferencerIndex,
+		const FPathExclusionRules& InExclusionRules);
+
+	void Start(const FOnDuplicateContentScanFinished& InOnFinished);
+
+	/** Stops the scan, the finished delegate won't be called */
+	void Cancel();
+
+	/** Cancels and blocks until the workers are done, for module shutdown */
+	void CancelAndWait();
+
+	/** Stays true after a cancel until the worker has returned */
+	bool IsRunning() const { return bIsRunning; }
+
+	/** Replaces the references to every other entry of the group with the keeper and deletes them, returns the number consolidated */
+	static int32 Consolidate(const FDuplicateContentGroup& Group, int32 KeeperIndex);
+
+private:
+	struct FPackageLayout
+	{
+		FString Filename;
+
+		// logical offsets over the .uasset followed by its .uexp
+		int64 HeaderSize = 0;
+		int64 BulkDataStart = 0;
+	};
+
+	/** Reads the package summary only, fills the layout and the sizes of the entry */
+	static bool ReadPackageLayout(const FString& Filename, FPackageLayout& OutLayout, FDuplicateContentEntry& OutEntry);
+
+	/** Hashes everything after the header in Buffer sized sequential reads, gives up when cancelled */
+	bool HashPackage(const FPackageLayout& Layout, TArray<uint8>& Buffer, FDuplicateContentEntry& OutEntry) const;
+
+	/** Hashes the resolved name map, import table and export table, what the raw export bytes refer to by index */
+	static bool HashPackageTables(const FPackageLayout& Layout, FName PackageName, FBlake3& OutHasher);
+
+	void Run();
+
+	void PostProgress(const FString& ProgressMessage);
+
+	void PostFinished(TArray<FDuplicateContentGroup>&& Groups);
+
+	void OnCancelButtonClicked();
+
+	FFolderRootSet FolderRoots;
+
+	FReferencerIndex& ReferencerIndex;
+
+	const FPathExclusionRules& ExclusionRules;
+
+	FOnDuplicateContentScanFinished OnFinished;
+
+	TSharedPtr<SNotificationItem> ProgressNotification;
+
+	TFuture<void> WorkerFuture;
+
+	std::atomic<bool> bCancelRequested { false };
+
+	std::atomic<bool> bIsRunning { false };
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FPathExclusionRules;
+
+/**
+ * Empty folder detection in one pass over a folder tree.
+ * Assets are counted per folder with a single registry enumeration and summed bottom-up,
+ * only the topmost folder of every empty subtree is reported so one delete removes the whole subtree.
+ */
+class BACGROUNDTOOLS_API FEmptyFolderTree
+{
+public:
+	struct FEmptySubtree
+	{
+		FString FolderPath;
+
+		// the folder and every folder below it
+		int32 NumFolders = 0;
+	};
+
+	/** FolderPaths : one or more root folders and every folder below them, in any order */
+	void Build(const TArray<FString>& FolderPaths, const FPathExclusionRules& ExclusionRules);
+
+	const TArray<FEmptySubtree>& GetEmptySubtrees() const { return EmptySubtrees; }
+
+	int32 GetNumEmptyFolders() const { return NumEmptyFolders; }
+
+	/** One recursive directory delete and one registry path removal for the whole subtree, refused when a package file is found on disk under it */
+	static bool DeleteEmptySubtree(const FEmptySubtree& EmptySubtree);
+
+private:
+	TArray<FEmptySubtree> EmptySubtrees;
+
+	int32 NumEmptyFolders = 0;
+};
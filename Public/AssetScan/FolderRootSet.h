@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+struct FARFilter;
+class FPathExclusionRules;
+
+/**
+ * Content Browser folder selection merged into its topmost folders.
+ * Duplicates and folders lying under another selected folder are dropped, the remaining roots
+ * never overlap so a scan over all of them visits every asset and every folder once.
+ */
+class BACGROUNDTOOLS_API FFolderRootSet
+{
+public:
+	FFolderRootSet() = default;
+
+	explicit FFolderRootSet(const TArray<FString>& FolderPaths);
+
+	/** Sorted, no root lies under another */
+	const TArray<FString>& GetRoots() const { return Roots; }
+
+	int32 Num() const { return Roots.Num(); }
+
+	bool IsEmpty() const { return Roots.Num() == 0; }
+
+	/** True for a root or any folder below one */
+	bool ContainsPath(FStringView PackagePath) const;
+
+	bool ContainsPath(FName PackagePath) const { return ContainsPath(FStringView(PackagePath.ToString())); }
+
+	/** Recursive filter over every root, the registry returns each asset once. Check IsEmpty first, a filter without paths matches everything */
+	void AddToFilter(FARFilter& Filter) const;
+
+	/** On disk assets under the roots, excluded folders dropped. One registry query per root, run in parallel */
+	void GetOnDiskAssets(const FPathExclusionRules& ExclusionRules, TArray<FAssetData>& OutAssets) const;
+
+	/** The roots and every folder below them */
+	void GetFolderPaths(TArray<FString>& OutFolderPaths) const;
+
+	/** "/Game/A" for a single root, "/Game/A (+2 folders)" otherwise */
+	FString ToString() const;
+
+	static bool IsPathUnder(FStringView PackagePath, FStringView FolderPath);
+
+private:
+	TArray<FString> Roots;
+};
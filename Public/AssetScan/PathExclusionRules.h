@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Folders the tools never touch, compiled from UBacgroundToolsSettings::ExcludedPaths.
+ * "/Game/Developers" or a mount point like "/MyPlugin" excludes that folder and everything below,
+ * "Developers" excludes every folder with that exact name, both accept * and ? wildcards.
+ * Plain rules are compiled into a trie of path components and a set of folder names (FName compares
+ * case-insensitively), the result is cached per folder so a query per asset is one hash probe.
+ * Queries are thread safe, the unused asset scan runs them on the thread pool.
+ */
+class BACGROUNDTOOLS_API FPathExclusionRules
+{
+public:
+	void Initialize();
+	void Shutdown();
+
+	/** Compiles the rules, the per folder cache is dropped */
+	void Compile(const TArray<FString>& Rules);
+
+	bool IsPathExcluded(FName PackagePath) const;
+
+	bool IsPathExcluded(const FString& PackagePath) const { return IsPathExcluded(FName(*PackagePath)); }
+
+private:
+	bool MatchRules(const FString& PackagePath) const;
+
+	void OnSettingChanged(UObject* Settings, struct FPropertyChangedEvent& PropertyChangedEvent);
+
+	struct FTrieNode
+	{
+		TMap<FName, int32> Children;
+
+		bool bExcluded = false;
+	};
+
+	// prefix rules, node 0 is the root
+	TArray<FTrieNode> PrefixTrie;
+
+	TSet<FName> ExcludedFolderNames;
+
+	// wildcard rules, checked once per folder
+	TArray<FString> FolderNamePatterns;
+	TArray<FString> PathPatterns;
+
+	mutable FRWLock RulesLock;
+
+	mutable TMap<FName, bool> FolderCache;
+
+	mutable FRWLock CacheLock;
+
+	FDelegateHandle SettingChangedHandle;
+};
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "HAL/CriticalSection.h"
+#include "IO/IoHash.h"
+#include "Async/Future.h"
+#include <atomic>
+
+class IAssetRegistry;
+struct FPackageDependencyGraph;
+struct FReachabilityRoots;
+
+/**
+ * Reverse dependency index built in one pass from the asset registry dependency data.
+ * Keeps the number of referencing packages for every package and follows registry events,
+ * so unused asset queries are answered from memory instead of one registry query per asset.
+ * The dependencies are saved to Saved/BacgroundTools keyed by package saved hash, a rebuild only
+ * queries the registry for packages saved since. The first build runs in the background once
+ * the registry finished its initial discovery.
+ * Queries can be made from any thread, registry events are expected on the game thread.
+ */
+class BACGROUNDTOOLS_API FReferencerIndex
+{
+public:
+	void Initialize();
+	void Shutdown();
+
+	/** Number of other packages referencing PackageName */
+	int32 GetReferencerCount(FName PackageName);
+
+	/**
+	 * Game thread, counts for every package under one lock. Never builds on the calling thread : returns false
+	 * while the index is missing or being built and starts a background build, the caller retries later
+	 */
+	bool TryGetReferencerCounts(TArrayView<const FName> PackageNames, TArrayView<int32> OutCounts);
+
+	/** Adds every asset of Candidates that has no referencer to OutUnusedAssets */
+	void GetUnusedAssets(TArrayView<const FAssetData> Candidates, TArray<FAssetData>& OutUnusedAssets);
+
+	/**
+	 * Adds every asset of Candidates no root reaches, whole chains and cycles of unused assets included.
+	 * OutCycles gets the unreachable reference cycles having a package among Candidates.
+	 * Returns false when bCancelRequested was set during the search, the outputs are incomplete then
+	 */
+	bool GetUnreachableAssets(TArrayView<const FAssetData> Candidates, const FReachabilityRoots& Roots,
+		TArray<FAssetData>& OutUnreachableAssets, TArray<TArray<FName>>* OutCycles = nullptr,
+		const std::atomic<bool>* bCancelRequested = nullptr);
+
+	/** Snapshot of the forward edges in CSR layout */
+	void GetDependencyGraph(FPackageDependencyGraph& OutGraph);
+
+	/**
+	 * Builds the index or applies pending registry changes, queries do it on demand.
+	 * A build stops when bCancelRequested is set and returns false, the packages it queried are kept for the next one
+	 */
+	bool Update(const std::atomic<bool>* bCancelRequested = nullptr);
+
+	/** Drops the index, it will be rebuilt on next query */
+	void Invalidate();
+
+private:
+	// expects IndexLock to be held
+	bool EnsureUpToDate(const std::atomic<bool>* bCancelRequested = nullptr);
+
+	/** Game thread, Update on the thread pool unless one is already running */
+	void StartBackgroundUpdate();
+
+	bool Rebuild(IAssetRegistry& AssetRegistry, const std::atomic<bool>* bCancelRequested);
+
+	void RefreshPackage(IAssetRegistry& AssetRegistry, FName PackageName);
+
+	void AddDependencies(FName PackageName, TArray<FName>&& Dependencies);
+
+	void RemoveDependencies(FName PackageName);
+
+#pragma region PersistentCache
+
+	static FString GetCacheFilename();
+
+	bool LoadCache(TMap<FName, FIoHash>& OutSavedHashes, TMap<FName, TArray<FName>>& OutDependencies) const;
+
+	// expects IndexLock to be held
+	void SaveCache() const;
+
+	// package -> saved hash its dependencies were read at
+	TMap<FName, FIoHash> PackageSavedHashes;
+
+	// the index changed since it was last saved
+	bool bIsCacheDirty = false;
+
+#pragma endregion
+
+#pragma region AssetRegistryEvents
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void OnAssetUpdated(const FAssetData& AssetData);
+	void OnFilesLoaded();
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+	FDelegateHandle FilesLoadedHandle;
+
+#pragma endregion
+
+	// package -> packages it depends on (forward edges, kept to undo counts on refresh)
+	TMap<FName, TArray<FName>> PackageDependencies;
+
+	// package -> number of packages referencing it
+	TMap<FName, int32> ReferencerCounts;
+
+	// packages touched by registry events since the last query
+	TSet<FName> PendingPackages;
+
+	// set once a build started, events before that are covered by the build itself
+	bool bTrackEvents = false;
+
+	// set when the registry finished its initial discovery after a build
+	bool bRebuildRequested = false;
+
+	bool bIsBuilt = false;
+
+	// guards the maps and bIsBuilt
+	FCriticalSection IndexLock;
+
+	// guards PendingPackages and the event flags, kept separate so events never wait on a build
+	FCriticalSection PendingLock;
+
+	// background build started when the initial discovery is done
+	TFuture<void> WarmUpFuture;
+};
@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Async/Future.h"
+#include "AssetScan/AssetReachability.h"
+#include "AssetScan/FolderRootSet.h"
+
+class FReferencerIndex;
+class FPathExclusionRules;
+class SNotificationItem;
+
+DECLARE_DELEGATE_TwoParams(FOnUnusedAssetScanFinished, const TArray<FAssetData>& /*UnusedAssets*/,
+	const TArray<TArray<FName>>& /*UnreachableCycles*/);
+
+/**
+ * Background scan for unused assets under a set of folders, or among a given list of assets.
+ * Registry and referencer queries run on the thread pool, progress is shown in a notification
+ * with a cancel button and only the finished delegate is called back on the game thread.
+ */
+class BACGROUNDTOOLS_API FUnusedAssetScan : public TSharedFromThis<FUnusedAssetScan, ESPMode::ThreadSafe>
+{
+public:
+	FUnusedAssetScan(const FFolderRootSet& InFolderRoots, FReferencerIndex& InReferencerIndex,
+		const FPathExclusionRules& InExclusionRules);
+
+	/** Checks only these assets, the Content Browser selection of the asset action */
+	FUnusedAssetScan(TArray<FAssetData>&& InCandidateAssets, FReferencerIndex& InReferencerIndex,
+		const FPathExclusionRules& InExclusionRules);
+
+	void Start(const FOnUnusedAssetScanFinished& InOnFinished);
+
+	/** Stops the scan, the finished delegate won't be called */
+	void Cancel();
+
+	/** Cancels and blocks until the worker is done, for module shutdown */
+	void CancelAndWait();
+
+	/** Stays true after a cancel until the worker has returned */
+	bool IsRunning() const { return bIsRunning; }
+
+private:
+	void Run();
+
+	void PostProgress(const FString& ProgressMessage);
+
+	void PostFinished(TArray<FAssetData>&& UnusedAssets, TArray<TArray<FName>>&& UnreachableCycles = {});
+
+	void OnCancelButtonClicked();
+
+	FFolderRootSet FolderRoots;
+
+	// used instead of the assets under FolderRoots when bScanCandidateAssets
+	TArray<FAssetData> CandidateAssets;
+
+	bool bScanCandidateAssets = false;
+
+	FReferencerIndex& ReferencerIndex;
+
+	// collected on the game thread in Start, used when bFindUnreachable
+	FReachabilityRoots Roots;
+
+	bool bFindUnreachable = false;
+
+	const FPathExclusionRules& ExclusionRules;
+
+	FOnUnusedAssetScanFinished OnFinished;
+
+	TSharedPtr<SNotificationItem> ProgressNotification;
+
+	TFuture<void> WorkerFuture;
+
+	std::atomic<bool> bCancelRequested { false };
+
+	std::atomic<bool> bIsRunning { false };
+};
@@ -6,6 +6,20 @@
 #include "AssetToolsModule.h"
 #include "AssetViewUtils.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetScan/ReferencerIndex.h"
+#include "AssetScan/UnusedAssetScan.h"
+#include "AssetScan/PathExclusionRules.h"
+#include "AssetScan/AssetSizeCache.h"
+#include "AssetScan/AssetRecordStore.h"
+#include "AssetScan/FolderRootSet.h"
+#include "AssetScan/DuplicateContentScan.h"
+#include "AssetAction/RedirectorFixUpService.h"
+#include "AssetAction/AssetPrefixTable.h"
+#include "AssetAction/AssetDeletionQueue.h"
+
+class SDuplicateContentTab;
+class SDeletionPreviewTab;
+class FDeletionPreview;
 
 class FBacgroundToolsModule : public IModuleInterface
 {
@@ -21,7 +35,8 @@ private:
 
 	void InitCBMenuExtention();
 
-	TArray<FString> SelectedFolderPaths;
+	// the Content Browser selection merged into non overlapping roots
+	FFolderRootSet SelectedFolderRoots;
 
 	TSharedRef<FExtender> CustomCBMenuExtender(const TArray<FString>& SelectedPaths);
 
@@ -29,11 +44,18 @@ private:
 
 	void OnDeleteUnsuedAssetButtonClicked();
 
+	void OnUnusedAssetScanFinished(const TArray<FAssetData>& UnusedAssetsDataArray, const TArray<TArray<FName>>& UnreachableCycles,
+		FString NothingFoundMessage);
+
 	void OnDeleteEmptyFoldersButtonClicked();
 
 	void OnAdvancedDeletionButtonClicked();
-	
-	void FixUpRedirectors();
+
+	void OnNamingAuditButtonClicked();
+
+	void OnFindDuplicateContentButtonClicked();
+
+	void OnDuplicateContentScanFinished(const TArray<FDuplicateContentGroup>& Groups);
 
 #pragma endregion
 
@@ -43,7 +65,25 @@ private:
 
 	TSharedRef<SDockTab> OnSpawnAdvanceDeletionTab(const FSpawnTabArgs& SpawnTabArgs);
 
-	TArray< TSharedPtr <FAssetData> > GetAllAssetData();
+	void RegisterNamingAuditTab();
+
+	TSharedRef<SDockTab> OnSpawnNamingAuditTab(const FSpawnTabArgs& SpawnTabArgs);
+
+	void RegisterDuplicateContentTab();
+
+	TSharedRef<SDockTab> OnSpawnDuplicateContentTab(const FSpawnTabArgs& SpawnTabArgs);
+
+	void RegisterDeletionPreviewTab();
+
+	TSharedRef<SDockTab> OnSpawnDeletionPreviewTab(const FSpawnTabArgs& SpawnTabArgs);
+
+	/** Bound to the deletion queue, shows the assets of a confirmed flush in the preview tab instead of deleting them */
+	void OnDeletionPreviewRequested(const TArray<FAssetData>& AssetsToDelete);
+
+	void ShowDeletionPreview(const TSharedPtr<FDeletionPreview>& Preview);
+
+	/** Records of the selected folders, excluded paths skipped */
+	TSharedPtr<FAssetRecordStore> GetAllAssetRecords();
 
 #pragma endregion
 
@@ -53,6 +93,62 @@ public:
 
 	bool DeleteSingleAssetForAssetList(const FAssetData& AssetDataToDelete);
 
+	int32 DeleteMultipleAssetsForAssetList(const TArray<FAssetData>& AssetsDataToDelete);
+
 #pragma endregion
 
+	/** Checks the assets for unused ones in the background, the unused ones found go to the deletion queue */
+	void StartUnusedAssetScan(TArray<FAssetData>&& Assets);
+
+	/** Hashes the content under the roots in the background, the groups found are shown in the duplicate content tab */
+	void StartDuplicateContentScan(const FFolderRootSet& FolderRoots);
+
+	FReferencerIndex& GetReferencerIndex() { return ReferencerIndex; }
+
+	FRedirectorFixUpService& GetRedirectorFixUpService() { return RedirectorFixUpService; }
+
+	FAssetDeletionQueue& GetAssetDeletionQueue() { return AssetDeletionQueue; }
+
+	FAssetPrefixTable& GetPrefixTable() { return PrefixTable; }
+
+	const FPathExclusionRules& GetPathExclusionRules() const { return PathExclusionRules; }
+
+	FAssetSizeCache& GetAssetSizeCache() { return AssetSizeCache; }
+
+private:
+
+	FReferencerIndex ReferencerIndex;
+
+	FRedirectorFixUpService RedirectorFixUpService;
+
+	FAssetDeletionQueue AssetDeletionQueue;
+
+	FAssetPrefixTable PrefixTable;
+
+	FPathExclusionRules PathExclusionRules;
+
+	FAssetSizeCache AssetSizeCache;
+
+	TSharedPtr<FUnusedAssetScan, ESPMode::ThreadSafe> ActiveUnusedAssetScan;
+
+	TSharedPtr<FDuplicateContentScan, ESPMode::ThreadSafe> ActiveDuplicateContentScan;
+
+	// result of the last duplicate scan, handed to the tab when it spawns
+	FFolderRootSet DuplicateContentFolderRoots;
+
+	TSharedPtr< TArray <FDuplicateContentGroup> > DuplicateContentGroups;
+
+	TWeakPtr<SDuplicateContentTab> DuplicateContentTab;
+
+	// built on the thread pool, a newer request replaces it
+	TSharedPtr<FDeletionPreview> BuildingDeletionPreview;
+
+	// waited for on shutdown, a replaced build still uses the index
+	TArray<TFuture<void>> DeletionPreviewFutures;
+
+	// handed to the preview tab when it spawns
+	TSharedPtr<FDeletionPreview> PendingDeletionPreview;
+
+	TWeakPtr<SDeletionPreviewTab> DeletionPreviewTab;
+
 };
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Engine/DataAsset.h"
+
+#include "BacgroundToolsBenchmarkCommandlet.generated.h"
+
+/**
+ * Asset of the synthetic benchmark trees, its hard references become package dependencies.
+ * Hidden from the class viewer and the class pickers, the data asset factory included.
+ * It can't be Transient, the benchmark saves it to disk.
+ */
+UCLASS(NotBlueprintable, NotBlueprintType, Hidden, HideDropdown)
+class BACGROUNDTOOLS_API UBacgroundToolsBenchmarkAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TArray<TObjectPtr<UObject>> References;
+};
+
+/**
+ * Times every BacgroundTools operation end to end over synthetic content trees.
+ *
+ * UnrealEditor-Cmd <Project>.uproject -run=BacgroundToolsBenchmark -nullrhi -unattended
+ *     [-Sizes=1000,10000,100000] [-FanOut=4] [-RedirectorPercent=5] [-RootPercent=1]
+ *     [-AssetsPerFolder=100] [-EmptyFolders=100] [-Seed=1] [-Report=<file>.csv] [-KeepContent]
+ *
+ * Each tree is generated under a temporary mount point and removed afterwards.
+ * One row per stage and tree size with the wall time, the operation counters
+ * and the memory high-water mark goes to Saved/Profiling/BacgroundToolsBenchmark.csv.
+ */
+UCLASS()
+class BACGROUNDTOOLS_API UBacgroundToolsBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBacgroundToolsBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
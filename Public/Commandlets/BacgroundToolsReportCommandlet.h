@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "BacgroundToolsReportCommandlet.generated.h"
+
+/**
+ * Headless unused asset / empty folder / redirector report for build machines.
+ *
+ * UnrealEditor-Cmd <Project>.uproject -run=BacgroundToolsReport -nullrhi -unattended
+ *     [-Path=/Game[+/Plugin/Folder...]] [-Report=<file>.json|.csv] [-Apply]
+ *
+ * Several roots are scanned in one pass, the registry queries run per root in parallel.
+ * -Apply fixes up the redirectors, deletes the unused assets and then the empty folders.
+ * The report is written to Saved/BacgroundTools/Report.json when -Report is not given.
+ */
+UCLASS()
+class BACGROUNDTOOLS_API UBacgroundToolsReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBacgroundToolsReportCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("BacgroundTools"), STATGROUP_BacgroundTools, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Assets Scanned"), STAT_BacgroundTools_AssetsScanned, STATGROUP_BacgroundTools, BACGROUNDTOOLS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Registry Queries"), STAT_BacgroundTools_RegistryQueries, STATGROUP_BacgroundTools, BACGROUNDTOOLS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Packages Loaded"), STAT_BacgroundTools_PackagesLoaded, STATGROUP_BacgroundTools, BACGROUNDTOOLS_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("GC Passes"), STAT_BacgroundTools_GCPasses, STATGROUP_BacgroundTools, BACGROUNDTOOLS_API);
+
+enum class EOperationCounter : uint8
+{
+	AssetsScanned,
+	RegistryQueries,
+	PackagesLoaded,
+	GCPasses,
+	Num
+};
+
+/**
+ * Counters shared by every operation of the plugin, also visible with "stat BacgroundTools".
+ * Each FScopedOperationProfile logs its wall time with the counters that moved meanwhile
+ * and appends the same line to Saved/Profiling/BacgroundTools.csv.
+ */
+class BACGROUNDTOOLS_API FOperationProfiler
+{
+public:
+	/** Thread safe, workers count too */
+	static void AddCount(EOperationCounter Counter, int64 Amount = 1);
+
+	static int64 GetCount(EOperationCounter Counter);
+
+	static const TCHAR* GetCounterName(EOperationCounter Counter);
+
+	static FString GetCsvFilename();
+
+private:
+	friend class FScopedOperationProfile;
+
+	static void WriteSummary(const TCHAR* OperationName, double Seconds, const int64* CounterDeltas);
+};
+
+/** Wall time and counter deltas of one operation, reported when the scope ends */
+class BACGROUNDTOOLS_API FScopedOperationProfile
+{
+public:
+	explicit FScopedOperationProfile(const TCHAR* InOperationName);
+	~FScopedOperationProfile();
+
+private:
+	const TCHAR* OperationName;
+
+	double StartTime;
+
+	int64 StartCounts[static_cast<int32>(EOperationCounter::Num)];
+};
+
+// Insights event plus a summary line, Name has to be a string literal
+#define BACGROUNDTOOLS_PROFILE_OPERATION(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR(Name); \
+	FScopedOperationProfile ANONYMOUS_VARIABLE(OperationProfile)(TEXT(Name))
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "UObject/SoftObjectPath.h"
+#include "Engine/EngineTypes.h"
+
+#include "BacgroundToolsSettings.generated.h"
+
+/**
+ * Project settings of the BacgroundTools plugin (Project Settings > Plugins > Bacground Tools)
+ */
+UCLASS(config = Editor, defaultconfig, meta = (DisplayName = "Bacground Tools"))
+class BACGROUNDTOOLS_API UBacgroundToolsSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UBacgroundToolsSettings();
+
+	/** Name prefix per asset class. Subclasses use the prefix of their closest listed parent class */
+	UPROPERTY(config, EditAnywhere, Category = "Naming", meta = (MetaClass = "/Script/CoreUObject.Object", AllowAbstract = "true"))
+	TMap<FSoftClassPath, FString> AssetPrefixes;
+
+	/**
+	 * Folders never scanned, listed or deleted.
+	 * "/Game/Some/Folder" or "/PluginMount" excludes that folder and its subfolders,
+	 * "FolderName" excludes every folder with that name. * and ? wildcards are allowed, case is ignored.
+	 */
+	UPROPERTY(config, EditAnywhere, Category = "Scanning")
+	TArray<FString> ExcludedPaths;
+
+	/** Unused means not reachable from the roots below, so chains and cycles of unused assets are found too. Off : unused means no referencer */
+	UPROPERTY(config, EditAnywhere, Category = "Unused Assets")
+	bool bFindUnreachableAssets = true;
+
+	/** Maps to cook from the packaging settings are roots, every map when that list is empty */
+	UPROPERTY(config, EditAnywhere, Category = "Unused Assets", meta = (EditCondition = "bFindUnreachableAssets"))
+	bool bMapsAreRoots = true;
+
+	/** Primary assets known to the asset manager are roots */
+	UPROPERTY(config, EditAnywhere, Category = "Unused Assets", meta = (EditCondition = "bFindUnreachableAssets"))
+	bool bPrimaryAssetsAreRoots = true;
+
+	/** Directories to always cook from the packaging settings are roots */
+	UPROPERTY(config, EditAnywhere, Category = "Unused Assets", meta = (EditCondition = "bFindUnreachableAssets"))
+	bool bAlwaysCookDirectoriesAreRoots = true;
+
+	/** Engine and plugin content are roots, their references into /Game keep those assets */
+	UPROPERTY(config, EditAnywhere, Category = "Unused Assets", meta = (EditCondition = "bFindUnreachableAssets"))
+	bool bContentOutsideGameIsRoot = true;
+
+	/** Everything under these folders is a root */
+	UPROPERTY(config, EditAnywhere, Category = "Unused Assets", meta = (EditCondition = "bFindUnreachableAssets", ContentDir, LongPackageName))
+	TArray<FDirectoryPath> AdditionalRootDirectories;
+
+	/** Assets loaded and deleted per step of a deletion, garbage collection runs once for all of them */
+	UPROPERTY(config, EditAnywhere, Category = "Deletion", meta = (ClampMin = "1"))
+	int32 DeletionChunkSize = 500;
+
+	/** Deleting more than one asset opens the Deletion Preview tab (sizes, modification times, reference graph) instead of a confirmation dialog */
+	UPROPERTY(config, EditAnywhere, Category = "Deletion")
+	bool bPreviewDeletions = true;
+
+	/** Referencer and dependency levels shown around the deleted assets in the preview graph */
+	UPROPERTY(config, EditAnywhere, Category = "Deletion", meta = (ClampMin = "1", ClampMax = "8", EditCondition = "bPreviewDeletions"))
+	int32 PreviewGraphDepth = 2;
+
+	/** The preview graph stops growing past this many packages, the asset list always shows every asset */
+	UPROPERTY(config, EditAnywhere, Category = "Deletion", meta = (ClampMin = "100", EditCondition = "bPreviewDeletions"))
+	int32 PreviewGraphMaxNodes = 20000;
+
+	/** Appends one row per operation to Saved/Profiling/BacgroundTools.csv, the log summary is always written */
+	UPROPERTY(config, EditAnywhere, Category = "Profiling")
+	bool bWriteOperationProfileCsv = true;
+
+	static const UBacgroundToolsSettings* Get() { return GetDefault<UBacgroundToolsSettings>(); }
+
+	virtual FName GetCategoryName() const override { return FName("Plugins"); }
+};
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+class FAssetRecordStore;
+
+enum class EAdvanceDeletionFilterType : uint8
+{
+	All,
+	UnusedOnly,
+	ByClass,
+	PrefixMismatch,
+	LargerThan,
+	OlderThan
+};
+
+struct FAdvanceDeletionFilterSettings
+{
+	EAdvanceDeletionFilterType Type = EAdvanceDeletionFilterType::All;
+
+	// ByClass
+	FTopLevelAssetPath AssetClass;
+
+	// LargerThan
+	int64 MinSizeBytes = 0;
+
+	// OlderThan
+	int32 MinAgeDays = 0;
+};
+
+/**
+ * Precomputed per-class / per-flag index arrays and presorted orders over the tab's asset records.
+ * Changing the filter or the sort column only walks these arrays, the registry is not queried again.
+ * Indices refer to the records given to Build, rebuild after a record was added or removed.
+ */
+class BACGROUNDTOOLS_API FAdvanceDeletionAssetIndex
+{
+public:
+	/** Also fills the record sizes still missing */
+	void Build(FAssetRecordStore& InRecords);
+
+	void Reset();
+
+	bool IsBuilt() const { return Records != nullptr; }
+
+	const TArray<FTopLevelAssetPath>& GetAssetClasses() const { return AssetClasses; }
+
+	/**
+	 * Fills OutView with the indices of the assets passing Filter, in SortColumn order.
+	 * Returns false while the filter still waits for background data, OutView then holds what is known so far
+	 */
+	bool BuildView(const FAdvanceDeletionFilterSettings& Filter, FName SortColumn, EColumnSortMode::Type SortMode,
+		TArray<int32>& OutView);
+
+	/** Takes the footprints the size cache computed since the last call into the records and re-sorts the size order, file times are re-read on their next use */
+	void RefreshDiskSizes();
+
+	/** Measures the loaded assets again and re-sorts the memory order, returns true when a size changed */
+	bool RefreshResourceSizes();
+
+private:
+	/** False until the referencer index is built, it is built in the background meanwhile */
+	bool EnsureUnusedIndices();
+
+	/** False until the size cache stat-ed every package, the unknown ones sort last and never match meanwhile */
+	bool EnsureModificationTimes();
+
+	const TArray<int32>* GetSortOrder(FName SortColumn);
+
+	FAssetRecordStore* Records = nullptr;
+
+	// per class index of the records
+	TArray<TArray<int32>> ClassIndices;
+
+	// classes having records, sorted by name
+	TArray<FTopLevelAssetPath> AssetClasses;
+
+	TArray<int32> PrefixMismatchIndices;
+
+	// filled on first use once the referencer index is built, one lock for all the records
+	TArray<int32> UnusedIndices;
+	bool bHasUnusedIndices = false;
+
+	// filled on first use from the size cache, nothing is stat-ed on the game thread
+	TArray<FDateTime> ModificationTimes;
+	bool bHasModificationTimes = false;
+
+	// asset indices presorted ascending per column
+	TArray<int32> NameOrder;
+	TArray<int32> ClassOrder;
+	TArray<int32> SizeOrder;
+	TArray<int32> ResourceSizeOrder;
+	TArray<int32> AgeOrder;
+};
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "UObject/SoftObjectPath.h"
+#include "AssetScan/AssetRecordStore.h"
+#include "AssetScan/FolderRootSet.h"
+
+DECLARE_DELEGATE(FOnAssetListChangesQueued);
+
+/**
+ * Live asset list behind SAdvanceDeletionTab.
+ * Follows the asset registry events for its root folders and queues them as deltas,
+ * the tab applies them in one batch per frame instead of re-scanning the folder.
+ */
+class BACGROUNDTOOLS_API FAdvanceDeletionListModel
+{
+public:
+	FAdvanceDeletionListModel(const FFolderRootSet& InFolderRoots, TSharedPtr<FAssetRecordStore> InRecords);
+	~FAdvanceDeletionListModel();
+
+	/** Asset records, the store object stays the same for the lifetime of the model */
+	const TSharedPtr<FAssetRecordStore>& GetRecords() const { return Records; }
+
+	const FFolderRootSet& GetFolderRoots() const { return FolderRoots; }
+
+	/** Called once when the first change is queued after the last ApplyPendingChanges */
+	FOnAssetListChangesQueued OnChangesQueued;
+
+	bool HasPendingChanges() const { return PendingRemovals.Num() > 0 || PendingUpserts.Num() > 0; }
+
+	/** Applies every queued change, returns true when the records were modified */
+	bool ApplyPendingChanges();
+
+	/** Removes an asset right away, e.g. after deleting it from the tab */
+	void RemoveAsset(int32 AssetIndex);
+
+#pragma region Selection
+
+	bool IsSelected(int32 AssetIndex) const { return Records->IsSelected(AssetIndex); }
+
+	void SetSelected(int32 AssetIndex, bool bSelected) { Records->SetSelected(AssetIndex, bSelected); }
+
+	void SelectAll() { Records->SelectAll(); }
+
+	void DeselectAll() { Records->DeselectAll(); }
+
+	int32 GetNumSelected() const { return Records->GetNumSelected(); }
+
+	/** Full registry data of the selection, one registry query */
+	void GetSelectedAssets(TArray<FAssetData>& OutSelectedAssets) const { Records->GetSelectedAssetData(OutSelectedAssets); }
+
+#pragma endregion
+
+private:
+	bool IsUnderRoot(const FAssetData& AssetData) const;
+
+	bool IsTracked(const FSoftObjectPath& ObjectPath) const;
+
+	void QueueUpsert(const FAssetData& AssetData);
+
+	void QueueRemoval(const FSoftObjectPath& ObjectPath);
+
+#pragma region AssetRegistryEvents
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void OnAssetUpdated(const FAssetData& AssetData);
+
+	FDelegateHandle AssetAddedHandle;
+	FDelegateHandle AssetRemovedHandle;
+	FDelegateHandle AssetRenamedHandle;
+	FDelegateHandle AssetUpdatedHandle;
+
+#pragma endregion
+
+	FFolderRootSet FolderRoots;
+
+	TSharedPtr<FAssetRecordStore> Records;
+
+	TSet<FSoftObjectPath> PendingRemovals;
+
+	TMap<FSoftObjectPath, FAssetData> PendingUpserts;
+};
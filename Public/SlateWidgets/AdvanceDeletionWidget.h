@@ -3,12 +3,28 @@
 #pragma once
 
 #include "Widgets/SCompoundWidget.h"
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+#include "SlateWidgets/AdvanceDeletionFilter.h"
+#include "Widgets/Input/SComboBox.h"
+#include "SlateWidgets/ForwardingTableRow.h"
+
+namespace AdvanceDeletionColumns
+{
+	static const FName CheckBox(TEXT("CheckBox"));
+	static const FName AssetClass(TEXT("AssetClass"));
+	static const FName AssetName(TEXT("AssetName"));
+	static const FName DiskSize(TEXT("DiskSize"));
+	static const FName ResourceSize(TEXT("ResourceSize"));
+	static const FName DeleteButton(TEXT("DeleteButton"));
+}
 
 class SAdvanceDeletionTab : public SCompoundWidget
 {
+	friend class SForwardingTableRow<SAdvanceDeletionTab, int32>;
+
 	SLATE_BEGIN_ARGS(SAdvanceDeletionTab) {}
 
-	SLATE_ARGUMENT(TArray< TSharedPtr <FAssetData> >, AssetsDataToStore)
+	SLATE_ARGUMENT(TSharedPtr<FAdvanceDeletionListModel>, AssetListModel)
 
 	SLATE_END_ARGS()
 
@@ -16,28 +32,161 @@ public:
 	void Construct(const FArguments& InArgs);
 
 private:
-	TArray <TSharedPtr <FAssetData> > StoredAssetData;
+	TSharedPtr<FAdvanceDeletionListModel> AssetListModel;
+
+	// compact per-asset records, full FAssetData is only fetched for deletion and tooltips
+	TSharedPtr<FAssetRecordStore> Records;
+
+	// list items alias into ViewIndices so rows cost no allocation
+	TArray <TSharedPtr <int32> > AssetListItems;
+
+	/** Rebuilds the list items from ViewIndices */
+	void RebuildAssetListItems();
+
+	/** Record index of a list item, INDEX_NONE once the record is gone */
+	int32 GetAssetIndex(const TSharedPtr<int32>& Item) const;
+
+	TSharedRef < SListView < TSharedPtr <int32> > > ConstructAssetListView();
 
-	TSharedRef < SListView < TSharedPtr <FAssetData> > > ConstructAssetListView();
+	TSharedPtr < SListView < TSharedPtr <int32> > > ConstructedAssetListView;
 
-	TSharedPtr < SListView < TSharedPtr <FAssetData> > > ConstructedAssetListView;
+	TSharedRef<SHeaderRow> ConstructHeaderRow();
 
 	void RefreshAssetListView();
 
+	void OnAssetListChangesQueued();
+
+	EActiveTimerReturnType ApplyAssetListChanges(double InCurrentTime, float InDeltaTime);
+
+	bool bIsApplyChangesTimerRegistered = false;
+
+	// registry deltas rebuild the index at most once a second
+	double LastAssetRecordsChangeTime = 0.0;
+
+#pragma region FilterAndSort
+
+	FAdvanceDeletionAssetIndex AssetIndex;
+
+	FAdvanceDeletionFilterSettings FilterSettings;
+
+	// record indices of the assets passing the filter, in display order.
+	// a new array per view, items still held by the list keep the previous one alive
+	TSharedPtr< TArray <int32> > ViewIndices;
+
+	FName SortColumn;
+
+	EColumnSortMode::Type SortMode = EColumnSortMode::None;
+
+	/** Rebuilds the index if the assets changed, then the view and the list */
+	void ApplyFilterAndSort();
+
+	/** The records changed, the index has to be rebuilt */
+	void OnAssetRecordsChanged();
+
+	// the filter still waits for background data (referencer index, file times), the view is rebuilt until it has it
+	bool bIsViewPending = false;
+
+	EActiveTimerReturnType RetryPendingView(double InCurrentTime, float InDeltaTime);
+
+	bool bIsPendingViewRetryRegistered = false;
+
+	TSharedRef<SWidget> ConstructFilterBar();
+
+	TArray< TSharedPtr <FString> > FilterOptions;
+
+	TArray< TSharedPtr <FString> > ClassOptions;
+
+	// same order as ClassOptions
+	TArray<FTopLevelAssetPath> ClassOptionPaths;
+
+	void RefreshClassOptions();
+
+	TSharedPtr< SComboBox < TSharedPtr <FString> > > ClassComboBox;
+
+	TSharedRef<SWidget> OnGenerateComboContent(TSharedPtr<FString> Option);
+
+	void OnFilterOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo);
+
+	void OnClassOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo);
+
+	FText GetFilterOptionText() const;
+
+	FText GetClassOptionText() const;
+
+	EVisibility GetClassComboVisibility() const;
+
+	// "N" of "Size > N MB" and "Older than N days"
+	int32 FilterValue = 1;
+
+	int32 GetFilterValue() const { return FilterValue; }
+
+	void OnFilterValueCommitted(int32 NewValue, ETextCommit::Type CommitType);
+
+	EVisibility GetFilterValueVisibility() const;
+
+	FText GetFilterValueUnitText() const;
+
+	FText GetViewCountText() const;
+
+	/** Size cache progress, the size order is refreshed at most every DiskSizeRefreshPeriod */
+	void OnAssetDiskSizesUpdated();
+
+	EActiveTimerReturnType RefreshDiskSizes(double InCurrentTime, float InDeltaTime);
+
+	bool bIsDiskSizeRefreshRegistered = false;
+
+	/** An asset was loaded or garbage collected, the memory sizes are measured again at most every ResourceSizeRefreshPeriod */
+	void OnLoadedAssetsChanged();
+
+	void OnAssetLoaded(UObject* LoadedAsset) { OnLoadedAssetsChanged(); }
+
+	EActiveTimerReturnType RefreshResourceSizes(double InCurrentTime, float InDeltaTime);
+
+	bool bIsResourceSizeRefreshRegistered = false;
+
+	EColumnSortMode::Type GetColumnSortMode(FName ColumnName) const;
+
+	void OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnName,
+		EColumnSortMode::Type NewSortMode);
+
+#pragma endregion
+
 #pragma region RowWidgetForAssetListView
 
-	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<FAssetData> AssetDataToDisplay,
+	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<int32> ItemToDisplay,
 		const TSharedRef<STableViewBase>& OwnerTable);
 
-	TSharedRef<SCheckBox> ConstructCheckBox(const TSharedPtr<FAssetData>& AssetDataToDisplay);
+	/** Called by the rows, only for rows the list view actually shows */
+	TSharedRef<SWidget> ConstructWidgetForColumn(const FName& ColumnName, const TSharedPtr<int32>& ItemToDisplay);
+
+	const FText& GetAssetClassText(int32 AssetIndex);
+
+	/** Disk footprint once the size cache has it, registry package size until then */
+	FText GetDiskSizeText(TSharedPtr<int32> Item) const;
+
+	/** Estimated memory size the index measured, only known for loaded assets */
+	FText GetResourceSizeText(TSharedPtr<int32> Item) const;
+
+	/** Built when the tooltip opens, the only place the row needs the full registry data */
+	FText GetAssetToolTipText(TSharedPtr<int32> Item) const;
+
+	// one FText per record class index instead of a conversion per generated row
+	TMap<int32, FText> AssetClassTextCache;
+
+	FSlateFontInfo AssetClassFont;
+	FSlateFontInfo AssetNameFont;
+
+	TSharedRef<SCheckBox> ConstructCheckBox(const TSharedPtr<int32>& ItemToDisplay);
+
+	void OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<int32> Item);
 
-	void OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FAssetData> AssetData);
+	ECheckBoxState GetCheckBoxState(TSharedPtr<int32> Item) const;
 
-	TSharedRef<STextBlock> ConstructTextForRowWidget(const FString& TextContent, const FSlateFontInfo& FontToUse);
+	TSharedRef<STextBlock> ConstructTextForRowWidget(const FText& TextContent, const FSlateFontInfo& FontToUse);
 
-	TSharedRef<SButton> ConstructButtonForRowWidget(const TSharedPtr<FAssetData>& AssetDataToDisplay);
+	TSharedRef<SButton> ConstructButtonForRowWidget(const TSharedPtr<int32>& ItemToDisplay);
 
-	FReply OnDeleteButtonClicked(TSharedPtr<FAssetData> ClickedAssetdata);
+	FReply OnDeleteButtonClicked(TSharedPtr<int32> ClickedItem);
 
 #pragma endregion
 
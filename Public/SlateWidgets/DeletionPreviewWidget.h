@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "AssetAction/DeletionPreview.h"
+#include "SlateWidgets/ForwardingTableRow.h"
+
+class SDependencyGraphView;
+
+namespace DeletionPreviewColumns
+{
+	static const FName CheckBox(TEXT("CheckBox"));
+	static const FName AssetClass(TEXT("AssetClass"));
+	static const FName AssetName(TEXT("AssetName"));
+	static const FName DiskSize(TEXT("DiskSize"));
+	static const FName Modified(TEXT("Modified"));
+	static const FName Referencers(TEXT("Referencers"));
+}
+
+/**
+ * Dry run of a pending deletion: every asset with its size, modification time and outside referencers,
+ * next to the reference graph around them. Nothing is deleted until the checked assets are approved.
+ */
+class SDeletionPreviewTab : public SCompoundWidget
+{
+	friend class SForwardingTableRow<SDeletionPreviewTab, FDeletionPreviewEntry>;
+
+	SLATE_BEGIN_ARGS(SDeletionPreviewTab) {}
+
+	SLATE_ARGUMENT(TSharedPtr<FDeletionPreview>, Preview)
+
+	SLATE_END_ARGS()
+
+public:
+	void Construct(const FArguments& InArgs);
+
+	/** Shows a new pending deletion, null empties the tab */
+	void SetPreview(TSharedPtr<FDeletionPreview> InPreview);
+
+private:
+	// list items alias into the preview's entry array
+	TSharedPtr<FDeletionPreview> Preview;
+
+	// checked state, one bit per entry
+	TBitArray<> Selection;
+
+	TArray< TSharedPtr <FDeletionPreviewEntry> > EntryListItems;
+
+	TSharedPtr< SListView < TSharedPtr <FDeletionPreviewEntry> > > EntryListView;
+
+	TSharedPtr<SDependencyGraphView> GraphView;
+
+	void RebuildEntryListItems();
+
+	int32 GetEntryIndex(const TSharedPtr<FDeletionPreviewEntry>& Entry) const;
+
+	TSharedRef<SHeaderRow> ConstructHeaderRow();
+
+	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<FDeletionPreviewEntry> Entry,
+		const TSharedRef<STableViewBase>& OwnerTable);
+
+	TSharedRef<SWidget> ConstructWidgetForColumn(const FName& ColumnName, const TSharedPtr<FDeletionPreviewEntry>& Entry);
+
+	void OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FDeletionPreviewEntry> Entry);
+
+	ECheckBoxState GetCheckBoxState(TSharedPtr<FDeletionPreviewEntry> Entry) const;
+
+	FText GetSummaryText() const;
+
+#pragma region Graph
+
+	/** Selecting a row centers the graph on its package */
+	void OnEntrySelectionChanged(TSharedPtr<FDeletionPreviewEntry> Entry, ESelectInfo::Type SelectInfo);
+
+	/** Clicking a deleted package selects its first row */
+	void OnGraphNodeClicked(int32 NodeIndex);
+
+	int32 GetGraphDepth() const;
+
+	void OnGraphDepthCommitted(int32 NewDepth, ETextCommit::Type CommitType);
+
+	FText GetGraphStatusText() const;
+
+#pragma endregion
+
+	FReply OnDeleteButtonClicked();
+	FReply OnSelectAllButtonClicked();
+	FReply OnDeselectAllButtonClicked();
+	FReply OnCancelButtonClicked();
+
+	TSharedRef<SButton> ConstructTabButton(const FString& TextContent, FReply (SDeletionPreviewTab::*OnClicked)());
+
+	FSlateFontInfo RowFont;
+};
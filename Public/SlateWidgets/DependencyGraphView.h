@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Widgets/SLeafWidget.h"
+#include "AssetAction/DeletionPreview.h"
+
+/**
+ * Layered layout of a deletion preview graph, one column per layer.
+ * Every node is placed right away, the crossing reduction (barycenter sweeps over the columns)
+ * then runs a slice at a time within a time budget, so tens of thousands of nodes never block a frame.
+ */
+class BACGROUNDTOOLS_API FDependencyGraphLayout
+{
+public:
+	void Reset(const FDeletionPreviewGraph& InGraph);
+
+	/** Continues the sweeps until TimeBudget seconds are spent, returns true once the layout is settled */
+	bool Step(double TimeBudget);
+
+	bool IsSettled() const { return bIsSettled; }
+
+	const TArray<FVector2D>& GetPositions() const { return Positions; }
+
+	const FBox2D& GetBounds() const { return Bounds; }
+
+private:
+	/** Sorts a column by the barycenters computed for it and moves its nodes */
+	void PlaceColumn(int32 ColumnIndex);
+
+	void UpdateBounds();
+
+	// node indices per column, top to bottom
+	TArray<TArray<int32>> Columns;
+
+	TArray<int32> ColumnOfNode;
+
+	// undirected neighbours in CSR layout
+	TArray<int32> NeighbourOffsets;
+
+	TArray<int32> Neighbours;
+
+	TArray<FVector2D> Positions;
+
+	TArray<float> Barycenters;
+
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	// resumable sweep state, even sweeps go left to right
+	int32 Sweep = 0;
+
+	int32 SweepColumn = 0;
+
+	int32 NextNodeInColumn = 0;
+
+	bool bSweepMovedNodes = false;
+
+	bool bIsSettled = true;
+};
+
+DECLARE_DELEGATE_OneParam(FOnGraphNodeClicked, int32 /*NodeIndex*/);
+
+/**
+ * Pannable, zoomable view of a deletion preview graph. Only the nodes and edges inside the
+ * viewport are painted and labels are dropped when zoomed out, the layout advances on an active timer.
+ */
+class SDependencyGraphView : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SDependencyGraphView) {}
+
+	SLATE_ARGUMENT(TSharedPtr<FDeletionPreview>, Preview)
+
+	SLATE_EVENT(FOnGraphNodeClicked, OnNodeClicked)
+
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/** Call after the preview graph was rebuilt, the layout starts over */
+	void SetPreview(TSharedPtr<FDeletionPreview> InPreview);
+
+	/** Centers the view on a node and highlights its edges */
+	void FocusNode(int32 NodeIndex);
+
+	bool IsLayoutSettled() const { return Layout.IsSettled(); }
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+
+	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+
+	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+
+	virtual FReply OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+
+protected:
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	EActiveTimerReturnType StepLayout(double InCurrentTime, float InDeltaTime);
+
+	void StartLayout();
+
+	FVector2D GraphToLocal(const FVector2D& GraphPosition, const FVector2D& LocalSize) const;
+
+	FVector2D LocalToGraph(const FVector2D& LocalPosition, const FVector2D& LocalSize) const;
+
+	int32 FindNodeAt(const FVector2D& LocalPosition, const FVector2D& LocalSize) const;
+
+	FLinearColor GetNodeColor(int32 NodeIndex) const;
+
+	TSharedPtr<FDeletionPreview> Preview;
+
+	FDependencyGraphLayout Layout;
+
+	FOnGraphNodeClicked OnNodeClicked;
+
+	// graph space point at the center of the view
+	FVector2D ViewCenter = FVector2D::ZeroVector;
+
+	float Zoom = 1.f;
+
+	int32 FocusedNode = INDEX_NONE;
+
+	bool bIsPanning = false;
+
+	// a press that moved is a pan, not a click
+	bool bMovedWhilePanning = false;
+
+	bool bIsLayoutTimerRegistered = false;
+
+	FSlateFontInfo LabelFont;
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "AssetScan/DuplicateContentScan.h"
+#include "SlateWidgets/ForwardingTableRow.h"
+
+namespace DuplicateContentColumns
+{
+	static const FName CheckBox(TEXT("CheckBox"));
+	static const FName Keep(TEXT("Keep"));
+	static const FName Group(TEXT("Group"));
+	static const FName Match(TEXT("Match"));
+	static const FName AssetClass(TEXT("AssetClass"));
+	static const FName AssetName(TEXT("AssetName"));
+	static const FName DiskSize(TEXT("DiskSize"));
+}
+
+/** One asset of a duplicate group, as listed in the tab */
+struct FDuplicateContentListItem
+{
+	int32 GroupIndex = INDEX_NONE;
+
+	int32 EntryIndex = INDEX_NONE;
+};
+
+/**
+ * Groups of assets sharing their content, one row per asset.
+ * A checked group is consolidated into its kept asset, the others are deleted.
+ */
+class SDuplicateContentTab : public SCompoundWidget
+{
+	friend class SForwardingTableRow<SDuplicateContentTab, FDuplicateContentListItem>;
+
+	SLATE_BEGIN_ARGS(SDuplicateContentTab) {}
+
+	SLATE_ARGUMENT(FFolderRootSet, FolderRoots)
+
+	SLATE_ARGUMENT(TSharedPtr< TArray <FDuplicateContentGroup> >, Groups)
+
+	SLATE_END_ARGS()
+
+public:
+	void Construct(const FArguments& InArgs);
+
+	/** Shows the result of a new scan */
+	void SetGroups(const FFolderRootSet& InFolderRoots, TSharedPtr< TArray <FDuplicateContentGroup> > InGroups);
+
+private:
+	// scanned folders, rescans run over the same selection
+	FFolderRootSet FolderRoots;
+
+	TSharedPtr< TArray <FDuplicateContentGroup> > Groups;
+
+	// kept entry per group, the scan's suggestion until a row is picked
+	TArray<int32> KeeperIndices;
+
+	// checked state, one bit per group
+	TBitArray<> GroupSelection;
+
+	TArray< TSharedPtr <FDuplicateContentListItem> > ListItems;
+
+	TSharedPtr< SListView < TSharedPtr <FDuplicateContentListItem> > > ListView;
+
+	void RebuildListItems();
+
+	const FDuplicateContentGroup* GetGroup(const TSharedPtr<FDuplicateContentListItem>& Item) const;
+
+	const FDuplicateContentEntry* GetEntry(const TSharedPtr<FDuplicateContentListItem>& Item) const;
+
+	TSharedRef<SHeaderRow> ConstructHeaderRow();
+
+	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<FDuplicateContentListItem> Item,
+		const TSharedRef<STableViewBase>& OwnerTable);
+
+	TSharedRef<SWidget> ConstructWidgetForColumn(const FName& ColumnName, const TSharedPtr<FDuplicateContentListItem>& Item);
+
+	void OnGroupCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FDuplicateContentListItem> Item);
+
+	ECheckBoxState GetGroupCheckBoxState(TSharedPtr<FDuplicateContentListItem> Item) const;
+
+	void OnKeepCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FDuplicateContentListItem> Item);
+
+	ECheckBoxState GetKeepCheckBoxState(TSharedPtr<FDuplicateContentListItem> Item) const;
+
+#pragma region Filter
+
+	// all groups or identical ones only
+	TArray< TSharedPtr <FString> > FilterOptions;
+
+	int32 FilterIndex = 0;
+
+	bool PassesFilter(const FDuplicateContentGroup& Group) const;
+
+	TSharedRef<SWidget> OnGenerateComboContent(TSharedPtr<FString> Option);
+
+	void OnFilterOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo);
+
+	FText GetFilterOptionText() const;
+
+	FText GetSummaryText() const;
+
+#pragma endregion
+
+	FReply OnConsolidateButtonClicked();
+	FReply OnSelectAllButtonClicked();
+	FReply OnDeselectAllButtonClicked();
+	FReply OnRescanButtonClicked();
+
+	TSharedRef<SButton> ConstructTabButton(const FString& TextContent, FReply (SDuplicateContentTab::*OnClicked)());
+
+	FSlateFontInfo RowFont;
+};
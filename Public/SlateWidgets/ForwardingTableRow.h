@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Widgets/Views/STableRow.h"
+
+/**
+ * Multi column row of the tool tabs, widgets are only built for the rows SListView generates (the visible ones).
+ * Every cell is built by OwnerType::ConstructWidgetForColumn(ColumnName, Item), the row holds no state of its own.
+ */
+template <typename OwnerType, typename ItemType>
+class SForwardingTableRow : public SMultiColumnTableRow< TSharedPtr <ItemType> >
+{
+	using FSuperRowType = SMultiColumnTableRow< TSharedPtr <ItemType> >;
+
+public:
+	SLATE_BEGIN_ARGS(SForwardingTableRow) {}
+
+	SLATE_ARGUMENT(TSharedPtr<ItemType>, Item)
+
+	SLATE_ARGUMENT(TSharedPtr<OwnerType>, OwnerTab)
+
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable)
+	{
+		Item = InArgs._Item;
+		OwnerTab = InArgs._OwnerTab;
+
+		FSuperRowType::Construct(typename FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		TSharedPtr<OwnerType> PinnedOwnerTab = OwnerTab.Pin();
+
+		if (!PinnedOwnerTab.IsValid()) return SNullWidget::NullWidget;
+
+		return PinnedOwnerTab->ConstructWidgetForColumn(ColumnName, Item);
+	}
+
+private:
+	TSharedPtr<ItemType> Item;
+
+	// the tab owns the list view, the rows must not keep it alive
+	TWeakPtr<OwnerType> OwnerTab;
+};
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "AssetAction/NamingAudit.h"
+#include "AssetScan/FolderRootSet.h"
+#include "SlateWidgets/ForwardingTableRow.h"
+
+namespace NamingAuditColumns
+{
+	static const FName CheckBox(TEXT("CheckBox"));
+	static const FName Status(TEXT("Status"));
+	static const FName AssetClass(TEXT("AssetClass"));
+	static const FName AssetName(TEXT("AssetName"));
+	static const FName NewName(TEXT("NewName"));
+}
+
+/**
+ * Naming audit of the selected folders: every misnamed asset with its proposed name, the checked
+ * fixes are applied as one batched rename.
+ */
+class SNamingAuditTab : public SCompoundWidget
+{
+	friend class SForwardingTableRow<SNamingAuditTab, FNamingAuditEntry>;
+
+	SLATE_BEGIN_ARGS(SNamingAuditTab) {}
+
+	SLATE_ARGUMENT(FFolderRootSet, FolderRoots)
+
+	SLATE_END_ARGS()
+
+public:
+	void Construct(const FArguments& InArgs);
+
+private:
+	FFolderRootSet FolderRoots;
+
+	// list items alias into the audit's issue array
+	TSharedPtr<FNamingAudit> Audit;
+
+	// checked state, one bit per issue
+	TBitArray<> Selection;
+
+	TArray< TSharedPtr <FNamingAuditEntry> > IssueListItems;
+
+	TSharedPtr< SListView < TSharedPtr <FNamingAuditEntry> > > IssueListView;
+
+	/** Audits the folders again and rebuilds the list */
+	void RunAudit();
+
+	void RebuildIssueListItems();
+
+	int32 GetIssueIndex(const TSharedPtr<FNamingAuditEntry>& Entry) const;
+
+	TSharedRef<SHeaderRow> ConstructHeaderRow();
+
+	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<FNamingAuditEntry> Entry,
+		const TSharedRef<STableViewBase>& OwnerTable);
+
+	TSharedRef<SWidget> ConstructWidgetForColumn(const FName& ColumnName, const TSharedPtr<FNamingAuditEntry>& Entry);
+
+	void OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FNamingAuditEntry> Entry);
+
+	ECheckBoxState GetCheckBoxState(TSharedPtr<FNamingAuditEntry> Entry) const;
+
+#pragma region Filter
+
+	// all issues, missing prefix only or wrong prefix only
+	TArray< TSharedPtr <FString> > FilterOptions;
+
+	int32 FilterIndex = 0;
+
+	bool PassesFilter(const FNamingAuditEntry& Entry) const;
+
+	TSharedRef<SWidget> OnGenerateComboContent(TSharedPtr<FString> Option);
+
+	void OnFilterOptionSelected(TSharedPtr<FString> SelectedOption, ESelectInfo::Type SelectInfo);
+
+	FText GetFilterOptionText() const;
+
+	FText GetSummaryText() const;
+
+#pragma endregion
+
+	FReply OnApplyButtonClicked();
+	FReply OnSelectAllButtonClicked();
+	FReply OnDeselectAllButtonClicked();
+	FReply OnRefreshButtonClicked();
+
+	TSharedRef<SButton> ConstructTabButton(const FString& TextContent, FReply (SNamingAuditTab::*OnClicked)());
+
+	FSlateFontInfo RowFont;
+};